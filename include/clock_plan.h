@@ -0,0 +1,80 @@
+/*
+ * PicoCrypt FPV - Clock Plan
+ * clk_sys and system PLL settings giving jitter-free PIO clocks per profile
+ *
+ * A fractional PIO divider dithers between its two neighbouring integer
+ * periods: at 125 MHz the 13.5 MHz pixel clock is 9.26 clk_sys cycles,
+ * so samples last 9 or 10 cycles and the picture jitters by a tenth of a
+ * pixel. clock_plan_solve() searches the RP2040 system PLL (12 MHz
+ * crystal, REFDIV 1, VCO 750-1600 MHz, FBDIV 16-320, POSTDIV 1-7) for
+ * the fastest clk_sys up to a limit at which
+ *   - the output PIO divider (clk_sys / VIDEO_SAMPLE_RATE_HZ per
+ *     VIDEO_PIO_CYCLES_PER_SAMPLE) is an integer,
+ *   - the ADC clock is a whole number of PIO cycles: the capture loop
+ *     (video_capture.h) side-sets the AD9280 clock pin high and low over
+ *     two instructions at an integer divider,
+ * preferring an exact pixel clock over an exact ADC clock. The sync
+ * edge timer runs undivided, so it is jitter-free at any clk_sys; its
+ * tick rate is recorded for the classifier.
+ *
+ * clk_sys 270 MHz (VCO 1080 MHz) is the first clock exact for both the
+ * 13.5 MHz pixel clock and the 10 MHz ADC clock, and the default limit
+ * (SYS_CLK_KHZ). It is an overclock: the plan raises the core voltage
+ * and the firmware boots flash at clk_sys / 4. Portable C11 (host-testable).
+ */
+
+#ifndef PICOCRYPT_CLOCK_PLAN_H
+#define PICOCRYPT_CLOCK_PLAN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#define CLOCK_PLAN_XOSC_KHZ         12000
+#define CLOCK_PLAN_VCO_MIN_KHZ      750000
+#define CLOCK_PLAN_VCO_MAX_KHZ      1600000
+#define CLOCK_PLAN_FBDIV_MIN        16
+#define CLOCK_PLAN_FBDIV_MAX        320
+#define CLOCK_PLAN_POSTDIV_MAX      7
+#define CLOCK_PLAN_ADC_MAX_CYCLES   32      // Two instructions, side-set leaves delay <= 15
+#define CLOCK_PLAN_SYNC_TICK_CYCLES 2       // PIO cycles per sync edge timer tick
+
+_Static_assert((uint64_t)SYS_CLK_KHZ * 1000 >=
+               (uint64_t)VIDEO_SAMPLE_RATE_HZ * VIDEO_PIO_CYCLES_PER_SAMPLE,
+               "clk_sys limit too slow for the sample rate");
+
+// ===== STRUCTURES =====
+typedef struct {
+    uint32_t sys_khz;           // clk_sys
+    uint32_t vco_khz;           // System PLL VCO (REFDIV 1)
+    uint16_t fbdiv;
+    uint8_t postdiv1;           // >= postdiv2
+    uint8_t postdiv2;
+    uint16_t voltage_mv;        // Core voltage for sys_khz
+    uint32_t pixel_div_x256;    // Output PIO divider, 16.8 fixed point
+    uint32_t adc_div_x256;      // ADC clock PIO divider, 16.8 fixed point
+    uint8_t adc_cycles;         // PIO cycles per ADC clock (2..32)
+    bool pixel_exact;           // Integer dividers: no dither
+    bool adc_exact;
+    uint32_t sync_tick_hz;      // Sync edge timer ticks per second
+    uint32_t line_cycles;       // clk_sys cycles per line
+} clock_plan_t;
+
+// ===== FUNCTION PROTOTYPES =====
+
+// Fastest plan at or below max_khz for a pixel clock and an ADC clock in
+// Hz. Returns false (plan untouched) if no PLL setting reaches the pixel
+// clock.
+bool clock_plan_solve(clock_plan_t* plan, uint32_t max_khz, uint32_t pixel_hz, uint32_t adc_hz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_CLOCK_PLAN_H
@@ -0,0 +1,80 @@
+/*
+ * PicoCrypt FPV - CPU Load
+ * Busy/idle cycle accounting for a core that sleeps between events
+ *
+ * The firmware's line loops sleep (WFE) whenever a pass found nothing to
+ * do and wake on the next hardware event (hal_pico.h). Each core brackets
+ * its sleep with cpu_load_sleep() / cpu_load_wake(), passing a free-running
+ * cycle counter of `mask + 1` counts (the RP2040's per-core SysTick: 24
+ * bits of clk_sys). The counter must not wrap between two calls: the
+ * loops pass through at least once per sync pulse, far below 2^24 cycles.
+ *
+ * At every field the core closes the field with cpu_load_field(). Every
+ * CPU_LOAD_WINDOW_FIELDS fields it publishes the window's busy share and
+ * its busiest field, in parts per thousand. Those two words may be read
+ * from any core; everything else belongs to the owning core. Portable
+ * C11 (host-testable).
+ */
+
+#ifndef PICOCRYPT_CPU_LOAD_H
+#define PICOCRYPT_CPU_LOAD_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#ifndef CPU_LOAD_WINDOW_FIELDS
+#define CPU_LOAD_WINDOW_FIELDS  50      // About one second of fields
+#endif
+
+// ===== STRUCTURES =====
+typedef struct {
+    uint32_t mask;              // Counter range - 1 (power of two - 1)
+    uint32_t last;              // Counter at the last transition
+    bool sleeping;
+
+    // This field, then the window so far (cycles; a window at 270 MHz
+    // is well inside 32 bits)
+    uint32_t busy;
+    uint32_t idle;
+    uint32_t window_busy;
+    uint32_t window_total;
+    uint32_t window_peak;       // Busiest field, parts per thousand
+    uint32_t fields;
+    uint32_t wakeups;           // Sleeps ended (statistics)
+
+    // Last complete window, parts per thousand
+    _Atomic uint32_t busy_permille;
+    _Atomic uint32_t peak_permille;
+} cpu_load_t;
+
+// ===== FUNCTION PROTOTYPES =====
+
+// Start accounting as busy at counter value `now`
+void cpu_load_init(cpu_load_t* load, uint32_t mask, uint32_t now);
+
+// Busy until `now`, about to sleep
+void cpu_load_sleep(cpu_load_t* load, uint32_t now);
+
+// Idle until `now`, woken up
+void cpu_load_wake(cpu_load_t* load, uint32_t now);
+
+// Close a field at `now`. Returns true when it completed a window; the
+// window's figures are then published.
+bool cpu_load_field(cpu_load_t* load, uint32_t now);
+
+// Print the last window of each core through `print` (trace_printf on
+// the units; not for the line path)
+void cpu_load_report(const cpu_load_t loads[], uint32_t cores,
+                     bool (*print)(const char* format, ...));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_CPU_LOAD_H
@@ -0,0 +1,152 @@
+/*
+ * PicoCrypt FPV - Crypto Core
+ * Keystream generator and line cipher shared by sender and receiver
+ *
+ * Portable C11 with no Pico SDK dependencies, so the same code runs
+ * on the RP2040 and in the host benchmark/test builds.
+ */
+
+#ifndef PICOCRYPT_CRYPTO_H
+#define PICOCRYPT_CRYPTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+// Keystream backend, selected at build time (CMake CRYPTO_BACKEND).
+// Sender and receiver MUST be built with the same backend and parameters.
+#define CRYPTO_BACKEND_XORSHIFT 0       // Multi-lane Xorshift128+ (hobby grade)
+#define CRYPTO_BACKEND_CHACHA   1       // ChaCha8/12 counter mode, 256-bit key
+
+#ifndef CRYPTO_BACKEND
+#define CRYPTO_BACKEND          CRYPTO_BACKEND_XORSHIFT
+#endif
+
+// Independent Xorshift128+ lanes interleaved word by word
+#ifndef CRYPTO_LANES
+#define CRYPTO_LANES            2
+#endif
+
+#if CRYPTO_LANES != 1 && CRYPTO_LANES != 2 && CRYPTO_LANES != 4
+#error "CRYPTO_LANES must be 1, 2 or 4"
+#endif
+
+// ChaCha rounds (20 is only meant for the RFC 8439 known-answer test)
+#ifndef CHACHA_ROUNDS
+#define CHACHA_ROUNDS           8
+#endif
+
+#if CHACHA_ROUNDS != 8 && CHACHA_ROUNDS != 12 && CHACHA_ROUNDS != 20
+#error "CHACHA_ROUNDS must be 8, 12 or 20"
+#endif
+
+// SplitMix64 constants used to derive per-line lane states and expand keys
+#define CRYPTO_SEED_MIX_0       0xBF58476D1CE4E5B9ULL
+#define CRYPTO_SEED_MIX_1       0x94D049BB133111EBULL
+#define CRYPTO_LANE_STRIDE      0x9E3779B97F4A7C15ULL
+
+#define CRYPTO_KEY_WORDS        8       // 256-bit key
+
+// Keystream generator output per call, applied in little-endian byte order
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_CHACHA
+#define CRYPTO_WORD_BYTES       64      // One ChaCha block
+#else
+#define CRYPTO_WORD_BYTES       8       // One 64-bit Xorshift128+ output
+#endif
+
+// ===== CRYPTOGRAPHY STRUCTURES =====
+typedef struct {
+    uint32_t words[CRYPTO_KEY_WORDS];
+} crypto_key_t;
+
+// The keystream is counter based: every line starts from a state derived
+// from (key, frame, line), so any line is reachable in O(1).
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_CHACHA
+
+typedef struct {
+    uint32_t input[16];                 // Constants, key, block counter, nonce
+    uint32_t sync_counter;              // Frame number of the next line
+    uint32_t line;                      // Line number of the next line
+    uint32_t sample;                    // First sample of the next line call
+} prng_state_t;
+
+// ChaCha block function, CHACHA_ROUNDS rounds (RAM-resident on the RP2040)
+void chacha_block(uint32_t output[16], const uint32_t input[16]);
+
+#else
+
+typedef struct {
+    uint64_t state[CRYPTO_LANES][2];    // Xorshift128+ state per lane
+    uint64_t initial_seed;              // Key, folded; the line states derive from it
+    uint32_t sync_counter;              // Frame number of the next line
+    uint32_t line;                      // Line number of the next line
+    uint32_t sample;                    // First sample of the next line call
+} prng_state_t;
+
+// ===== PRNG =====
+static inline uint64_t xorshift128_plus_lane(uint64_t state[2]) {
+    uint64_t x = state[0];
+    uint64_t const y = state[1];
+    state[0] = y;
+    x ^= x << 23;
+    x ^= x >> 17;
+    x ^= y ^ (y >> 26);
+    state[1] = x;
+    return x + y;
+}
+
+// Single-lane step (lane 0), for self-tests and non-line use
+static inline uint64_t xorshift128_plus(prng_state_t* prng) {
+    return xorshift128_plus_lane(prng->state[0]);
+}
+
+#endif // CRYPTO_BACKEND
+
+// Keystream generator calls needed for one line (PRNG words or ChaCha blocks)
+static inline size_t crypto_words_per_line(size_t length) {
+    return (length + CRYPTO_WORD_BYTES - 1) / CRYPTO_WORD_BYTES;
+}
+
+// ===== FUNCTION PROTOTYPES =====
+
+// Expand a 64-bit pre-shared key to 256 bits (words 0-1 hold the key itself)
+void crypto_key_from_u64(crypto_key_t* key, uint64_t key64);
+
+// Key the generator, positioned at frame 0, line 0. The Xorshift backend
+// folds all CRYPTO_KEY_WORDS into its 64-bit seed.
+void crypto_init_key(prng_state_t* prng, const crypto_key_t* key);
+
+// Same, from a 64-bit pre-shared key
+void crypto_init(prng_state_t* prng, uint64_t key);
+
+// Advance to line 0 of the next frame at V-Sync (sync_counter counts frames)
+void crypto_resync(prng_state_t* prng);
+
+// Position the keystream at any frame/line/sample in O(1). The next line
+// call starts at that sample; following calls start at sample 0.
+void crypto_seek(prng_state_t* prng, uint32_t frame, uint32_t line, uint32_t sample);
+
+// XOR one line with the keystream and advance to the next line.
+// Xorshift: word i of a line comes from lane i % CRYPTO_LANES.
+// ChaCha: block counter = sample / 64, nonce = (frame, line).
+// Buffers may be unaligned and may alias (in-place). Encryption and
+// decryption are the same operation.
+void crypto_xor_line(prng_state_t* prng, const uint8_t* input,
+                     uint8_t* output, size_t length);
+
+// Write the keystream crypto_xor_line would apply to a line of this length
+void crypto_keystream_line(prng_state_t* prng, uint8_t* keystream, size_t length);
+
+// XOR a line with a precomputed keystream (no PRNG work)
+void crypto_xor_buffers(const uint8_t* input, const uint8_t* keystream,
+                        uint8_t* output, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_CRYPTO_H
@@ -0,0 +1,123 @@
+/*
+ * PicoCrypt FPV - Field Descriptor Tables
+ * One field of output video as a list of {count, address} DMA descriptors
+ *
+ * Each field is laid out in half-line slots like the sync train the
+ * classifier expects (sync_pulse.h): five broad pulses, five equalising
+ * pulses, blank lines with H-Sync, the active lines and five equalising
+ * pulses before the next field. Sync, equalising, broad pulses and blank
+ * lines point at constant waveforms built at init. Active lines and the
+ * VBI code lines (vbi_code.h) point at a whole line buffer (sync tip,
+ * burst and picture, as captured), or at a black line until one is
+ * swapped in. A zero descriptor ends the field.
+ *
+ * With SCRAMBLE_ROTATE (scramble.h) each line that can play a buffer has
+ * four descriptors instead: the head (sync tip, burst), the active
+ * picture in two parts and the front porch. A rotated line points the
+ * first part at its cut and the second at the start of the picture; a
+ * plain line points both parts at consecutive samples. The two middle
+ * counts change with the cut, and always add up to the active width.
+ *
+ * Tables start at the first line of their field as the input numbers it
+ * (line 0 at the first line-aligned pulse after V-Sync), so line N of the
+ * table plays input line N. The last descriptor is FRAME_TABLE_SLACK_
+ * SAMPLES short: a table always ends just before the next input field.
+ *
+ * The descriptor layout is what the control DMA channel writes into the
+ * data channel's TRANS_COUNT / READ_ADDR_TRIG alias (video_output.c).
+ * Portable C11 (host-testable).
+ */
+
+#ifndef PICOCRYPT_FRAME_TABLE_H
+#define PICOCRYPT_FRAME_TABLE_H
+
+#include <stdint.h>
+
+#include "scramble.h"
+#include "vbi_code.h"
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#define FRAME_LEVEL_SYNC            4       // Same codes as the capture ADC
+#define FRAME_LEVEL_BLANK           64
+
+#define FRAME_HALF_SAMPLES          (VIDEO_LINE_SAMPLES / 2)
+#define FRAME_FIELD_HALF_LINES      (2 * VIDEO_TOTAL_LINES / VIDEO_FIELDS)
+#define FRAME_TABLE_LINES           (VIDEO_FIELD_LINES + 1)     // Longest field
+// Descriptors of a line that plays a buffer
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+#define FRAME_LINE_DESCS            4       // Head, picture from the cut, picture to it, porch
+#define FRAME_LINE_HEAD_SAMPLES     VIDEO_ACTIVE_START
+#else
+#define FRAME_LINE_DESCS            1
+#define FRAME_LINE_HEAD_SAMPLES     VIDEO_LINE_SAMPLES
+#endif
+// One descriptor per line, a second on lines with a pulse in either half
+// (at most 15 pulses and 2 alignment halves per field), the extra ones of
+// buffer lines, the terminator
+#define FRAME_TABLE_DESCS           (FRAME_TABLE_LINES + 18 + (FRAME_LINE_DESCS - 1) * \
+                                     (VIDEO_FIELD_ACTIVE_LINES + VBI_CODE_LINES))
+#define FRAME_TABLE_SLACK_SAMPLES   (VIDEO_H_SYNC_SAMPLES / 2)
+
+_Static_assert(VIDEO_LINE_SAMPLES % 2 == 0, "Lines must split into two half-line slots");
+
+// ===== TABLE =====
+typedef struct {
+    uint32_t count;             // Samples; 0 ends the field
+    const uint8_t* read_addr;
+} frame_desc_t;
+
+typedef struct {
+    frame_desc_t descs[VIDEO_FIELDS][FRAME_TABLE_DESCS] __attribute__((aligned(8)));
+    uint16_t line_desc[VIDEO_FIELDS][FRAME_TABLE_LINES];   // First descriptor of each line
+    uint16_t lines[VIDEO_FIELDS];                           // Lines per table
+    uint16_t length[VIDEO_FIELDS];                          // Descriptors, terminator excluded
+
+    // Constant waveforms
+    uint8_t broad[FRAME_HALF_SAMPLES];
+    uint8_t equalising[FRAME_HALF_SAMPLES];
+    uint8_t sync_half[FRAME_HALF_SAMPLES];                  // H-Sync, then blanking
+    uint8_t blank_half[FRAME_HALF_SAMPLES];
+    uint8_t black[VIDEO_LINE_SAMPLES];                      // Blank line with H-Sync
+} frame_table_t;
+
+// ===== FUNCTION PROTOTYPES =====
+void frame_table_init(frame_table_t* table);
+
+// Descriptor that plays line `line` of a field from a line buffer, or -1
+// for lines built from constant waveforms
+int frame_table_line_desc(const frame_table_t* table, uint32_t field, uint32_t line);
+
+// Play `line` (VIDEO_LINE_SAMPLES from the H-Sync tip) at a descriptor
+// from frame_table_line_desc(). A single word store: safe while the
+// table is playing. With SCRAMBLE_ROTATE one store per descriptor: safe
+// until the DMA loads the descriptor before the line.
+void frame_table_set_line(frame_table_t* table, uint32_t field, int desc,
+                          const uint8_t* line);
+
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+// Play VIDEO_ACTIVE_SAMPLES of `active` rotated by `cut` (scramble.h)
+// behind the head and front porch of `head`, or of the black line if
+// NULL. Safe until the DMA loads the descriptor before the line.
+void frame_table_set_rotated(frame_table_t* table, uint32_t field, int desc,
+                             const uint8_t* head, const uint8_t* active, uint32_t cut);
+#endif
+
+// Back to black, unless another line was swapped in since. `line` as
+// passed to frame_table_set_line(), or `active` of
+// frame_table_set_rotated().
+void frame_table_clear_line(frame_table_t* table, uint32_t field, int desc,
+                            const uint8_t* line);
+
+// Samples played by a field's table
+uint32_t frame_table_samples(const frame_table_t* table, uint32_t field);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_FRAME_TABLE_H
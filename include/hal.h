@@ -0,0 +1,107 @@
+/*
+ * PicoCrypt FPV - Hardware Abstraction Layer
+ * Video capture, video output and time as seen by the line pipeline
+ *
+ * The sender/receiver pipelines (src/sender.c, src/receiver.c) only touch
+ * hardware through these calls. The RP2040 implementation (hal_pico.c)
+ * drives ADC/PIO/DMA; the host implementation (hal_sim.c) moves lines in
+ * memory so the same pipeline code runs in the Linux simulator.
+ */
+
+#ifndef PICOCRYPT_HAL_H
+#define PICOCRYPT_HAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "scramble.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct hal_video_in hal_video_in_t;     // One line capture channel
+typedef struct hal_video_out hal_video_out_t;   // Gapless line output
+typedef struct hal_line_sum hal_line_sum_t;     // Byte sum of a line in flight
+
+#ifdef __cplusplus
+}
+#endif
+
+// Structure definitions and platform-specific init functions
+#ifdef PICOCRYPT_HOST_BUILD
+#include "hal_sim.h"
+#else
+#include "hal_pico.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== TIME =====
+uint32_t hal_time_us(void);
+
+// Core the caller runs on (0 or 1)
+uint32_t hal_core_num(void);
+
+// ===== VIDEO INPUT =====
+// Capture the next line into the buffer (non-blocking); false if the
+// input is full
+bool hal_video_in_start(hal_video_in_t* in, uint8_t* line, uint32_t length);
+
+// Number of captures finished since the last call, in start order
+uint32_t hal_video_in_poll(hal_video_in_t* in);
+
+// ===== VIDEO OUTPUT =====
+// The next submitted line is the first line of a new field
+void hal_video_out_field(hal_video_out_t* out);
+
+// Queue a line behind the one playing; false if the output is full
+bool hal_video_out_submit(hal_video_out_t* out, const uint8_t* line, uint32_t length);
+
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+// Queue a whole line whose picture (`active`, VIDEO_ACTIVE_SAMPLES) plays
+// rotated by `cut` (scramble.h) between the head and front porch of
+// `head`, or regenerated blanking if `head` is NULL
+bool hal_video_out_submit_rotated(hal_video_out_t* out, const uint8_t* head,
+                                  const uint8_t* active, uint32_t cut);
+#endif
+
+// Number of lines finished since the last call, in submission order
+uint32_t hal_video_out_poll(hal_video_out_t* out);
+
+// ===== LINE SUM =====
+// Start summing `length` bytes (non-blocking); they must not change until
+// the sum is collected
+void hal_line_sum_start(hal_line_sum_t* sum, const uint8_t* data, uint32_t length);
+
+// Wait for the sum started last and return it
+uint32_t hal_line_sum_finish(hal_line_sum_t* sum);
+
+// ===== KEY STORE =====
+// Bytes of the reserved sector holding the key slot image (key_slots.h)
+#define HAL_KEY_STORE_BYTES     4096
+
+// The stored image, HAL_KEY_STORE_BYTES (all 0xFF while blank)
+const uint8_t* hal_key_store_read(void);
+
+// Replace the stored image (`length` a multiple of 256, at most
+// HAL_KEY_STORE_BYTES). On the RP2040 both cores stall for the sector
+// erase, tens of milliseconds: video breaks up for a few fields. Call
+// from core 1 only. False if the image did not read back.
+bool hal_key_store_write(const uint8_t* image, uint32_t length);
+
+// ===== DEBUG CHANNEL =====
+// Bytes the debug channel (USB CDC) accepts right now without blocking;
+// 0 while no host is attached
+uint32_t hal_debug_room(void);
+
+// Write at most hal_debug_room() bytes
+void hal_debug_write(const uint8_t* data, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_HAL_H
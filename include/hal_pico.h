@@ -0,0 +1,115 @@
+/*
+ * PicoCrypt FPV - RP2040 HAL
+ * PIO/DMA line capture and descriptor-chained PIO output behind the HAL
+ * calls
+ *
+ * Also the sync edge timer (firmware only): a PIO state machine stamps
+ * every sync edge with a down-counter, DMA moves the stamps into a ring
+ * and hal_sync_in_read() hands them to the classifier (sync_pulse.h).
+ *
+ * And the clocks: hal_clock_apply() switches clk_sys to a clock plan
+ * (clock_plan.h); the capture engine clocks the AD9280 at the plan's ADC
+ * divider.
+ *
+ * And the wake events of the line loops, which sleep (WFE) whenever a
+ * pass finds nothing to do: the end of every sync pulse, every finished
+ * line capture (DMA_IRQ_0) and every finished output descriptor
+ * (DMA_IRQ_1), each on the core that enables it, plus the other core's
+ * doorbell (SEV). The handlers only acknowledge. Any interrupt taken
+ * since the last sleep makes the next one return at once, so work that
+ * arrives while a pass runs is never slept through.
+ *
+ * And the line sum: a DMA channel reads a line into a dummy word with the
+ * sniffer in sum mode, so the pipeline gets each line's byte sum
+ * (line_check.h) without the CPU reading it. The RP2040 has one sniffer;
+ * this is its only user.
+ */
+
+#ifndef PICOCRYPT_HAL_PICO_H
+#define PICOCRYPT_HAL_PICO_H
+
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "hardware/structs/systick.h"
+
+#include "clock_plan.h"
+#include "cpu_load.h"
+#include "video_capture.h"
+#include "video_output.h"
+
+// ===== CONFIGURATION =====
+#define HAL_SYNC_RING_WORDS     128     // Edge stamps (power of two)
+#define HAL_SYNC_TICK_CYCLES    CLOCK_PLAN_SYNC_TICK_CYCLES     // PIO cycles per timer tick
+#define HAL_CYCLES_MASK         0x00FFFFFFu     // SysTick: 24 bits of clk_sys
+
+// ===== STRUCTURES =====
+struct hal_video_in {
+    video_capture_t engine;         // AD9280 lines via PIO and chained DMA
+};
+
+struct hal_video_out {
+    video_output_t engine;          // Field descriptor chain into the PIO
+};
+
+struct hal_line_sum {
+    uint dma_chan;                  // Memory to `sink`, sniffed
+    uint32_t sink;
+};
+
+typedef struct {
+    uint32_t ring[HAL_SYNC_RING_WORDS] __attribute__((aligned(HAL_SYNC_RING_WORDS * 4)));
+    PIO pio;
+    uint sm;
+    uint dma_chan;
+    uint32_t read;                  // Words consumed
+    uint32_t lost;                  // Words overwritten before they were read
+} hal_sync_in_t;
+
+// ===== INITIALIZATION =====
+// AD9280 on the given pins, clocked per the plan; `length` samples per line
+void hal_video_in_init(hal_video_in_t* in, PIO pio, uint sm, uint data_pin, uint clock_pin,
+                       uint sync_pin, const clock_plan_t* plan, uint32_t length);
+// R-2R DAC on data_pin..data_pin + 7, at the plan's pixel clock
+void hal_video_out_init(hal_video_out_t* out, PIO pio, uint sm, uint data_pin,
+                        const clock_plan_t* plan);
+
+// Claim a DMA channel and the sniffer (one line sum per unit)
+void hal_line_sum_init(hal_line_sum_t* sum);
+
+// ===== CLOCKS =====
+// Core voltage, then clk_sys and clk_peri from the system PLL. Call first
+// in main(), before stdio and anything that caches clk_sys.
+void hal_clock_apply(const clock_plan_t* plan);
+
+// ===== SYNC EDGE TIMER =====
+// Time every edge on `pin` (composite sync, active low)
+void hal_sync_in_init(hal_sync_in_t* in, PIO pio, uint sm, uint pin);
+
+// Timer ticks per second at the current clk_sys
+uint32_t hal_sync_in_tick_hz(const hal_sync_in_t* in);
+
+// Copy up to `max` new edge stamps, oldest first; returns the count
+uint32_t hal_sync_in_read(hal_sync_in_t* in, uint32_t* words, uint32_t max);
+
+// ===== WAKE EVENTS =====
+// Start the calling core's cycle counter (its SysTick, no interrupt)
+void hal_cycles_init(void);
+
+// clk_sys cycles of the calling core, counting up, HAL_CYCLES_MASK wide
+static inline uint32_t hal_cycles(void) {
+    return HAL_CYCLES_MASK - systick_hw->cvr;
+}
+
+// Wake the calling core at the end of every sync pulse
+void hal_sync_in_wake(hal_sync_in_t* in);
+
+// Wake the calling core when a line capture finishes
+void hal_video_in_wake(hal_video_in_t* in);
+
+// Wake the calling core when an output descriptor finishes playing
+void hal_video_out_wake(hal_video_out_t* out);
+
+// Sleep until the next wake event, accounted as idle in `load`
+void hal_idle(cpu_load_t* load);
+
+#endif // PICOCRYPT_HAL_PICO_H
@@ -0,0 +1,65 @@
+/*
+ * PicoCrypt FPV - Simulator HAL (host)
+ * Capture reads from a caller-provided line, output hands lines to a sink
+ *
+ * Transfers complete instantly: a capture is finished as soon as it
+ * starts and a submitted line is delivered to the sink on submission.
+ * Time is simulated and advanced by the caller.
+ */
+
+#ifndef PICOCRYPT_HAL_SIM_H
+#define PICOCRYPT_HAL_SIM_H
+
+#include <stdint.h>
+
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Receives every output line (e.g. the link to the receiver, a frame store)
+typedef void (*hal_sim_sink_t)(void* context, const uint8_t* line, uint32_t length);
+
+// ===== STRUCTURES =====
+struct hal_video_in {
+    const uint8_t* source;          // Samples of the line being "digitised"
+    uint32_t finished;              // Captured, not yet polled
+    uint32_t captures;
+};
+
+struct hal_video_out {
+    hal_sim_sink_t sink;
+    void* context;
+    uint32_t finished;              // Delivered, not yet polled
+    uint32_t lines;
+    uint32_t fields;
+    uint8_t played[VIDEO_LINE_SAMPLES];     // Rotated line as played
+};
+
+struct hal_line_sum {
+    uint32_t value;                 // Summed at start
+    uint32_t sums;
+};
+
+// ===== SIMULATION CONTROL =====
+void hal_sim_video_in_init(hal_video_in_t* in);
+void hal_sim_video_out_init(hal_video_out_t* out, hal_sim_sink_t sink, void* context);
+void hal_sim_line_sum_init(hal_line_sum_t* sum);
+
+// Point the input at the samples of the next line
+static inline void hal_sim_video_in_set_source(hal_video_in_t* in, const uint8_t* source) {
+    in->source = source;
+}
+
+void hal_sim_set_time_us(uint32_t now_us);
+
+// Receives debug channel bytes (e.g. the trace stream); none by default,
+// so the debug channel reports no room
+void hal_sim_set_debug_sink(hal_sim_sink_t sink, void* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_HAL_SIM_H
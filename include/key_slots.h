@@ -0,0 +1,83 @@
+/*
+ * PicoCrypt FPV - Key Slots
+ * Keys held in a reserved flash sector, loaded into RAM at boot
+ *
+ * KEY_SLOTS 256-bit keys and the slot to boot with, stored as one image
+ * of KEY_SLOTS_IMAGE_BYTES (a flash page) behind a magic word and a
+ * CRC-32. A blank or damaged image boots with the build-time
+ * PRESHARED_KEY in slot 0, so a fresh pair of units still talk. Slots
+ * are set in RAM over USB (key_slots_parse_command) and written back
+ * with one erase/program of the sector (hal_key_store_write). Keys are
+ * never printed. A 64-bit key (PRESHARED_KEY, or 16 hex digits over
+ * USB) is expanded to 256 bits but keeps only 64 bits of entropy.
+ * Portable C11 (host-testable).
+ */
+
+#ifndef PICOCRYPT_KEY_SLOTS_H
+#define PICOCRYPT_KEY_SLOTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#define KEY_SLOTS               4
+#define KEY_SLOTS_MAGIC         0x594B4350u     // "PCKY"
+#define KEY_SLOTS_VERSION       1
+#define KEY_SLOTS_IMAGE_BYTES   256             // One flash page
+
+// USB command line, longest: "s 3 " + 64 hex digits
+#define KEY_COMMAND_MAX         80
+
+// ===== KEY SLOT STRUCTURES =====
+typedef struct {
+    crypto_key_t keys[KEY_SLOTS];
+    uint32_t valid;                     // Bit per slot holding a key
+    uint32_t boot_slot;                 // Key the units start with (last rekey)
+} key_slots_t;
+
+typedef enum {
+    KEY_COMMAND_NONE,                   // Empty line
+    KEY_COMMAND_ERROR,                  // Not a valid command
+    KEY_COMMAND_SET,                    // "s <slot> <key>": set a slot in RAM
+    KEY_COMMAND_REKEY,                  // "k <slot> <frame>": switch at a frame
+    KEY_COMMAND_WRITE,                  // "w": write the slots to flash
+} key_command_type_t;
+
+typedef struct {
+    key_command_type_t type;
+    uint32_t slot;
+    uint32_t frame;
+    crypto_key_t key;
+} key_command_t;
+
+// ===== FUNCTION PROTOTYPES =====
+
+// Load the slots from a stored image. Returns false (and keeps only
+// `fallback`, in slot 0) if the image is blank or fails its checks.
+bool key_slots_load(key_slots_t* slots, const uint8_t* image, const crypto_key_t* fallback);
+
+// Build the image to store; unused bytes read as erased flash (0xFF)
+void key_slots_save(const key_slots_t* slots, uint8_t image[KEY_SLOTS_IMAGE_BYTES]);
+
+// Returns false if the slot is out of range
+bool key_slots_set(key_slots_t* slots, uint32_t slot, const crypto_key_t* key);
+
+// NULL if the slot is out of range or empty
+const crypto_key_t* key_slots_get(const key_slots_t* slots, uint32_t slot);
+
+// Parse one command line (no line ending). Keys are 16 hex digits (a
+// 64-bit key, expanded like PRESHARED_KEY) or 64 (32 key bytes in order);
+// slots and frames are decimal.
+key_command_type_t key_slots_parse_command(const char* line, key_command_t* command);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_KEY_SLOTS_H
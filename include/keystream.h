@@ -0,0 +1,84 @@
+/*
+ * PicoCrypt FPV - Keystream Prefetch Ring
+ * Per-line keystream buffers filled during H/V blanking
+ *
+ * The PRNG runs outside the active-video window: the line loop calls
+ * keystream_prefetch() in blanking and the hot path is a plain XOR of
+ * the captured line with the oldest buffered keystream line. A ring can
+ * also hold a few keystream bytes per line past the ones XORed, for data
+ * keyed to the line (the line check's mask, line_check.h).
+ * Producer and consumer run on the same core.
+ */
+
+#ifndef PICOCRYPT_KEYSTREAM_H
+#define PICOCRYPT_KEYSTREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crypto.h"
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#ifndef KEYSTREAM_RING_LINES
+#define KEYSTREAM_RING_LINES    4       // Must be a power of two
+#endif
+
+#ifndef KEYSTREAM_MAX_WIDTH
+#define KEYSTREAM_MAX_WIDTH     VIDEO_ACTIVE_SAMPLES    // Samples per line
+#endif
+
+#define KEYSTREAM_MAX_EXTRA     4       // Bytes per line past the XORed ones
+
+#if (KEYSTREAM_RING_LINES & (KEYSTREAM_RING_LINES - 1)) != 0
+#error "KEYSTREAM_RING_LINES must be a power of two"
+#endif
+
+// ===== RING STRUCTURE =====
+typedef struct {
+    uint8_t lines[KEYSTREAM_RING_LINES][KEYSTREAM_MAX_WIDTH + KEYSTREAM_MAX_EXTRA]
+        __attribute__((aligned(4)));
+    size_t length;      // Bytes of keystream XORed per line
+    size_t extra;       // Bytes of keystream after those, per line
+    uint32_t head;      // Lines produced
+    uint32_t tail;      // Lines consumed
+} keystream_ring_t;
+
+// ===== FUNCTION PROTOTYPES =====
+
+// Set the line length (<= KEYSTREAM_MAX_WIDTH) and the extra bytes
+// (<= KEYSTREAM_MAX_EXTRA) after it, and empty the ring
+void keystream_ring_init(keystream_ring_t* ring, size_t length, size_t extra);
+
+// Drop all buffered lines (call after rewinding the PRNG at V-Sync)
+void keystream_ring_reset(keystream_ring_t* ring);
+
+static inline uint32_t keystream_ring_count(const keystream_ring_t* ring) {
+    return ring->head - ring->tail;
+}
+
+// Generate up to max_lines lines into free slots. Returns lines generated.
+uint32_t keystream_prefetch(keystream_ring_t* ring, prng_state_t* prng,
+                            uint32_t max_lines);
+
+// Hot path: XOR one line with the oldest buffered keystream and copy its
+// extra bytes to `extra` (if not NULL). Returns false (output untouched)
+// if the ring is empty or length differs.
+bool keystream_xor_line(keystream_ring_t* ring, const uint8_t* input,
+                        uint8_t* output, size_t length, uint8_t* extra);
+
+// Ring underrun fallback: the same from the generator's next line,
+// generated inline (the ring's extra bytes of that line included)
+void keystream_xor_inline(keystream_ring_t* ring, prng_state_t* prng, const uint8_t* input,
+                          uint8_t* output, size_t length, uint8_t* extra);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_KEYSTREAM_H
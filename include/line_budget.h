@@ -0,0 +1,47 @@
+/*
+ * PicoCrypt FPV - Per-Line CPU Budget
+ * Compile-time check that one line's crypto work fits in its line period
+ *
+ * Per active line the crypto core generates one line of keystream (in
+ * blanking) and XORs it onto the samples. Both run on the same core, so
+ * together they must fit in LINE_CPU_BUDGET_PERCENT of a line at clk_sys.
+ * The check is at SYS_CLK_KHZ, the clock plan's limit (clock_plan.h); a
+ * plan that settles below it traces its own budget at boot.
+ * The cycle figures are conservative Cortex-M0+ estimates; replace them
+ * with perf_monitor measurements (-DCRYPTO_KEYSTREAM_CYCLES_PER_64B=...).
+ */
+
+#ifndef PICOCRYPT_LINE_BUDGET_H
+#define PICOCRYPT_LINE_BUDGET_H
+
+#include "crypto.h"
+#include "video_profile.h"
+
+// ===== CYCLE ESTIMATES (per 64 bytes) =====
+#ifndef CRYPTO_KEYSTREAM_CYCLES_PER_64B
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_CHACHA
+#define CRYPTO_KEYSTREAM_CYCLES_PER_64B     (260 + 80 * CHACHA_ROUNDS)
+#else
+#define CRYPTO_KEYSTREAM_CYCLES_PER_64B     256
+#endif
+#endif
+
+#ifndef CRYPTO_XOR_CYCLES_PER_64B
+#define CRYPTO_XOR_CYCLES_PER_64B           80
+#endif
+
+#ifndef LINE_CPU_BUDGET_PERCENT
+#define LINE_CPU_BUDGET_PERCENT             75      // Rest: sync, DMA, queue
+#endif
+
+// ===== BUDGET =====
+#define LINE_PERIOD_CYCLES      ((uint32_t)((uint64_t)SYS_CLK_KHZ * VIDEO_LINE_PERIOD_NS / 1000000))
+#define LINE_BUDGET_CYCLES      (LINE_PERIOD_CYCLES * LINE_CPU_BUDGET_PERCENT / 100)
+#define LINE_CRYPTO_CYCLES      ((uint32_t)(((uint64_t)VIDEO_ACTIVE_SAMPLES * \
+                                 (CRYPTO_KEYSTREAM_CYCLES_PER_64B + CRYPTO_XOR_CYCLES_PER_64B) + 63) / 64))
+
+_Static_assert(LINE_CRYPTO_CYCLES <= LINE_BUDGET_CYCLES,
+               "Per-line crypto exceeds the line budget: raise SYS_CLK_KHZ, "
+               "use a lighter backend or the FPV_LOWRES profile");
+
+#endif // PICOCRYPT_LINE_BUDGET_H
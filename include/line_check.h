@@ -0,0 +1,119 @@
+/*
+ * PicoCrypt FPV - Line Check
+ * Plaintext sum of each active line, sent masked in its sync tip
+ *
+ * Neither unit could tell whether a line decrypted correctly. The sender
+ * sums the active picture before encrypting it and writes the top
+ * LINE_CHECK_BITS of the sum into the line's own sync tip, after the
+ * pilot's search window, as pilot-level chips (below the sync slicing
+ * level, so still a plain sync pulse). The receiver sums the picture it
+ * decrypted and compares. Both sums come from the DMA sniffer
+ * (hal_line_sum_*), so the CPU never touches the bytes.
+ *
+ * In clear the check would give away every line's mean brightness. It
+ * is XORed with LINE_CHECK_KEY_BYTES of the line's own keystream, taken
+ * after the bytes that encrypt (or rotate) the picture, so the chips
+ * read as random bits to anyone without the key. The receiver removes
+ * the mask before comparing: a misread chip is still one bit error, and
+ * a line decrypted with the wrong keystream still reads a random check.
+ *
+ * A CRC would fail on every line of an analog link: the receiver's ADC
+ * never reads back exactly what the sender's DAC wrote. A byte sum moves
+ * only by the noise, but on an XOR link that noise hits the ciphertext
+ * before decryption, and carries amplify it. A ciphertext sample off by
+ * m codes flips the decrypted bits of its carry chain, each towards its
+ * complement: the sample moves by m * (8 - 2 * popcount) codes on
+ * average (up to 8 * m for black or white) plus a random part of about
+ * 170 * m codes^2 of variance. At 2 codes rms on the link that is up to
+ * 9000 codes of offset and 440 rms on a full-resolution sum; no fixed
+ * tolerance fits both a quiet and a noisy link. The receiver measures
+ * the link noise on the pilot's one chips, which no keystream touches
+ * (line_check_noise), and accepts the worst offset that noise can give
+ * plus LINE_CHECK_SIGMAS standard deviations (line_check_tolerance).
+ * Noise alone then fails next to no line; a misread chip fails one
+ * whatever the sum (about one line in 40 at 5 codes rms, one in 8 at 8),
+ * so only a run of LINE_CHECK_RESYNC_LINES is taken as a sync error.
+ * A line decrypted with the wrong keystream sums as uniform bytes,
+ * N * 127.5 +- 2000 on a full line: it fails unless its picture averages
+ * within the tolerance of mid-grey. On a quiet link that is a few codes,
+ * so a slip shows within a run; the noisier the link, the more slipped
+ * lines pass, break the run and leave the slip to the next V-Sync.
+ * Cut-and-rotate keeps the sum and adds the noise unamplified.
+ * FPV_LOWRES's short sync tip only has room for 5 bits and catches
+ * little more than a dead picture.
+ * Portable C11 (host-testable).
+ */
+
+#ifndef PICOCRYPT_LINE_CHECK_H
+#define PICOCRYPT_LINE_CHECK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "pilot.h"
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+// After the pilot and its search window, clear of the rising edge
+#define LINE_CHECK_START        (PILOT_START + PILOT_CHIPS + PILOT_SEARCH)
+#define LINE_CHECK_ROOM         (VIDEO_H_SYNC_SAMPLES - 1 - LINE_CHECK_START)
+#define LINE_CHECK_BITS         (LINE_CHECK_ROOM < 16 ? LINE_CHECK_ROOM : 16)
+
+// Bits of a whole-picture sum, and the low ones dropped
+#define LINE_CHECK_SUM_BITS     ((uint32_t)VIDEO_ACTIVE_SAMPLES * 255 < (1u << 17) ? 17 : 18)
+#define LINE_CHECK_SHIFT        (LINE_CHECK_SUM_BITS - LINE_CHECK_BITS)
+#define LINE_CHECK_MASK         ((1u << LINE_CHECK_BITS) - 1)
+#define LINE_CHECK_KEY_BYTES    2       // Keystream per line masking the check
+
+#ifndef LINE_CHECK_TOLERANCE
+#define LINE_CHECK_TOLERANCE    64      // Sum difference accepted on a quiet link
+#endif
+#define LINE_CHECK_SIGMAS       5       // Noise deviations accepted on top
+
+// Link noise as the mean absolute deviation of the pilot's one chips,
+// in 1/16 codes (about 0.8 of the rms)
+#define LINE_CHECK_NOISE_ONE    16
+
+// Consecutive failed lines that count as a sync error. Misread chips
+// alone make such a run about once in 10^13 lines at 5 codes rms of link
+// noise, and once in 10^7 (ten minutes) at 8.
+#define LINE_CHECK_RESYNC_LINES 8
+
+_Static_assert(LINE_CHECK_ROOM >= 4, "Sync tip too short for a line check");
+_Static_assert(LINE_CHECK_BITS <= 8 * LINE_CHECK_KEY_BYTES, "Check wider than its mask");
+_Static_assert((uint32_t)VIDEO_ACTIVE_SAMPLES * 255 < (1u << 18), "Line sum wider than 18 bits");
+
+// ===== FUNCTION PROTOTYPES =====
+
+// Mask of a line's check from LINE_CHECK_KEY_BYTES of its keystream
+uint32_t line_check_mask(const uint8_t* key);
+
+// Sender: write the check of the picture's byte sum, XORed with `mask`,
+// into a line's sync tip
+void line_check_write(uint8_t* line, uint32_t sum, uint32_t mask);
+
+// Receiver: the (still masked) check in a line's sync tip, its content
+// at `offset` samples (pilot_find())
+uint32_t line_check_read(const uint8_t* line, int32_t offset);
+
+// Receiver: link noise on a line's pilot, its content at `offset`
+// samples, in 1/LINE_CHECK_NOISE_ONE codes
+uint32_t line_check_noise(const uint8_t* line, int32_t offset);
+
+// Receiver: sum difference accepted at a link noise of `noise`
+// (line_check_noise() units)
+uint32_t line_check_tolerance(uint32_t noise);
+
+// Receiver: true if the byte sum of the received picture is within
+// `tolerance` of a check
+bool line_check_match(uint32_t check, uint32_t sum, uint32_t tolerance);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_LINE_CHECK_H
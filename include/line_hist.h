@@ -0,0 +1,75 @@
+/*
+ * PicoCrypt FPV - Latency Histogram
+ * Fixed-bucket, lock-free latency histogram for per-line instrumentation
+ *
+ * Buckets are 1 us wide below LINE_HIST_LINEAR_US, then 8 per power of
+ * two (12.5% resolution) up to the full 32-bit range, so percentiles are
+ * exact within a line period and bounded above it. Each histogram has a
+ * single writer (the core that owns the stage); it records with plain
+ * relaxed load/store (the M0+ has no atomic read-modify-write) and any
+ * core may snapshot it concurrently. Portable C11 (host-buildable).
+ */
+
+#ifndef PICOCRYPT_LINE_HIST_H
+#define PICOCRYPT_LINE_HIST_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#define LINE_HIST_LINEAR_US     64      // 1 us buckets below this (power of two)
+#define LINE_HIST_SUB_BUCKETS   8       // Per power of two above it
+#define LINE_HIST_LINEAR_BITS   6       // log2(LINE_HIST_LINEAR_US)
+#define LINE_HIST_SUB_BITS      3       // log2(LINE_HIST_SUB_BUCKETS)
+#define LINE_HIST_BUCKETS       (LINE_HIST_LINEAR_US + \
+                                 (32 - LINE_HIST_LINEAR_BITS) * LINE_HIST_SUB_BUCKETS)
+
+// Percentiles in parts per 10000
+#define LINE_HIST_P50           5000
+#define LINE_HIST_P99           9900
+#define LINE_HIST_P999          9990
+
+// ===== STRUCTURES =====
+typedef struct {
+    _Atomic uint32_t bucket[LINE_HIST_BUCKETS];
+    _Atomic uint32_t max_us;
+} line_hist_t;
+
+// Plain copy taken by the reader
+typedef struct {
+    uint32_t bucket[LINE_HIST_BUCKETS];
+    uint32_t count;
+    uint32_t max_us;
+} line_hist_snapshot_t;
+
+// ===== FUNCTION PROTOTYPES =====
+void line_hist_init(line_hist_t* hist);
+
+// Writer side (single core per histogram)
+void line_hist_record(line_hist_t* hist, uint32_t value_us);
+
+// Reader side (any core)
+void line_hist_snapshot(const line_hist_t* hist, line_hist_snapshot_t* snap);
+
+// Samples recorded between two snapshots of the same histogram. The max
+// is the upper bound of the highest bucket hit in the interval, clamped
+// to the cumulative max.
+void line_hist_delta(const line_hist_snapshot_t* now, const line_hist_snapshot_t* prev,
+                     line_hist_snapshot_t* delta);
+
+// Upper bound of the bucket holding the given percentile (0 if empty)
+uint32_t line_hist_percentile(const line_hist_snapshot_t* snap, uint32_t per_10000);
+
+// Bucket index and its inclusive upper bound
+uint32_t line_hist_bucket(uint32_t value_us);
+uint32_t line_hist_bucket_upper(uint32_t bucket);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_LINE_HIST_H
@@ -0,0 +1,71 @@
+/*
+ * PicoCrypt FPV - Line Segment Map
+ * Which samples of which lines are encrypted
+ *
+ * Lines are captured and output whole, from the H-Sync tip. Only the
+ * active picture is encrypted; the sync tip, back porch (colour burst),
+ * front porch and every VBI line pass through untouched, so the
+ * receiver and any monitor on the link can still lock to them and no
+ * keystream or CPU time is spent on them. Derived from the horizontal
+ * and vertical timing of the video profile.
+ *
+ * The firmware's output regenerates the VBI and sync pulses from
+ * constant waveforms (frame_table.h).
+ *
+ * Lines are numbered from the V-Sync of their field: the first
+ * VIDEO_VBI_LINES are blanking, the rest active. Keystream lines count
+ * active lines only.
+ */
+
+#ifndef PICOCRYPT_LINE_MAP_H
+#define PICOCRYPT_LINE_MAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== SEGMENTS =====
+typedef enum {
+    LINE_SEG_SYNC = 0,          // H-Sync tip
+    LINE_SEG_BACK_PORCH,        // Includes the colour burst
+    LINE_SEG_ACTIVE,            // Encrypted on active lines
+    LINE_SEG_FRONT_PORCH,
+    LINE_SEG_COUNT
+} line_seg_t;
+
+typedef struct {
+    uint16_t start;             // First sample from the H-Sync tip
+    uint16_t length;
+} line_span_t;
+
+extern const line_span_t line_segments[LINE_SEG_COUNT];
+
+// ===== PER FRAME ACCOUNTING =====
+// Keystream bytes per frame: active region only vs every sample of every line
+#define LINE_MAP_FRAME_CRYPTO_BYTES ((uint32_t)VIDEO_ACTIVE_LINES * VIDEO_ACTIVE_SAMPLES)
+#define LINE_MAP_FRAME_LINE_BYTES   ((uint32_t)VIDEO_TOTAL_LINES * VIDEO_LINE_SAMPLES)
+
+// ===== LOOKUP =====
+static inline bool line_map_is_active(uint32_t field_line) {
+    return field_line >= VIDEO_VBI_LINES && field_line < VIDEO_FIELD_LINES;
+}
+
+// Keystream line of an active line
+static inline uint32_t line_map_active_index(uint32_t field_line) {
+    return field_line >= VIDEO_VBI_LINES ? field_line - VIDEO_VBI_LINES : 0;
+}
+
+// Encrypted span of a line captured with `length` samples; length 0 for
+// lines that pass through
+line_span_t line_map_crypto_span(uint32_t field_line, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_LINE_MAP_H
@@ -0,0 +1,138 @@
+/*
+ * PicoCrypt FPV - Line Buffer Pool
+ * N-deep pipeline of line buffers shared by capture, crypto and output
+ *
+ * Every slot moves through the stages in order:
+ *   CAPTURE (armed) -> CAPTURED -> CRYPTO (in place) -> OUTPUT
+ *   (DMA started) -> DONE (slot free again)
+ * Each stage keeps one cursor and is advanced by exactly one core, so
+ * capture of line N+1, crypto of line N and output of line N-1 proceed
+ * concurrently without locks. Portable C11 (host-buildable).
+ *
+ * Timed advances stamp the slot at every stage and feed one latency
+ * histogram per stage transition, written only by the core that owns
+ * the stage; any core can snapshot them for a report.
+ *
+ * With SRAM_PLACEMENT_BANKED each slot sits in its own SRAM bank
+ * (include/sram_map.h); the pool must then live in striped SRAM.
+ */
+
+#ifndef PICOCRYPT_LINE_POOL_H
+#define PICOCRYPT_LINE_POOL_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "line_hist.h"
+#include "sram_map.h"
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#ifndef LINE_POOL_DEPTH
+#define LINE_POOL_DEPTH         5       // Buffers in flight (>= 2)
+#endif
+
+#ifndef LINE_POOL_MAX_WIDTH
+// Whole line from the sync tip, plus the resampler's edge padding
+// (RESAMPLE_BUFFER_SAMPLES, resample.h)
+#define LINE_POOL_MAX_WIDTH     (VIDEO_LINE_SAMPLES + 3)
+#endif
+
+// Samples free before and after each line: a line played realigned by
+// up to this many samples (the receiver's pilot offset, pilot.h) still
+// plays from its own buffer
+#define LINE_POOL_SLACK         4
+
+// Lines start this far into their buffer so the active picture is
+// word-aligned for the XOR
+#define LINE_POOL_OFFSET        (LINE_POOL_SLACK + (4 - (LINE_POOL_SLACK + VIDEO_ACTIVE_START) % 4) % 4)
+#define LINE_POOL_STRIDE        ((LINE_POOL_OFFSET + LINE_POOL_MAX_WIDTH + LINE_POOL_SLACK + 3) & ~3)
+
+#if LINE_POOL_DEPTH < 2
+#error "LINE_POOL_DEPTH must be at least 2"
+#endif
+
+// Banked: rows of SRAM_BANKS word-interleaved slots, slot k in column k % 4
+#define LINE_POOL_ROWS          ((LINE_POOL_DEPTH + SRAM_BANKS - 1) / SRAM_BANKS)
+
+typedef enum {
+    LINE_STAGE_CAPTURE = 0,     // Free slot claimed, capture armed
+    LINE_STAGE_CAPTURED,        // Capture DMA finished
+    LINE_STAGE_CRYPTO,          // Encrypted/decrypted in place
+    LINE_STAGE_OUTPUT,          // Output DMA started
+    LINE_STAGE_DONE,            // Output DMA finished, slot free
+    LINE_STAGE_COUNT
+} line_stage_t;
+
+// Latency histograms, one per stage transition (recorded by the core
+// advancing the later stage)
+typedef enum {
+    LINE_LAT_CAPTURE = 0,       // Capture start -> capture done
+    LINE_LAT_CRYPTO,            // Capture done -> crypto done
+    LINE_LAT_SUBMIT,            // Crypto done -> output start
+    LINE_LAT_OUTPUT,            // Output start -> output done
+    LINE_LAT_TOTAL,             // Capture start -> output done
+    LINE_LAT_GLASS,             // Capture done -> output done: this unit's glass-to-glass
+    LINE_LAT_COUNT
+} line_lat_t;
+
+// ===== POOL STRUCTURE =====
+typedef struct {
+#if SRAM_BANKED
+    uint32_t banked[LINE_POOL_ROWS][LINE_POOL_STRIDE / 4][SRAM_BANKS] __attribute__((aligned(16)));
+#else
+    uint8_t buffers[LINE_POOL_DEPTH][LINE_POOL_STRIDE] __attribute__((aligned(4)));
+#endif
+    uint32_t stamp_us[LINE_POOL_DEPTH][LINE_STAGE_COUNT];  // Time each stage was reached
+    _Atomic uint32_t cursor[LINE_STAGE_COUNT];      // Lines through each stage
+    uint32_t overruns;                              // Lines not captured (no slot or HAL full)
+    line_hist_t latency[LINE_LAT_COUNT];
+} line_pool_t;
+
+// ===== FUNCTION PROTOTYPES =====
+void line_pool_init(line_pool_t* pool);
+
+// Slot the stage would process next, or -1 if the previous stage (or, for
+// CAPTURE, a free slot) is not available yet
+int line_pool_peek(line_pool_t* pool, line_stage_t stage);
+
+// Mark the slot returned by line_pool_peek() as through the stage
+void line_pool_advance(line_pool_t* pool, line_stage_t stage);
+
+// Same, stamping the slot and recording the time since the previous stage
+void line_pool_advance_at(line_pool_t* pool, line_stage_t stage, uint32_t now_us);
+
+// DONE with output and end-to-end latency accounting
+void line_pool_retire(line_pool_t* pool, uint32_t now_us);
+
+static inline uint8_t* line_pool_buffer(line_pool_t* pool, int slot) {
+#if SRAM_BANKED
+    uint8_t* base = sram_bank_view(pool->banked[slot / SRAM_BANKS], slot % SRAM_BANKS);
+#else
+    uint8_t* base = pool->buffers[slot];
+#endif
+    return base + LINE_POOL_OFFSET;
+}
+
+static inline uint32_t line_pool_capture_time(const line_pool_t* pool, int slot) {
+    return pool->stamp_us[slot][LINE_STAGE_CAPTURE];
+}
+
+// Print count/p50/p99/p99.9/max per stage since the previous report
+// through `print` (trace_printf on the units: never blocks). `since`
+// holds the previous snapshots and is updated; `cores` names the core
+// recording each LINE_LAT_* histogram.
+void line_pool_report(const line_pool_t* pool, line_hist_snapshot_t since[LINE_LAT_COUNT],
+                      const uint8_t cores[LINE_LAT_COUNT],
+                      bool (*print)(const char* format, ...));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_LINE_POOL_H
@@ -0,0 +1,86 @@
+/*
+ * PicoCrypt FPV - Line Descriptor Queue
+ * Lock-free single-producer/single-consumer ring between the two cores
+ *
+ * Each processed line (and each V-Sync) is described by a small record in
+ * shared SRAM: pool slot, line and frame number, capture timestamp and
+ * flags. The hardware FIFO only carries a doorbell telling the consumer to
+ * drain the ring, so its 8-entry depth no longer limits what is in flight
+ * and no in-band sentinel values are needed. Portable C11 (host-buildable).
+ */
+
+#ifndef PICOCRYPT_LINE_QUEUE_H
+#define PICOCRYPT_LINE_QUEUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#ifndef LINE_QUEUE_SIZE
+#define LINE_QUEUE_SIZE         16      // Entries, must be a power of two
+#endif
+
+#if (LINE_QUEUE_SIZE & (LINE_QUEUE_SIZE - 1)) != 0
+#error "LINE_QUEUE_SIZE must be a power of two"
+#endif
+
+// Keep producer and consumer indices apart (cache lines on the host; the
+// RP2040 has no data cache, so word alignment is enough there)
+#ifdef PICOCRYPT_HOST_BUILD
+#define LINE_QUEUE_ALIGN        64
+#else
+#define LINE_QUEUE_ALIGN        4
+#endif
+
+#define LINE_QUEUE_DOORBELL     0x4C514442u     // FIFO word: "drain the queue"
+
+// ===== DESCRIPTOR =====
+#define LINE_FLAG_VSYNC         0x01    // Start of a new frame, no line data
+#define LINE_FLAG_FIELD         0x02    // Odd field
+#define LINE_FLAG_ERROR         0x04    // Capture overrun before this line
+
+typedef struct {
+    uint8_t slot;               // Line pool buffer index
+    uint8_t flags;              // LINE_FLAG_*
+    uint16_t line;              // Line number within the frame
+    uint32_t frame;             // Frame (sync) counter
+    uint32_t timestamp_us;      // Capture start
+    uint16_t cut;               // Picture rotation (SCRAMBLE_ROTATE); 0: played as is
+} line_desc_t;
+
+// ===== QUEUE STRUCTURE =====
+typedef struct {
+    line_desc_t entries[LINE_QUEUE_SIZE];
+
+    // Producer side
+    _Atomic uint32_t head __attribute__((aligned(LINE_QUEUE_ALIGN)));
+    uint32_t tail_cache;        // Last tail seen by the producer
+    uint32_t full_count;        // Pushes rejected because the ring was full
+
+    // Consumer side
+    _Atomic uint32_t tail __attribute__((aligned(LINE_QUEUE_ALIGN)));
+    uint32_t head_cache;        // Last head seen by the consumer
+} line_queue_t;
+
+// ===== FUNCTION PROTOTYPES =====
+void line_queue_init(line_queue_t* queue);
+
+// Producer only. Returns false (and counts it) if the ring is full.
+bool line_queue_push(line_queue_t* queue, const line_desc_t* desc);
+
+// Consumer only. Returns false if the ring is empty.
+bool line_queue_pop(line_queue_t* queue, line_desc_t* desc);
+
+// Entries currently queued (approximate when called concurrently)
+uint32_t line_queue_count(line_queue_t* queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_LINE_QUEUE_H
@@ -0,0 +1,75 @@
+/*
+ * PicoCrypt FPV - Line History Store
+ * Last good copy of every active line, for dropout concealment
+ *
+ * A line that fails to decrypt (RF fade, sync slip) comes out as noise.
+ * The receiver keeps the last good version of each active line of the
+ * field and plays it instead. A full field of samples would not fit next
+ * to the rest of the receiver in SRAM, so each line is stored decimated
+ * and delta coded in a fixed arena:
+ *
+ *   Decimation  The mean of each LINE_STORE_DECIMATE samples: roughly the
+ *               luma, as the 4-sample mean cuts the colour subcarrier to
+ *               about a quarter
+ *   Coding      First sample as is, then one 4-bit code per sample for
+ *               the step from the last reconstructed sample (closed-loop
+ *               DPCM: coding errors never accumulate)
+ *   Decoding    Steps summed back, then linear interpolation to the full
+ *               line
+ *
+ * Entries are indexed by active line of the field, so a line is replaced
+ * by the same line of the previous field, which in interlaced profiles is
+ * the frame row next to it. Stored lines never expire: a long fade holds
+ * the last good picture. Portable C11 (host-testable).
+ */
+
+#ifndef PICOCRYPT_LINE_STORE_H
+#define PICOCRYPT_LINE_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#define LINE_STORE_DECIMATE     4
+#define LINE_STORE_SAMPLES      (VIDEO_ACTIVE_SAMPLES / LINE_STORE_DECIMATE)
+#define LINE_STORE_LINES        VIDEO_FIELD_ACTIVE_LINES
+// First sample, then two step codes per byte
+#define LINE_STORE_LINE_BYTES   (1 + LINE_STORE_SAMPLES / 2)
+#define LINE_STORE_STEPS        16
+#define LINE_STORE_MAX_DELTA    255
+
+_Static_assert(VIDEO_ACTIVE_SAMPLES % (2 * LINE_STORE_DECIMATE) == 0,
+               "Active line must be whole pairs of decimated samples");
+
+// ===== STRUCTURES =====
+typedef struct {
+    uint8_t lines[LINE_STORE_LINES][LINE_STORE_LINE_BYTES];
+    bool valid[LINE_STORE_LINES];
+    // Step code closest to each delta, built once by line_store_init()
+    uint8_t quantise[2 * LINE_STORE_MAX_DELTA + 1];
+} line_store_t;
+
+// ===== FUNCTION PROTOTYPES =====
+void line_store_init(line_store_t* store);
+
+// Store active line `index` of the field. `active` is the picture as
+// received, rotated left by `cut` samples (SCRAMBLE_ROTATE; 0 for XOR):
+// picture sample j is active[(j + cut) % VIDEO_ACTIVE_SAMPLES].
+void line_store_put(line_store_t* store, uint32_t index, const uint8_t* active,
+                    uint32_t cut);
+
+// Write the stored copy of line `index` over `active`
+// (VIDEO_ACTIVE_SAMPLES samples). Returns false if there is none.
+bool line_store_get(const line_store_t* store, uint32_t index, uint8_t* active);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_LINE_STORE_H
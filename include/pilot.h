@@ -0,0 +1,73 @@
+/*
+ * PicoCrypt FPV - Line Timing Pilot
+ * Known chip sequence in the H-Sync tip, for per-line sample alignment
+ *
+ * The XOR only decrypts if the receiver applies keystream sample k to
+ * transmitted sample k. A capture that starts a sample early or late
+ * (sync edge jitter, DMA start latency) turns the whole line into noise.
+ * The sender writes a Barker-13 sequence into the middle of the sync tip
+ * of every line it plays from a buffer (active and VBI code lines), at
+ * levels below the sync slicing threshold, so sync separators and
+ * monitors still see a plain sync pulse. The receiver correlates the
+ * captured tip against the sequence at every offset within +-PILOT_SEARCH
+ * samples and shifts its decryption span by the best match. The
+ * correlator weights are DC-free (sync level and link offset cancel) and
+ * integer: adds plus two multiplies per offset.
+ * Portable C11 (host-testable).
+ */
+
+#ifndef PICOCRYPT_PILOT_H
+#define PICOCRYPT_PILOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "line_map.h"
+#include "vbi_code.h"
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#define PILOT_CHIPS         13
+#define PILOT_CODE          0x1F35u     // Barker-13, first chip in bit 12
+#define PILOT_ONES          9           // Chips at PILOT_LEVEL_1
+#define PILOT_SEARCH        4           // Offsets searched: +-4 samples
+#define PILOT_LEVEL_0       4           // Sync tip
+#define PILOT_LEVEL_1       28          // Still below the sync slicing level
+// Centred in the sync tip, the search window included
+#define PILOT_START         ((VIDEO_H_SYNC_SAMPLES - PILOT_CHIPS) / 2)
+
+// Correlation of a clean pilot: each one chip weighted by the zero chips
+// and vice versa, so a constant level scores 0
+#define PILOT_PEAK          (PILOT_ONES * (PILOT_CHIPS - PILOT_ONES) * \
+                             (PILOT_LEVEL_1 - PILOT_LEVEL_0))
+
+_Static_assert(PILOT_START >= PILOT_SEARCH + 4 &&
+               PILOT_START + PILOT_CHIPS + PILOT_SEARCH + 4 <= VIDEO_H_SYNC_SAMPLES,
+               "Sync tip too short for the pilot and its search window");
+_Static_assert(PILOT_SEARCH <= VIDEO_H_FRONT_PORCH_SAMPLES,
+               "A shifted active span must stay inside the line");
+
+// Lines the sender plays from a line buffer, and so carry a pilot
+static inline bool pilot_line(uint32_t field_line) {
+    return line_map_is_active(field_line) || vbi_code_line(field_line) >= 0;
+}
+
+// ===== FUNCTION PROTOTYPES =====
+
+// Sender: write the pilot into a line's sync tip
+void pilot_write(uint8_t* line);
+
+// Receiver: offset of the line's content against the nominal timing, in
+// samples (positive: content later in the buffer). Returns false if no
+// offset correlates above half of PILOT_PEAK.
+bool pilot_find(const uint8_t* line, int32_t* offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_PILOT_H
@@ -0,0 +1,18 @@
+/*
+ * PicoCrypt FPV - Platform Helpers
+ * Placement attributes usable from portable (host-buildable) modules
+ */
+
+#ifndef PICOCRYPT_PLATFORM_H
+#define PICOCRYPT_PLATFORM_H
+
+// ===== CODE PLACEMENT =====
+// Run a function from SRAM instead of XIP flash. Same section naming as the
+// SDK's __not_in_flash_func(), without pulling SDK headers into the module.
+#if defined(__arm__) && !defined(PICOCRYPT_HOST_BUILD)
+#define PICOCRYPT_RAM_FUNC(name) __attribute__((section(".time_critical." #name))) name
+#else
+#define PICOCRYPT_RAM_FUNC(name) name
+#endif
+
+#endif // PICOCRYPT_PLATFORM_H
@@ -0,0 +1,122 @@
+/*
+ * PicoCrypt FPV - Receiver Pipeline
+ * Capture -> decrypt -> output line pipeline of the receiver
+ *
+ * Core 0 captures the encrypted signal, core 1 decrypts and drives the
+ * DAC. Before decrypting, core 1 finds the line's sample offset from the
+ * sender's pilot (pilot.h) and decrypts the span shifted by it (with
+ * SCRAMBLE_ROTATE: plays it rotated back, scramble.h). An active line
+ * whose sync tip reads as noise (fade), whose pilot is missing or that
+ * fails the sender's line check (line_check.h) within a run of failures
+ * is bad: it plays the last good copy of that line (line_store.h)
+ * instead. Such a run is a sync error (a line captured twice or not at
+ * all): the keystream is relocked a line either side until two lines in
+ * a row pass. A rekey switches keys at the same frame as the sender
+ * (rekey.h). Same structure as the sender pipeline; shared by the firmware
+ * (picocrypt_receiver.c) and the host simulator.
+ */
+
+#ifndef PICOCRYPT_RECEIVER_H
+#define PICOCRYPT_RECEIVER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "crypto.h"
+#include "hal.h"
+#include "keystream.h"
+#include "line_check.h"
+#include "line_map.h"
+#include "line_pool.h"
+#include "line_queue.h"
+#include "line_store.h"
+#include "pilot.h"
+#include "rekey.h"
+#include "scramble.h"
+#include "vbi_code.h"
+#include "video_input.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== RECEIVER STATE =====
+typedef struct {
+    line_pool_t pool;
+    line_queue_t queue;                 // Core 0 -> core 1 descriptors
+    video_input_t input;
+    hal_video_out_t* out;
+    uint32_t length;                    // Samples per line, from the sync tip
+
+    // Core 0
+    uint32_t capture_line;
+    uint32_t capture_frame;
+
+    // Core 1
+    hal_line_sum_t* sum;                // Picture sums for the line check (NULL: none)
+    rekey_t rekey;                      // Live and standby key
+    prng_state_t* prng;                 // Live generator
+    keystream_ring_t keystream;         // Filled during H/V blanking
+    uint32_t line_counter;              // Line of the field, VBI included
+    uint32_t crypto_samples;            // Keystream bytes used (statistics)
+    int32_t pilot_offset;               // Content shift of the current line, samples
+    uint32_t pilot_lines;               // Lines with a pilot found
+    uint32_t pilot_misses;              // Pilot lines without one (offset held)
+    uint32_t pilot_shifted;             // Lines decrypted at a non-zero offset
+    line_store_t history;               // Last good copy of each active line
+    uint32_t lines_bad;                 // Active lines faded, without a pilot or out of sync
+    uint32_t lines_concealed;           // Bad lines played from the history
+    uint32_t check_lines;               // Active lines checked
+    uint32_t check_errors;              // Checked lines whose sum did not match
+    uint32_t check_run;                 // Consecutive check errors
+    uint32_t check_noise;               // Link noise on the pilots, running mean
+    uint32_t check_slips;               // Line slips found by the check
+    int32_t line_slip;                  // Slip the keystream is trying
+    bool slip_pending;                  // Trial slip passed once, confirming
+    uint32_t sync_error_count;          // Check error runs and fields of the wrong length
+    vbi_code_t code;                    // This field's VBI code lines
+    uint32_t code_fields;               // Fields with a valid code
+    uint32_t code_errors;               // Fields whose code failed its checks
+    uint32_t code_relocks;              // Keystream moved to the coded frame
+    uint32_t frames_output;
+} receiver_t;
+
+// ===== FUNCTION PROTOTYPES =====
+void receiver_init(receiver_t* receiver, const crypto_key_t* key, uint32_t slot,
+                   uint32_t length, hal_video_in_t* in, hal_video_out_t* out,
+                   hal_line_sum_t* sum);
+
+// Core 0: start capturing the line that follows this H-Sync
+bool receiver_hsync(receiver_t* receiver);
+
+// Core 0: queue finished captures for core 1. Returns true if a
+// descriptor was queued.
+bool receiver_capture_step(receiver_t* receiver);
+
+// Core 0: queue a V-Sync descriptor
+void receiver_vsync(receiver_t* receiver);
+
+// Core 1: free slots whose output finished
+void receiver_retire(receiver_t* receiver);
+
+// Core 1: decrypt and output queued lines. Returns V-Syncs seen.
+uint32_t receiver_output_step(receiver_t* receiver);
+
+// Core 1: jump the keystream to (frame, active line) and refill the ring
+void receiver_relock(receiver_t* receiver, uint32_t frame, uint32_t line);
+
+// Core 1: switch to `key` (from `slot`) at the V-Sync starting `frame`,
+// or at a relock to that frame or later (rekey.h). Returns false if a
+// switch is pending or the frame too close.
+bool receiver_rekey(receiver_t* receiver, const crypto_key_t* key, uint32_t slot,
+                    uint32_t frame);
+
+// Draining core: queue per-stage latency histograms since the previous
+// report as trace text (trace_printf)
+void receiver_report_latency(receiver_t* receiver, line_hist_snapshot_t since[LINE_LAT_COUNT]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_RECEIVER_H
@@ -0,0 +1,78 @@
+/*
+ * PicoCrypt FPV - Rekey
+ * Key switch at a chosen frame, as a pointer flip at V-Sync
+ *
+ * Each unit holds two keystream generators: the live one and a standby.
+ * A rekey command keys the standby ahead of time (on whichever core
+ * parses USB) and arms a switch at a frame number both units agree on;
+ * the V-Sync that starts that frame makes the standby live. Keying
+ * (crypto_init_key) never runs at V-Sync, so a rekey adds a compare and
+ * a store to the handler (rekey_bench) and the first frame of the new
+ * key decrypts like any other. One switch may be armed at a time.
+ *
+ * Producer (rekey_schedule) and consumer (rekey_select) may run on
+ * different cores; the armed flag is published with release/acquire and
+ * the standby is never touched by the consumer until it sees it armed.
+ * Portable C11 (host-testable).
+ */
+
+#ifndef PICOCRYPT_REKEY_H
+#define PICOCRYPT_REKEY_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+// Frames a switch must be scheduled ahead of the current one: a command
+// parsed just before a V-Sync may reach the consumer just after it
+#ifndef REKEY_LEAD_FRAMES
+#define REKEY_LEAD_FRAMES       2
+#endif
+
+// ===== REKEY STATE =====
+typedef struct {
+    prng_state_t generators[2];         // Live and standby
+    uint32_t slots[2];                  // Key slot of each generator
+    _Atomic uint32_t live;              // Index of the live generator
+    _Atomic uint32_t armed;             // Standby keyed, waiting for its frame
+    _Atomic uint32_t frame;             // Frame of the last selection
+    uint32_t switch_frame;              // First frame of the standby's key
+    uint32_t switches;                  // Switches made (consumer)
+} rekey_t;
+
+// ===== FUNCTION PROTOTYPES =====
+
+// Key the live generator, positioned at `frame`, line 0
+void rekey_init(rekey_t* rekey, const crypto_key_t* key, uint32_t slot, uint32_t frame);
+
+// Producer: key the standby and arm a switch at `frame`. Returns false if
+// a switch is already armed or `frame` is fewer than REKEY_LEAD_FRAMES
+// after the last selected one.
+bool rekey_schedule(rekey_t* rekey, const crypto_key_t* key, uint32_t slot, uint32_t frame);
+
+// Consumer, at V-Sync and on relocks: the generator for `frame`, the
+// standby from the armed frame on. Sets *switched on a switch.
+prng_state_t* rekey_select(rekey_t* rekey, uint32_t frame, bool* switched);
+
+// Any core: the live generator's key slot
+static inline uint32_t rekey_slot(rekey_t* rekey) {
+    return rekey->slots[atomic_load_explicit(&rekey->live, memory_order_acquire)];
+}
+
+// Any core: last frame selected
+static inline uint32_t rekey_frame(rekey_t* rekey) {
+    return atomic_load_explicit(&rekey->frame, memory_order_relaxed);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_REKEY_H
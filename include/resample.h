@@ -0,0 +1,77 @@
+/*
+ * PicoCrypt FPV - Line Resampler
+ * Sender capture from the ADC rate to the output sample rate
+ *
+ * The AD9280 samples at VIDEO_ADC_RATE_HZ, the DAC and the link run at
+ * VIDEO_SAMPLE_RATE_HZ. Every captured line (VIDEO_CAPTURE_SAMPLES) is
+ * interpolated to exactly VIDEO_LINE_SAMPLES by a polyphase FIR with
+ * VIDEO_RESAMPLE_UP phases, stepping VIDEO_RESAMPLE_DOWN input samples per
+ * VIDEO_RESAMPLE_UP outputs. Each line restarts at phase 0 on its first
+ * sample, so the output is locked to H-Sync and the fractional ADC line
+ * length (NTSC) never accumulates.
+ *
+ * The per-phase taps are Q14 constants computed by the preprocessor from
+ * the profile's ratio: linear interpolation (2 taps, one multiply per
+ * sample) or Catmull-Rom cubic (4 taps), RESAMPLE_TAPS. The input offset
+ * of each phase comes from the same table, so the kernel is loads,
+ * multiplies and adds only: no divide, no floating point (Cortex-M0+).
+ *
+ * Runs in place: the capture lands RESAMPLE_IN_OFFSET samples into the
+ * line buffer and the output is written from the start, always behind
+ * the samples still to be read. Portable C11 (host-testable).
+ */
+
+#ifndef PICOCRYPT_RESAMPLE_H
+#define PICOCRYPT_RESAMPLE_H
+
+#include <stdint.h>
+
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#ifndef RESAMPLE_TAPS
+#define RESAMPLE_TAPS           2       // 2 (linear) or 4 (cubic)
+#endif
+
+#if RESAMPLE_TAPS != 2 && RESAMPLE_TAPS != 4
+#error "RESAMPLE_TAPS must be 2 or 4"
+#endif
+
+#define RESAMPLE_SHIFT          14      // Q14 coefficients
+#define RESAMPLE_MAX_PHASES     32      // Size of the generated phase table
+
+// Capture placement in the line buffer: one sample of edge padding
+// before, two after
+#define RESAMPLE_IN_OFFSET      (VIDEO_LINE_SAMPLES - VIDEO_CAPTURE_SAMPLES + 1)
+#define RESAMPLE_BUFFER_SAMPLES (RESAMPLE_IN_OFFSET + VIDEO_CAPTURE_SAMPLES + 2)
+
+_Static_assert(VIDEO_RESAMPLE_UP <= RESAMPLE_MAX_PHASES, "Too many resampler phases");
+_Static_assert(VIDEO_RESAMPLE_DOWN < VIDEO_RESAMPLE_UP, "Resampler only interpolates");
+// Last output's taps stay within the padded capture
+_Static_assert((VIDEO_LINE_SAMPLES - 1) * VIDEO_RESAMPLE_DOWN / VIDEO_RESAMPLE_UP + 2 <=
+               VIDEO_CAPTURE_SAMPLES + 1, "Capture too short for the resampled line");
+
+// ===== PHASE TABLE =====
+typedef struct {
+    int16_t w[RESAMPLE_TAPS];   // Q14 taps; linear uses w[1] only
+    uint16_t offset;            // First tap, in samples from the one before the cycle
+} resample_phase_t;
+
+// One entry per output of a VIDEO_RESAMPLE_UP-sample cycle
+extern const resample_phase_t resample_phases[RESAMPLE_MAX_PHASES];
+
+// ===== FUNCTION PROTOTYPES =====
+
+// In place: VIDEO_CAPTURE_SAMPLES at line + RESAMPLE_IN_OFFSET become
+// VIDEO_LINE_SAMPLES at line. The buffer must hold RESAMPLE_BUFFER_SAMPLES.
+void resample_line(uint8_t* line);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_RESAMPLE_H
@@ -0,0 +1,72 @@
+/*
+ * PicoCrypt FPV - Scrambling Mode
+ * XOR of the active picture, or a keyed cut-and-rotate of each line
+ *
+ * SCRAMBLE_XOR (default) XORs every active sample with the keystream:
+ * the picture is unreadable, at one keystream byte and one XOR per
+ * sample. SCRAMBLE_ROTATE leaves the samples alone and plays each active
+ * line's picture rotated about a cut point: samples [cut, A) first, then
+ * [0, cut). The cut comes from SCRAMBLE_KEY_BYTES of the line's
+ * keystream, so a frame costs one PRNG word per active line instead of a
+ * keystream line, and no CPU touches the samples: the output DMA plays
+ * the two parts as two transfers (frame_table.h). The receiver plays the
+ * line rotated by A - cut, which restores it. Rotation hides the picture
+ * far less well than XOR (columns survive, edges line up again under a
+ * line-to-line correlation attack); it is for links where CPU or
+ * keystream is the limit, not secrecy. Sender and receiver MUST be built
+ * with the same mode. Portable C11 (host-testable).
+ */
+
+#ifndef PICOCRYPT_SCRAMBLE_H
+#define PICOCRYPT_SCRAMBLE_H
+
+#include <stdint.h>
+
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#define SCRAMBLE_XOR                0
+#define SCRAMBLE_ROTATE             1
+
+#ifndef SCRAMBLE_MODE
+#define SCRAMBLE_MODE               SCRAMBLE_XOR
+#endif
+
+#if SCRAMBLE_MODE != SCRAMBLE_XOR && SCRAMBLE_MODE != SCRAMBLE_ROTATE
+#error "SCRAMBLE_MODE must be SCRAMBLE_XOR or SCRAMBLE_ROTATE"
+#endif
+
+#define SCRAMBLE_KEY_BYTES          4       // Keystream per rotated line
+// Cuts stay this far from either end: a cut near 0 or A barely moves
+// the picture, and neither transfer is ever empty
+#define SCRAMBLE_CUT_MIN            16
+#define SCRAMBLE_CUT_RANGE          (VIDEO_ACTIVE_SAMPLES - 2 * SCRAMBLE_CUT_MIN + 1)
+
+_Static_assert(VIDEO_ACTIVE_SAMPLES > 2 * SCRAMBLE_CUT_MIN, "Active line too short to rotate");
+
+// ===== CUT POINT =====
+
+// Cut of a line from its key bytes, in [SCRAMBLE_CUT_MIN,
+// VIDEO_ACTIVE_SAMPLES - SCRAMBLE_CUT_MIN] (multiply-shift, no division)
+static inline uint32_t scramble_cut(const uint8_t key[SCRAMBLE_KEY_BYTES]) {
+    uint32_t r = (uint32_t)key[0] | (uint32_t)key[1] << 8 | (uint32_t)key[2] << 16 |
+                 (uint32_t)key[3] << 24;
+    return SCRAMBLE_CUT_MIN + (uint32_t)(((uint64_t)r * SCRAMBLE_CUT_RANGE) >> 32);
+}
+
+// The line a rotated output plays (simulator, tests): `head` up to the
+// active picture, or regenerated blanking if NULL; `active` from sample
+// `cut`, then its first `cut` samples; the front porch of `head`, or
+// blanking
+void scramble_play_line(uint8_t* out, const uint8_t* head, const uint8_t* active,
+                        uint32_t cut);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_SCRAMBLE_H
@@ -0,0 +1,99 @@
+/*
+ * PicoCrypt FPV - Sender Pipeline
+ * Capture -> resample -> encrypt -> output line pipeline of the sender
+ *
+ * Core 0 captures at the ADC rate, resamples each line in place to the
+ * output rate (resample.h) and encrypts it (or, with SCRAMBLE_ROTATE,
+ * picks its cut: scramble.h), after summing its picture into the line
+ * check in the sync tip (line_check.h); core 1 outputs. Lines move
+ * between the cores as
+ * descriptors in the line queue. A rekey switches keys at a frame
+ * boundary (rekey.h). Hardware is reached only through the HAL,
+ * so the firmware (picocrypt_sender.c) and the host simulator run this
+ * same code.
+ */
+
+#ifndef PICOCRYPT_SENDER_H
+#define PICOCRYPT_SENDER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "crypto.h"
+#include "hal.h"
+#include "keystream.h"
+#include "line_check.h"
+#include "line_map.h"
+#include "line_pool.h"
+#include "line_queue.h"
+#include "pilot.h"
+#include "rekey.h"
+#include "resample.h"
+#include "scramble.h"
+#include "vbi_code.h"
+#include "video_input.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== SENDER STATE =====
+typedef struct {
+    line_pool_t pool;
+    line_queue_t queue;                 // Core 0 -> core 1 descriptors
+    video_input_t input;
+    hal_video_out_t* out;
+    uint32_t length;                    // Output samples per line, from the sync tip
+
+    // Core 0
+    hal_line_sum_t* sum;                // Picture sums for the line check
+    rekey_t rekey;                      // Live and standby key
+    prng_state_t* prng;                 // Live generator
+    keystream_ring_t keystream;         // Filled during H/V blanking
+    uint32_t line_counter;              // Line of the field, VBI included
+    uint32_t reported_overruns;
+    uint32_t crypto_samples;            // Keystream bytes used (statistics)
+
+    // Core 1
+    uint32_t frames_output;
+} sender_t;
+
+// ===== FUNCTION PROTOTYPES =====
+
+// The first V-Sync starts frame `frame` + 1. The keystream depends on
+// (key, frame, line) alone, so every power-up must start at a fresh frame
+// (picocrypt_sender.c draws it at random) or it repeats the last one's
+// keystream; the receiver follows through the VBI code.
+void sender_init(sender_t* sender, const crypto_key_t* key, uint32_t slot, uint32_t frame,
+                 uint32_t length, hal_video_in_t* in, hal_video_out_t* out,
+                 hal_line_sum_t* sum);
+
+// Core 0: start capturing the line that follows this H-Sync
+bool sender_hsync(sender_t* sender);
+
+// Core 0: finish captures, resample and encrypt one line. Returns true
+// if a descriptor was queued for core 1.
+bool sender_capture_step(sender_t* sender);
+
+// Core 0: resync the keystream and queue a V-Sync descriptor
+void sender_vsync(sender_t* sender);
+
+// Any core: switch to `key` (from `slot`) at the V-Sync starting `frame`
+// (rekey.h). Returns false if a switch is pending or the frame too close.
+bool sender_rekey(sender_t* sender, const crypto_key_t* key, uint32_t slot, uint32_t frame);
+
+// Core 1: free slots whose output finished
+void sender_retire(sender_t* sender);
+
+// Core 1: drain the queue into the output. Returns V-Syncs seen.
+uint32_t sender_output_step(sender_t* sender);
+
+// Draining core: queue per-stage latency histograms since the previous
+// report as trace text (trace_printf)
+void sender_report_latency(sender_t* sender, line_hist_snapshot_t since[LINE_LAT_COUNT]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_SENDER_H
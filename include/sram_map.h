@@ -0,0 +1,70 @@
+/*
+ * PicoCrypt FPV - SRAM Placement Map
+ * Where the line loop's code, buffers and stacks live on the RP2040
+ *
+ * SRAM is six banks, each with its own bus fabric port: SRAM0-3 (256 KB)
+ * word-striped from 0x20000000 and also mapped unstriped, one bank after
+ * the other, from 0x21000000; SRAM4 (scratch X) and SRAM5 (scratch Y),
+ * 4 KB each. Masters only stall each other when they hit the same bank in
+ * the same cycle. Per line four are active: capture DMA, core 0, core 1
+ * and output DMA.
+ *
+ *   Code        Line loop, crypto and HAL hot path in striped SRAM
+ *               (PICOCRYPT_RAM_FUNC, __not_in_flash_func): no XIP misses
+ *   Stacks      Core 0 in scratch Y, core 1 in scratch X (SDK layout,
+ *               nothing else is placed there): private to each core
+ *   Line pool   SRAM_PLACEMENT_BANKED: slot k in bank k % 4, so capture
+ *               DMA, crypto and output DMA work in three different banks
+ *               (slots four lines apart share one, e.g. 0 and 4 at the
+ *               default depth of 5). SRAM_PLACEMENT_STRIPED: every slot
+ *               across all four banks, the linker default
+ *   Other data  Striped: keystream ring, descriptor queue, unit state
+ *               (the receiver's line history included)
+ *
+ * src/sram_bench.c measures line-loop cycle jitter per placement.
+ */
+
+#ifndef PICOCRYPT_SRAM_MAP_H
+#define PICOCRYPT_SRAM_MAP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#define SRAM_PLACEMENT_STRIPED  0
+#define SRAM_PLACEMENT_BANKED   1
+
+#ifndef SRAM_PLACEMENT
+#define SRAM_PLACEMENT          SRAM_PLACEMENT_BANKED
+#endif
+
+// The unstriped alias only exists on the RP2040; host builds stay striped
+#if SRAM_PLACEMENT == SRAM_PLACEMENT_BANKED && defined(__arm__) && !defined(PICOCRYPT_HOST_BUILD)
+#define SRAM_BANKED             1
+#else
+#define SRAM_BANKED             0
+#endif
+
+// ===== MEMORY MAP =====
+#define SRAM_BANKS              4
+#define SRAM_STRIPED_BASE       0x20000000u
+#define SRAM_UNSTRIPED_BASE     0x21000000u
+#define SRAM_BANK_BYTES         0x10000u
+
+// Column `bank` of word-interleaved storage (uint32_t [words][SRAM_BANKS],
+// 16-byte aligned, in striped SRAM) as one contiguous buffer in that bank.
+// Every word of column k sits in bank k; the unstriped alias lines them up.
+static inline void* sram_bank_view(void* storage, uint32_t bank) {
+    uint32_t offset = (uint32_t)(uintptr_t)storage - SRAM_STRIPED_BASE;
+    return (void*)(uintptr_t)(SRAM_UNSTRIPED_BASE + bank * SRAM_BANK_BYTES +
+                              offset / SRAM_BANKS);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_SRAM_MAP_H
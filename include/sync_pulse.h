@@ -0,0 +1,89 @@
+/*
+ * PicoCrypt FPV - Sync Pulse Classifier
+ * Turns sync edge timestamps into line and field events
+ *
+ * A PIO timer stamps every falling and rising edge of the composite sync
+ * with a free-running down-counter and DMA copies the stamps into a ring
+ * (hal_pico). This module pairs them into low pulses, classifies each by
+ * width and raises events only at boundaries:
+ *
+ *   H-Sync       ~4.7 us, one per line
+ *   Equalising   ~H/2, half-line spaced around V-Sync
+ *   Broad        half a line minus H, serrated V-Sync
+ *
+ * A line starts at the falling edge of any valid pulse a whole line after
+ * the previous line start; half-line pulses in the VBI are skipped. A
+ * field starts at the first broad pulse; broad pulses starting mid-line
+ * mark the second field of an interlaced frame. Pulses come out of the
+ * timer in edge pairs; a "low time" longer than any broad pulse is the
+ * high time between pulses, and the pairing is shifted by one edge.
+ * Thresholds follow the video profile. Portable C11 (host-testable).
+ */
+
+#ifndef PICOCRYPT_SYNC_PULSE_H
+#define PICOCRYPT_SYNC_PULSE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== PULSES AND EVENTS =====
+typedef enum {
+    SYNC_PULSE_INVALID = 0,     // Glitch or out-of-spec width
+    SYNC_PULSE_EQUALISING,
+    SYNC_PULSE_HSYNC,
+    SYNC_PULSE_BROAD,
+    SYNC_PULSE_KIND_COUNT
+} sync_pulse_kind_t;
+
+#define SYNC_EVENT_LINE         0x01    // Line start
+#define SYNC_EVENT_FIELD        0x02    // Field start: handle before LINE
+
+typedef struct {
+    uint8_t flags;
+    uint8_t field;              // FIELD: 0 line-aligned, 1 starts mid-line
+    uint16_t lines;             // LINE: line periods since the last line start
+    uint32_t ticks;             // Falling edge, timer ticks
+} sync_event_t;
+
+// ===== CLASSIFIER STATE =====
+typedef struct {
+    // Thresholds in timer ticks
+    uint32_t line_ticks;
+    uint32_t glitch_max;
+    uint32_t equalising_max;
+    uint32_t hsync_max;
+    uint32_t broad_min;
+    uint32_t broad_max;
+
+    bool have_fall;             // First edge of a pair seen
+    uint32_t fall;
+    bool have_line;
+    uint32_t last_line;         // Falling edge of the last line start
+    bool in_broad;
+
+    uint32_t counts[SYNC_PULSE_KIND_COUNT];
+    uint32_t resyncs;           // Edge pairing corrected
+} sync_pulse_t;
+
+// ===== FUNCTION PROTOTYPES =====
+
+// tick_hz: rate of the edge timer
+void sync_pulse_init(sync_pulse_t* sep, uint32_t tick_hz);
+
+sync_pulse_kind_t sync_pulse_classify(const sync_pulse_t* sep, uint32_t width);
+
+// Feed one timer word (down-counter at an edge, falling and rising
+// alternately). Returns true and fills the event at a line or field start.
+bool sync_pulse_word(sync_pulse_t* sep, uint32_t word, sync_event_t* event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_SYNC_PULSE_H
@@ -0,0 +1,117 @@
+/*
+ * PicoCrypt FPV - Event Trace
+ * Deferred binary event log, so real-time code never blocks on USB stdio
+ *
+ * trace_event() stores a fixed-size record (event, timestamp, two args)
+ * in the calling core's ring: one load, a 16-byte copy and a release
+ * store. trace_drain() runs at low priority (the output core's idle
+ * loop), frames whatever the debug channel accepts without blocking and
+ * writes it through the HAL. Full rings drop records and count them;
+ * the drain reports the count as a TRACE_EV_DROPPED record.
+ *
+ * Replies to USB commands go the same way: trace_printf() queues text on
+ * the draining core and the drain writes it ahead of the records, so a
+ * slow or absent host never stalls the output core on stdio.
+ *
+ * Wire format, little-endian, interleaved with plain text:
+ *   0xA5 0x5A | trace_record_t (16 bytes) | checksum (~sum of the 16)
+ * src/trace_decode.c turns the stream back into a log and a timeline.
+ */
+
+#ifndef PICOCRYPT_TRACE_H
+#define PICOCRYPT_TRACE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE         64      // Records per core (power of two)
+#endif
+
+#ifndef TRACE_TEXT_SIZE
+#define TRACE_TEXT_SIZE         1024    // Queued text bytes (power of two)
+#endif
+#define TRACE_TEXT_LINE         160     // Longest single trace_printf()
+
+#define TRACE_CORES             2
+#define TRACE_SYNC0             0xA5
+#define TRACE_SYNC1             0x5A
+#define TRACE_FRAME_SIZE        (2 + sizeof(trace_record_t) + 1)
+
+#if (TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) != 0
+#error "TRACE_RING_SIZE must be a power of two"
+#endif
+#if (TRACE_TEXT_SIZE & (TRACE_TEXT_SIZE - 1)) != 0
+#error "TRACE_TEXT_SIZE must be a power of two"
+#endif
+
+// ===== EVENTS =====
+typedef enum {
+    TRACE_EV_NONE = 0,
+    TRACE_EV_BOOT,              // arg0: role ('S'/'R'), arg1: VIDEO_PROFILE
+    TRACE_EV_CRYPTO_BUDGET,     // arg0: crypto cycles/line, arg1: budget cycles/line
+    TRACE_EV_CORE_START,        // arg0: core
+    TRACE_EV_VSYNC,             // arg0: frame (sync counter), arg1: lines in last field
+    TRACE_EV_FIELD_TIMING,      // arg0: field period us, arg1: expected us
+    TRACE_EV_SYNC_ERROR,        // arg0: sync errors so far, arg1: line
+    TRACE_EV_RELOCK,            // arg0: frame, arg1: line
+    TRACE_EV_OVERRUN,           // arg0: pool overruns so far, arg1: line
+    TRACE_EV_DROPPED,           // arg0: core, arg1: records lost (from the drain)
+    TRACE_EV_CLOCK_PLAN,        // arg0: clk_sys kHz, arg1: clk_sys cycles/line
+    TRACE_EV_CLOCK_DIVIDERS,    // arg0: pixel PIO divider x256, arg1: ADC period x256 (cycles)
+    TRACE_EV_CPU_LOAD,          // arg0: busy per mille, arg1: busiest field per mille
+    TRACE_EV_REKEY,             // arg0: first frame of the new key, arg1: key slot
+    TRACE_EV_COUNT
+} trace_event_t;
+
+// ===== STRUCTURES =====
+typedef struct {
+    uint16_t event;
+    uint8_t core;
+    uint8_t seq;                // Per-core sequence, gaps = lost records
+    uint32_t timestamp_us;
+    uint32_t arg0;
+    uint32_t arg1;
+} trace_record_t;
+
+_Static_assert(sizeof(trace_record_t) == 16, "Trace record must stay 16 bytes");
+
+typedef struct {
+    trace_record_t records[TRACE_RING_SIZE];
+    _Atomic uint32_t head;      // Written by the owning core
+    _Atomic uint32_t tail;      // Written by the drain
+    _Atomic uint32_t dropped;   // Owning core: records lost, cumulative
+    uint32_t reported;          // Drain: dropped count already reported
+    uint8_t seq;
+} trace_ring_t;
+
+// ===== FUNCTION PROTOTYPES =====
+void trace_init(void);
+
+// Any core, real-time safe; never blocks (not from IRQ handlers of a
+// core whose thread code also traces)
+void trace_event(trace_event_t event, uint32_t arg0, uint32_t arg1);
+
+// Draining core only: queue text for the debug channel (command replies,
+// reports). Never blocks; text that does not fit is dropped whole and
+// false returned.
+bool trace_printf(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+// Low priority, one core only: stream queued text, then records, to the
+// debug channel. Returns text writes plus records written.
+uint32_t trace_drain(void);
+
+// Encode one record as a wire frame (TRACE_FRAME_SIZE bytes)
+void trace_encode(const trace_record_t* record, uint8_t* frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_TRACE_H
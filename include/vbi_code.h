@@ -0,0 +1,74 @@
+/*
+ * PicoCrypt FPV - VBI Frame Code
+ * Field counter and sync word carried in the vertical blanking
+ *
+ * The sender writes the keystream frame number of every field into the
+ * active span of VBI_CODE_LINES blank lines: a 16-bit sync word, the
+ * 32-bit counter and a CRC-8, MSB first, one bit per symbol of
+ * VBI_CODE_SYMBOL_SAMPLES samples at blanking (0) or grey (1) level.
+ * The receiver slices each symbol against a threshold taken from the
+ * sync word's own bits (survives link gain and offset), takes the
+ * majority of the samples in the middle of each symbol, and then the
+ * majority of each bit across the lines. A good sync word and CRC give
+ * the counter before the first active line, so the receiver keys the
+ * field correctly even after power-up, signal loss or a missed V-Sync.
+ * Portable C11 (host-testable).
+ */
+
+#ifndef PICOCRYPT_VBI_CODE_H
+#define PICOCRYPT_VBI_CODE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== CONFIGURATION =====
+#define VBI_CODE_LINES          3
+#define VBI_CODE_FIRST_LINE     (VIDEO_VBI_LINES - 6)   // Clear of the V-Sync pulses
+#define VBI_CODE_SYNC_WORD      0xC5A3u                 // Eight ones, eight zeros
+#define VBI_CODE_BITS           (16 + 32 + 8)
+#define VBI_CODE_SYMBOL_SAMPLES (VIDEO_ACTIVE_SAMPLES / VBI_CODE_BITS)
+#define VBI_CODE_LEVEL_0        64      // Blanking
+#define VBI_CODE_LEVEL_1        176
+#define VBI_CODE_MIN_SWING      32      // Sync word levels closer than this: no code
+
+_Static_assert(VBI_CODE_SYMBOL_SAMPLES >= 4, "Active line too short for the VBI code");
+
+// ===== DECODER =====
+typedef struct {
+    uint8_t ones[VBI_CODE_BITS];        // Lines that read a 1, per bit
+    uint8_t lines;                      // Lines with a readable sync word
+} vbi_code_t;
+
+// Code line (0 .. VBI_CODE_LINES-1) of a field line, or -1
+static inline int vbi_code_line(uint32_t field_line) {
+    return field_line >= VBI_CODE_FIRST_LINE && field_line < VBI_CODE_FIRST_LINE + VBI_CODE_LINES
+        ? (int)(field_line - VBI_CODE_FIRST_LINE) : -1;
+}
+
+// ===== FUNCTION PROTOTYPES =====
+
+// Sender: overwrite the active span (VIDEO_ACTIVE_SAMPLES) of a code line
+void vbi_code_write(uint8_t* active, uint32_t frame);
+
+// Receiver: start collecting a field's code lines
+void vbi_code_reset(vbi_code_t* code);
+
+// Receiver: slice the active span of one code line. Returns false if the
+// line carries no readable code.
+bool vbi_code_read(vbi_code_t* code, const uint8_t* active);
+
+// Majority across the lines read; true and the frame number if the sync
+// word and CRC check out
+bool vbi_code_decode(const vbi_code_t* code, uint32_t* frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_VBI_CODE_H
@@ -0,0 +1,71 @@
+/*
+ * PicoCrypt FPV - Video Capture Engine
+ * AD9280 lines into pool buffers from a PIO and two chained DMA channels
+ *
+ * One PIO state machine clocks the ADC (side-set on the clock pin) and
+ * reads its 8-bit data bus. For every line it is armed for, it waits for
+ * a falling edge of the composite sync, clocks out the ADC pipeline
+ * (VIDEO_CAPTURE_ADC_LATENCY clocks, discarded) and pushes one sample per
+ * ADC clock, read at the rising edge. It stops VIDEO_CAPTURE_GUARD clocks
+ * short of a whole line and pads the line with the held output, so it is
+ * waiting again before a line that starts early. The ADC clock is
+ * line-locked: it restarts at every sync edge and idles low in between.
+ *
+ * Captures alternate between two DMA channels paced by the RX FIFO. A
+ * capture armed while the other channel is still busy is chained behind
+ * it, so back-to-back lines need no CPU at the line boundary. A channel
+ * only ever chains to a channel armed for the next line. Armed on one
+ * line's H-Sync, a capture starts with the next line. Shared by sender
+ * and receiver.
+ */
+
+#ifndef PICOCRYPT_VIDEO_CAPTURE_H
+#define PICOCRYPT_VIDEO_CAPTURE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+
+#include "clock_plan.h"
+
+// ===== CONFIGURATION =====
+#define VIDEO_CAPTURE_ADC_LATENCY   3       // AD9280 pipeline delay, clocks
+#define VIDEO_CAPTURE_GUARD         1       // Clocks left for a line that starts early
+#define VIDEO_CAPTURE_TAIL          (VIDEO_CAPTURE_ADC_LATENCY + VIDEO_CAPTURE_GUARD)
+#define VIDEO_CAPTURE_DATA_PINS     8
+
+// The padded tail lies in the front porch, also at the sender's ADC rate
+_Static_assert((VIDEO_CAPTURE_TAIL * VIDEO_RESAMPLE_UP + VIDEO_RESAMPLE_DOWN - 1) /
+               VIDEO_RESAMPLE_DOWN <= VIDEO_H_FRONT_PORCH_SAMPLES,
+               "Front porch shorter than the capture tail");
+
+// ===== CAPTURE ENGINE =====
+typedef struct {
+    PIO pio;
+    uint sm;
+    uint dma_chan[2];               // Capture k runs on dma_chan[k % 2]
+    uint32_t length;                // Samples per line
+    uint32_t armed;                 // Captures armed
+    uint32_t done;                  // Captures finished
+    uint32_t polled;                // `done` already reported
+} video_capture_t;
+
+// ===== FUNCTION PROTOTYPES =====
+
+// Load the capture program (data bus on data_pin..data_pin + 7, ADC clock
+// on clock_pin, composite sync on sync_pin) at the plan's ADC clock and
+// claim the two DMA channels. Lines are `length` samples.
+void video_capture_init(video_capture_t* cap, PIO pio, uint sm, uint data_pin,
+                        uint clock_pin, uint sync_pin, const clock_plan_t* plan,
+                        uint32_t length);
+
+// Capture the next line (from its sync edge) into `line`. Returns false
+// if two captures are already in flight.
+bool video_capture_arm(video_capture_t* cap, uint8_t* line);
+
+// Number of captures finished since the last call, in arming order
+uint32_t video_capture_poll(video_capture_t* cap);
+
+#endif // PICOCRYPT_VIDEO_CAPTURE_H
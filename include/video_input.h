@@ -0,0 +1,52 @@
+/*
+ * PicoCrypt FPV - Video Input Front End
+ * Captures lines into the line pool through the HAL
+ *
+ * Owns the CAPTURE and CAPTURED stages of the pool. Each H-Sync claims a
+ * free slot and hands it to the HAL, which may still be filling earlier
+ * ones (the RP2040 engine captures the line after the H-Sync); finished
+ * captures become CAPTURED in order. Shared by sender and receiver; the
+ * caller's loop runs video_input_poll() every iteration and
+ * video_input_hsync() on each H-Sync.
+ */
+
+#ifndef PICOCRYPT_VIDEO_INPUT_H
+#define PICOCRYPT_VIDEO_INPUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hal.h"
+#include "line_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== INPUT STRUCTURE =====
+typedef struct {
+    line_pool_t* pool;
+    hal_video_in_t* hw;
+    uint32_t offset;            // Capture start in the slot's line buffer
+    uint32_t length;            // Samples per line
+    uint32_t finished;          // Captures finished, not yet CAPTURED
+} video_input_t;
+
+// ===== FUNCTION PROTOTYPES =====
+// Lines are captured `offset` samples into their buffer (the sender's
+// resampler input, resample.h), `length` samples each
+void video_input_init(video_input_t* input, line_pool_t* pool, hal_video_in_t* hw,
+                      uint32_t offset, uint32_t length);
+
+// H-Sync: start capturing into a free slot. Returns false (counted as a
+// pool overrun) if no slot is free or the HAL has no room for the capture.
+bool video_input_hsync(video_input_t* input);
+
+// Oldest slot whose capture finished (now CAPTURED), or -1. One per call.
+int video_input_poll(video_input_t* input);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_VIDEO_INPUT_H
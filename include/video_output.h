@@ -0,0 +1,101 @@
+/*
+ * PicoCrypt FPV - Video Output Engine
+ * Whole fields to the R-2R DAC PIO from a DMA descriptor chain
+ *
+ * Two DMA channels play a field with no CPU involvement. The control
+ * channel walks the field's descriptor table (frame_table.h) and writes
+ * each {count, address} pair into the data channel's TRANS_COUNT /
+ * READ_ADDR_TRIG alias. That write triggers the data channel, which
+ * streams the samples into the PIO TX FIFO and chains back to the control
+ * channel. The zero descriptor at the end of the table stops both.
+ *
+ * Sync, equalising and broad pulses and blank lines are constant. Core 1
+ * only swaps each active line buffer into its line's descriptor before
+ * the DMA gets there; a line that arrives late, or never, plays black.
+ * With SCRAMBLE_ROTATE a line can also be swapped in rotated: the
+ * picture plays as two transfers from the cut (frame_table.h), so the
+ * rotation costs no CPU.
+ * The input starts each field: when line VIDEO_OUTPUT_START_LINE of an
+ * input field is submitted, that field's table is triggered (or as soon
+ * as the previous one ends), so output trails input by a fixed number of
+ * lines and never drifts against the camera. Shared by sender and
+ * receiver.
+ */
+
+#ifndef PICOCRYPT_VIDEO_OUTPUT_H
+#define PICOCRYPT_VIDEO_OUTPUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+
+#include "clock_plan.h"
+#include "frame_table.h"
+
+// ===== CONFIGURATION =====
+#define VIDEO_OUTPUT_DATA_PINS      8       // R-2R DAC bits
+#define VIDEO_OUTPUT_START_LINE     1       // A line of slack for capture and crypto
+#define VIDEO_OUTPUT_INFLIGHT       8       // Submitted lines not yet retired (power of two)
+
+// ===== OUTPUT ENGINE =====
+typedef struct {
+    const uint8_t* line;            // As given to frame_table_clear_line()
+    uint32_t seq;                   // Field sequence number
+    int16_t desc;                   // -1: nothing to wait for
+    uint8_t field;
+} video_output_entry_t;
+
+typedef struct {
+    PIO pio;
+    uint sm;
+    uint ctrl_chan;                 // Walks the descriptor table
+    uint data_chan;                 // Samples into the PIO TX FIFO
+    frame_table_t table;
+
+    // Input side: field being submitted
+    uint field;
+    uint32_t seq;
+    uint32_t field_lines;           // Lines submitted in this field
+
+    // Output side: field playing (or waiting for the previous one)
+    uint play_field;
+    uint32_t play_seq;              // 0: nothing started yet
+    bool start_pending;
+
+    video_output_entry_t inflight[VIDEO_OUTPUT_INFLIGHT];
+    uint32_t head;
+    uint32_t tail;
+    uint32_t late;                  // Active lines that missed their descriptor
+} video_output_t;
+
+// ===== FUNCTION PROTOTYPES =====
+
+// Load the output program (R-2R DAC on data_pin..data_pin + 7, one
+// sample per cycle at the plan's pixel clock), build the field tables
+// and claim the two DMA channels feeding its TX FIFO
+void video_output_init(video_output_t* out, PIO pio, uint sm, uint data_pin,
+                       const clock_plan_t* plan);
+
+// The next submitted line is line 0 of a new input field
+void video_output_field(video_output_t* out);
+
+// Hand over the next line of the field (VIDEO_LINE_SAMPLES from the
+// H-Sync tip). Returns false if too many lines are in flight (retire
+// finished lines first).
+bool video_output_submit(video_output_t* out, const uint8_t* line, uint length);
+
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+// Same for a whole line whose VIDEO_ACTIVE_SAMPLES picture (`active`)
+// plays rotated by `cut` behind the head and front porch of `head`, or
+// regenerated blanking if NULL. Late if the DMA has already loaded the
+// descriptor ahead of the line.
+bool video_output_submit_rotated(video_output_t* out, const uint8_t* head,
+                                 const uint8_t* active, uint32_t cut);
+#endif
+
+// Number of lines that finished since the last call, in submission order
+uint video_output_poll(video_output_t* out);
+
+#endif // PICOCRYPT_VIDEO_OUTPUT_H
@@ -0,0 +1,127 @@
+/*
+ * PicoCrypt FPV - Video Profiles
+ * Compile-time video standard: sampling, line and field timing
+ *
+ * Select with -DVIDEO_PROFILE=VIDEO_PROFILE_<name> (CMake: -DVIDEO_PROFILE=
+ * PAL, NTSC or FPV_LOWRES). Sender and receiver MUST use the same profile.
+ * Everything sized or timed per line (line buffers, keystream length, PIO
+ * clock plan, V-Sync window) is derived from the values below.
+ *
+ * The sender's ADC runs at VIDEO_ADC_RATE_HZ; its lines are resampled by
+ * VIDEO_RESAMPLE_UP / VIDEO_RESAMPLE_DOWN to the output sample rate
+ * (resample.h) before encryption. Everything after that, receiver
+ * included, runs at VIDEO_SAMPLE_RATE_HZ.
+ *
+ * Horizontal timing is in samples from the start of the H-Sync tip;
+ * sync + back porch + active + front porch = one line. V-Sync arrives once
+ * per field, so line counters and the keystream reset every field.
+ */
+
+#ifndef PICOCRYPT_VIDEO_PROFILE_H
+#define PICOCRYPT_VIDEO_PROFILE_H
+
+#include <stdint.h>
+
+// ===== PROFILES =====
+#define VIDEO_PROFILE_PAL           0   // 576i/50, BT.601 13.5 MHz
+#define VIDEO_PROFILE_NTSC          1   // 480i/59.94, BT.601 13.5 MHz
+#define VIDEO_PROFILE_FPV_LOWRES    2   // 288p/50 monochrome, 6.75 MHz
+
+#ifndef VIDEO_PROFILE
+#define VIDEO_PROFILE               VIDEO_PROFILE_PAL
+#endif
+
+#if VIDEO_PROFILE == VIDEO_PROFILE_PAL
+#define VIDEO_PROFILE_NAME          "PAL 576i"
+#define VIDEO_SAMPLE_RATE_HZ        13500000
+#define VIDEO_H_SYNC_SAMPLES        63      // 4.7 us
+#define VIDEO_H_BACK_PORCH_SAMPLES  69      // Burst + porch, 5.1 us
+#define VIDEO_ACTIVE_SAMPLES        720     // 53.3 us
+#define VIDEO_H_FRONT_PORCH_SAMPLES 12      // 0.9 us (line = 864 = 64 us)
+#define VIDEO_TOTAL_LINES           625     // Per frame
+#define VIDEO_ACTIVE_LINES          576
+#define VIDEO_FIELDS                2       // Interlaced
+#define VIDEO_FIELD_RATE_NUM        50      // Fields per second (fraction)
+#define VIDEO_FIELD_RATE_DEN        1
+#define VIDEO_SUBCARRIER_HZ         4433618.75
+#define VIDEO_ADC_RATE_HZ           10000000    // AD9280 capture clock
+#define VIDEO_RESAMPLE_UP           27          // 10 -> 13.5 MHz
+#define VIDEO_RESAMPLE_DOWN         20
+
+#elif VIDEO_PROFILE == VIDEO_PROFILE_NTSC
+#define VIDEO_PROFILE_NAME          "NTSC 480i"
+#define VIDEO_SAMPLE_RATE_HZ        13500000
+#define VIDEO_H_SYNC_SAMPLES        63      // 4.7 us
+#define VIDEO_H_BACK_PORCH_SAMPLES  59      // 4.4 us
+#define VIDEO_ACTIVE_SAMPLES        720     // 53.3 us
+#define VIDEO_H_FRONT_PORCH_SAMPLES 16      // 1.2 us (line = 858 = 63.6 us)
+#define VIDEO_TOTAL_LINES           525
+#define VIDEO_ACTIVE_LINES          480
+#define VIDEO_FIELDS                2
+#define VIDEO_FIELD_RATE_NUM        60000
+#define VIDEO_FIELD_RATE_DEN        1001
+#define VIDEO_SUBCARRIER_HZ         3579545.45
+#define VIDEO_ADC_RATE_HZ           10000000
+#define VIDEO_RESAMPLE_UP           27
+#define VIDEO_RESAMPLE_DOWN         20
+
+#elif VIDEO_PROFILE == VIDEO_PROFILE_FPV_LOWRES
+// Progressive 288 lines on PAL line timing at half the sample rate:
+// half the samples (and keystream) per line of the full-resolution modes
+#define VIDEO_PROFILE_NAME          "FPV 288p low-res"
+#define VIDEO_SAMPLE_RATE_HZ        6750000
+#define VIDEO_H_SYNC_SAMPLES        32      // 4.7 us
+#define VIDEO_H_BACK_PORCH_SAMPLES  34      // 5.0 us
+#define VIDEO_ACTIVE_SAMPLES        360     // 53.3 us
+#define VIDEO_H_FRONT_PORCH_SAMPLES 6       // 0.9 us (line = 432 = 64 us)
+#define VIDEO_TOTAL_LINES           312
+#define VIDEO_ACTIVE_LINES          288
+#define VIDEO_FIELDS                1       // Progressive
+#define VIDEO_FIELD_RATE_NUM        15625   // One field per 312 lines
+#define VIDEO_FIELD_RATE_DEN        312
+#define VIDEO_SUBCARRIER_HZ         0.0     // Monochrome
+#define VIDEO_ADC_RATE_HZ           5000000     // Same ratio as full resolution
+#define VIDEO_RESAMPLE_UP           27          // 5 -> 6.75 MHz
+#define VIDEO_RESAMPLE_DOWN         20
+
+#else
+#error "Unknown VIDEO_PROFILE"
+#endif
+
+// ===== DERIVED TIMING =====
+#define VIDEO_LINE_SAMPLES          (VIDEO_H_SYNC_SAMPLES + VIDEO_H_BACK_PORCH_SAMPLES + \
+                                     VIDEO_ACTIVE_SAMPLES + VIDEO_H_FRONT_PORCH_SAMPLES)
+#define VIDEO_ACTIVE_START          (VIDEO_H_SYNC_SAMPLES + VIDEO_H_BACK_PORCH_SAMPLES)
+#define VIDEO_LINE_PERIOD_NS        ((uint32_t)((VIDEO_LINE_SAMPLES * 1000000000ULL + \
+                                     VIDEO_SAMPLE_RATE_HZ / 2) / VIDEO_SAMPLE_RATE_HZ))
+
+// Whole ADC samples per line (the sender's capture length)
+#define VIDEO_CAPTURE_SAMPLES       (VIDEO_LINE_SAMPLES * VIDEO_RESAMPLE_DOWN / VIDEO_RESAMPLE_UP)
+
+#define VIDEO_FIELD_LINES           (VIDEO_TOTAL_LINES / VIDEO_FIELDS)      // Whole lines
+#define VIDEO_FIELD_ACTIVE_LINES    (VIDEO_ACTIVE_LINES / VIDEO_FIELDS)
+#define VIDEO_VBI_LINES             (VIDEO_FIELD_LINES - VIDEO_FIELD_ACTIVE_LINES)
+#define VIDEO_FIELD_PERIOD_US       ((uint32_t)((1000000ULL * VIDEO_FIELD_RATE_DEN + \
+                                     VIDEO_FIELD_RATE_NUM / 2) / VIDEO_FIELD_RATE_NUM))
+#define VIDEO_FIELD_TOLERANCE_US    (VIDEO_FIELD_PERIOD_US / 20)            // +-5%
+
+// ===== PIO CLOCK =====
+// One PIO instruction per sample. SYS_CLK_KHZ is the highest clk_sys the
+// clock plan may pick (include/clock_plan.h); the dividers come from the
+// plan at boot.
+#ifndef SYS_CLK_KHZ
+#define SYS_CLK_KHZ                 270000
+#endif
+#define VIDEO_PIO_CYCLES_PER_SAMPLE 1
+
+// ===== SANITY CHECKS =====
+#if VIDEO_ACTIVE_LINES % VIDEO_FIELDS != 0
+#error "Active lines must split evenly into fields"
+#endif
+
+_Static_assert(VIDEO_ACTIVE_SAMPLES % 4 == 0, "Active line must be whole 32-bit words");
+_Static_assert((uint64_t)VIDEO_ADC_RATE_HZ * VIDEO_RESAMPLE_UP ==
+               (uint64_t)VIDEO_SAMPLE_RATE_HZ * VIDEO_RESAMPLE_DOWN,
+               "Resampling ratio does not match the ADC and output rates");
+
+#endif // PICOCRYPT_VIDEO_PROFILE_H
@@ -0,0 +1,49 @@
+/*
+ * PicoCrypt FPV - Composite Video Synthesizer (host)
+ * Composite lines of the build's video profile as 8-bit ADC codes
+ *
+ * Each line has a sync tip, back porch with colour burst, active video
+ * (75% colour bars over a moving luma ramp, colour subcarrier included)
+ * and front porch, plus optional Gaussian noise. Monochrome profiles
+ * (no subcarrier) get luma only. Feeds the simulator.
+ */
+
+#ifndef PICOCRYPT_VIDEO_SYNTH_H
+#define PICOCRYPT_VIDEO_SYNTH_H
+
+#include <stdint.h>
+
+#include "video_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ===== SIGNAL LEVELS (8-bit ADC codes) =====
+#define SYNTH_LEVEL_SYNC        4
+#define SYNTH_LEVEL_BLANK       64
+#define SYNTH_LEVEL_WHITE       224
+
+typedef struct {
+    double noise_stddev;            // In ADC codes, 0 = clean
+    uint32_t rng;                   // Noise generator state
+} video_synth_t;
+
+// ===== FUNCTION PROTOTYPES =====
+void video_synth_init(video_synth_t* synth, double noise_stddev, uint32_t seed);
+
+// Render one active line (0 .. VIDEO_ACTIVE_LINES-1) of a frame into
+// VIDEO_LINE_SAMPLES codes
+void video_synth_line(video_synth_t* synth, uint32_t frame, uint32_t line, uint8_t* out);
+
+// Render a VBI line: sync tip and blanking only
+void video_synth_blank_line(video_synth_t* synth, uint8_t* out);
+
+// Gaussian noise, also used for the simulated link
+double video_synth_gaussian(uint32_t* rng);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PICOCRYPT_VIDEO_SYNTH_H
@@ -3,7 +3,7 @@
  * Complete implementation for Raspberry Pi Pico (RP2040)
  * 
  * Features:
- * - Encrypted video reception
+ * - Encrypted video reception via ADC (AD9280), line-locked PIO capture
  * - Real-time decryption with Xorshift128+ PRNG
  * - Line-by-line processing with minimal latency
  * - Dual-core architecture for optimal performance
@@ -16,237 +16,173 @@
 #include "pico/multicore.h"
 #include "hardware/sync.h"
 #include "hardware/irq.h"
+#include "hardware/structs/sio.h"
+
+#include "clock_plan.h"
+#include "cpu_load.h"
+#include "crypto.h"
+#include "hal.h"
+#include "key_slots.h"
+#include "line_budget.h"
+#include "receiver.h"
+#include "sync_pulse.h"
+#include "trace.h"
+#include "video_profile.h"
 
 // ===== CONFIGURATION =====
-#define PRESHARED_KEY       0x123456789ABCDEF0ULL  // MUST match sender!
-#define VIDEO_WIDTH         720
-#define VIDEO_HEIGHT        576
+#ifndef PRESHARED_KEY
+#define PRESHARED_KEY       0x123456789ABCDEF0ULL  // MUST match sender! (blank key sector)
+#endif
+#define DAC_DATA_PIN        0           // R-2R DAC D0..D7 on GPIO 0-7
+#define ADC_DATA_PIN        9           // AD9280 D0..D7 on GPIO 9-16
+#define ADC_CLK_PIN         17          // AD9280 clock, from the clock plan
+#define SYNC_PIN            18          // Composite sync from the sync separator, active low
+#define SYNC_READ_BATCH     8           // Edge stamps classified per loop pass
 
-// ===== GLOBAL VARIABLES =====
-static uint8_t received_buffer[VIDEO_WIDTH] __attribute__((aligned(32)));
-static uint8_t decrypted_buffer[VIDEO_WIDTH] __attribute__((aligned(32)));
-static volatile bool new_frame = false;
-static volatile uint32_t line_counter = 0;
-static volatile uint32_t sync_error_count = 0;
+// Video timing comes from the compile-time profile in video_profile.h
 
-// ===== CRYPTOGRAPHY STRUCTURES =====
-typedef struct {
-    uint64_t state[2];      // Xorshift128+ state
-    uint64_t initial_seed;  // Original seed for reset
-    uint32_t sync_counter;  // Frame synchronization counter
-} prng_state_t;
+#define STATS_COMMAND       'l'         // USB CDC: print latency histograms and CPU load
+                                        // (key commands are lines: key_slots.h)
 
-static prng_state_t receiver_prng;
+// ===== GLOBAL VARIABLES =====
+// clk_sys and PIO dividers, solved and applied at boot
+static clock_plan_t clock_plan;
+// Capture/decrypt/output pipeline (LINE_POOL_DEPTH buffers in flight)
+static receiver_t receiver;
+static hal_video_in_t video_in;
+static hal_video_out_t video_out;
+static hal_line_sum_t line_sum;
+static hal_sync_in_t sync_in;
+static sync_pulse_t sync_sep;
+static volatile bool new_frame = false;
+// Busy/idle cycles per core: the line loops sleep between wake events
+static cpu_load_t cpu_load[2];
+// Key slots from flash; the image buffer must be in RAM to be written
+static key_slots_t key_slots;
+static uint8_t key_image[KEY_SLOTS_IMAGE_BYTES];
 
 // ===== FUNCTION PROTOTYPES =====
-void init_decryption(void);
-void init_r2r_dac(void);
-void init_pio_video_output(PIO pio, uint sm);
-void decrypt_line(uint8_t* input, uint8_t* output, uint length);
 void receiver_vsync_handler(void);
-void handle_sync_error(void);
-static inline uint64_t xorshift128_plus(prng_state_t* prng);
-
-// ===== DECRYPTION FUNCTIONS =====
-
-void init_decryption(void) {
-    // Initialize PRNG with same pre-shared key as sender
-    receiver_prng.state[0] = PRESHARED_KEY ^ 0xBF58476D1CE4E5B9ULL;
-    receiver_prng.state[1] = PRESHARED_KEY ^ 0x94D049BB133111EBULL;
-    receiver_prng.initial_seed = PRESHARED_KEY;
-    receiver_prng.sync_counter = 0;
-    
-    // Warm up the PRNG
-    for (int i = 0; i < 10; i++) {
-        (void)xorshift128_plus(&receiver_prng);
-    }
-}
-
-static inline uint64_t xorshift128_plus(prng_state_t* prng) {
-    uint64_t x = prng->state[0];
-    uint64_t const y = prng->state[1];
-    prng->state[0] = y;
-    x ^= x << 23;
-    x ^= x >> 17;
-    x ^= y ^ (y >> 26);
-    prng->state[1] = x;
-    return x + y;
-}
-
-void sync_decryption_on_vsync(prng_state_t* prng) {
-    // Reset PRNG to initial state - MUST match sender!
-    prng->state[0] = prng->initial_seed ^ 0xBF58476D1CE4E5B9ULL;
-    prng->state[1] = prng->initial_seed ^ 0x94D049BB133111EBULL;
-    prng->sync_counter++;
-    
-    // Warm up again
-    for (int i = 0; i < 10; i++) {
-        (void)xorshift128_plus(prng);
-    }
-}
-
-void decrypt_line(uint8_t* input, uint8_t* output, uint length) {
-    // Identical to encryption function (XOR is symmetric)
-    uint32_t* in_32 = (uint32_t*)input;
-    uint32_t* out_32 = (uint32_t*)output;
-    uint len_32 = length / 4;
-    
-    for (uint i = 0; i < len_32; i++) {
-        uint32_t keystream = (uint32_t)xorshift128_plus(&receiver_prng);
-        out_32[i] = in_32[i] ^ keystream;
-    }
-    
-    // Handle remaining bytes
-    uint remainder = length % 4;
-    if (remainder > 0) {
-        uint8_t* in_rem = input + (len_32 * 4);
-        uint8_t* out_rem = output + (len_32 * 4);
-        for (uint i = 0; i < remainder; i++) {
-            out_rem[i] = in_rem[i] ^ (uint8_t)xorshift128_plus(&receiver_prng);
-        }
-    }
-}
+void handle_vsync_output(void);
+void handle_usb_input(void);
+void run_key_command(const char* line);
+void ring_doorbell(void);
 
-// ===== R-2R DAC INITIALIZATION =====
-void init_r2r_dac(void) {
-    // Configure GPIO pins 0-7 for 8-bit R-2R DAC output
-    for (int i = 0; i < 8; i++) {
-        gpio_init(i);
-        gpio_set_dir(i, GPIO_OUT);
-        gpio_put(i, 0);
-    }
-}
-
-// ===== PIO PROGRAM FOR VIDEO OUTPUT =====
-void init_pio_video_output(PIO pio, uint sm) {
-    // PIO program for precise video timing
-    uint offset = pio_add_program(pio, &video_output_program);
-    
-    pio_sm_config c = video_output_program_get_default_config(offset);
-    
-    // Configure for 13.5MHz pixel clock
-    float div = (float)clock_get_hz(clk_sys) / 13500000.0;
-    sm_config_set_clkdiv(&c, div);
-    
-    // Set up pins for video output
-    sm_config_set_set_pins(&c, 0, 8);  // 8 pins for DAC data
-    sm_config_set_sideset_pins(&c, 8); // 1 pin for sync
-    
-    // Initialize pins
-    for (int i = 0; i < 9; i++) {
-        pio_gpio_init(pio, i);
-        gpio_set_function(i, GPIO_FUNC_PIO1);
-    }
-    
-    pio_sm_init(pio, sm, offset, &c);
-    pio_sm_set_enabled(pio, sm, true);
+// ===== INTERRUPT HANDLERS =====
+void __not_in_flash_func(receiver_vsync_handler)(void) {
+    // Restart the line count, tell core 1 the field ended
+    receiver_vsync(&receiver);
+    ring_doorbell();
 }
 
-// ===== INTERRUPT HANDLERS =====
-void receiver_vsync_handler(void) {
-    // Reset line counter
-    line_counter = 0;
-    
-    // Resynchronize decryption - CRITICAL!
-    sync_decryption_on_vsync(&receiver_prng);
-    
-    // Signal new frame
-    new_frame = true;
-    
-    // Check sync status
-    if (line_counter != 0) {
-        sync_error_count++;
-        handle_sync_error();
+// ===== INTER-CORE DOORBELL =====
+void __not_in_flash_func(ring_doorbell)(void) {
+    // If the FIFO is full, core 1 already has undrained doorbells. Plain
+    // SIO write: the SDK's push helper runs from flash.
+    if (multicore_fifo_wready()) {
+        sio_hw->fifo_wr = LINE_QUEUE_DOORBELL;
+        __sev();
     }
 }
 
-void handle_sync_error(void) {
-    // Attempt to resynchronize
-    printf("Sync error detected! Count: %d\n", sync_error_count);
+// ===== CORE 0: VIDEO INPUT =====
+void __not_in_flash_func(core0_video_input)(void) {
+    trace_event(TRACE_EV_CORE_START, 0, 0);
     
-    // Reset both PRNGs to known state
-    init_decryption();
+    // Core 1 parks this core in RAM while it writes the key sector
+    multicore_lockout_victim_init();
     
-    // Log for debugging
-    if (sync_error_count > 10) {
-        printf("WARNING: Multiple sync errors detected!\n");
-        // Could implement more aggressive resync here
-    }
-}
-
-// ===== DATA RECEPTION (Core 0) =====
-void core0_data_receiver(void) {
-    // In a real implementation, this would receive data from:
-    // - RF module (SPI/UART)
-    // - Direct cable connection
-    // - Other communication interface
+    // Sync edge timer: pulse widths in PIO ticks, classified below into
+    // line and field starts (no pin polling)
+    hal_sync_in_init(&sync_in, pio0, 0, SYNC_PIN);
+    sync_pulse_init(&sync_sep, hal_sync_in_tick_hz(&sync_in));
     
-    // For testing purposes, we'll simulate data reception
-    // In practice, replace this with actual RF communication
+    // AD9280 capture: line-locked ADC clock at the output rate, whole
+    // lines from the H-Sync tip
+    hal_video_in_init(&video_in, pio0, 1, ADC_DATA_PIN, ADC_CLK_PIN, SYNC_PIN, &clock_plan,
+                      VIDEO_LINE_SAMPLES);
     
-    printf("Receiver Core 0: Data reception started\n");
+    // Sleep between sync pulses and finished captures
+    hal_cycles_init();
+    cpu_load_init(&cpu_load[0], HAL_CYCLES_MASK, hal_cycles());
+    hal_sync_in_wake(&sync_in);
+    hal_video_in_wake(&video_in);
     
     while (true) {
-        // Wait for encrypted data from sender
-        // This would typically come from an RF module
+        uint32_t edges[SYNC_READ_BATCH];
+        uint32_t count = hal_sync_in_read(&sync_in, edges, SYNC_READ_BATCH);
+        bool busy = count > 0;
         
-        // Simulate data reception delay
-        sleep_us(10);
+        for (uint32_t i = 0; i < count; i++) {
+            sync_event_t event;
+            if (!sync_pulse_word(&sync_sep, edges[i], &event)) {
+                continue;
+            }
+            
+            // Field start before the line: queue the old field's captured
+            // lines ahead of the V-Sync
+            if (event.flags & SYNC_EVENT_FIELD) {
+                while (receiver_capture_step(&receiver)) {
+                    ring_doorbell();
+                }
+                receiver_vsync_handler();
+                if (cpu_load_field(&cpu_load[0], hal_cycles())) {
+                    trace_event(TRACE_EV_CPU_LOAD, cpu_load[0].busy_permille,
+                                cpu_load[0].peak_permille);
+                }
+            }
+            
+            // Line start: arm the capture of the next line into a free slot
+            if (event.flags & SYNC_EVENT_LINE) {
+                receiver_hsync(&receiver);
+            }
+        }
         
-        // In real implementation:
-        // uint8_t* received_data = rf_receive_packet();
-        // multicore_fifo_push_blocking((uint32_t)received_data);
+        // Hand finished captures to core 1 for decryption
+        if (receiver_capture_step(&receiver)) {
+            ring_doorbell();
+            busy = true;
+        }
         
-        // For now, just pass through the FIFO communication
-        // The actual data comes from the sender via direct connection
+        // Nothing left: sleep until the next sync pulse or capture
+        if (!busy) {
+            hal_idle(&cpu_load[0]);
+        }
     }
 }
 
 // ===== DECRYPTION & OUTPUT (Core 1) =====
-void core1_decrypt_output(void) {
-    printf("Receiver Core 1: Decryption and output started\n");
-    
-    // Initialize hardware
-    init_r2r_dac();
-    init_decryption();
+void __not_in_flash_func(core1_decrypt_output)(void) {
+    trace_event(TRACE_EV_CORE_START, 1, 0);
     
-    // PIO setup for video output
-    PIO pio = pio1;
-    uint sm = 0;
-    init_pio_video_output(pio, sm);
+    // Field descriptor chain into the R-2R DAC PIO, one sample per
+    // cycle: core 1 only swaps in lines
+    hal_video_out_init(&video_out, pio1, 0, DAC_DATA_PIN, &clock_plan);
     
-    // DMA for DAC output
-    int dac_dma_chan = dma_claim_unused_channel(true);
-    dma_channel_config c = dma_channel_get_default_config(dac_dma_chan);
-    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
-    channel_config_set_read_increment(&c, true);
-    channel_config_set_write_increment(&c, false);
-    channel_config_set_dreq(&c, DREQ_PIO1_TX0);
+    // Sleep between doorbells and finished output descriptors
+    hal_cycles_init();
+    cpu_load_init(&cpu_load[1], HAL_CYCLES_MASK, hal_cycles());
+    hal_video_out_wake(&video_out);
     
     while (true) {
-        uint32_t data = multicore_fifo_pop_blocking();
+        // Free slots whose output DMA has finished
+        receiver_retire(&receiver);
         
-        if (data == 0xFFFFFFFF) {
-            // V-Sync marker
-            receiver_vsync_handler();
+        // Doorbell from core 0: decrypt and output everything queued. Idle
+        // time streams the event trace (never blocks on USB), then sleeps.
+        if (!multicore_fifo_rvalid()) {
+            if (trace_drain() == 0) {
+                hal_idle(&cpu_load[1]);
+            }
+            continue;
+        }
+        (void)sio_hw->fifo_rd;      // Valid: plain SIO read, no flash helper
+        
+        for (uint32_t n = receiver_output_step(&receiver); n > 0; n--) {
+            new_frame = true;
             
             // Handle V-Sync output timing
             handle_vsync_output();
-        } else {
-            // Encrypted data from sender
-            uint8_t* encrypted_data = (uint8_t*)data;
-            
-            // Decrypt the line
-            decrypt_line(encrypted_data, decrypted_buffer, VIDEO_WIDTH);
-            
-            // Output decrypted data to DAC via DMA
-            dma_channel_configure(dac_dma_chan, &c,
-                &pio1_hw->txf[0], decrypted_buffer, VIDEO_WIDTH, true);
-            
-            // Wait for completion
-            dma_channel_wait_for_finish_blocking(dac_dma_chan);
-            
-            line_counter++;
         }
     }
 }
@@ -261,182 +197,131 @@ void handle_vsync_output(void) {
     
     if (last_vsync_time != 0) {
         uint32_t frame_time = current_time - last_vsync_time;
-        if (frame_time < 19000 || frame_time > 21000) {  // PAL: ~20ms
-            printf("WARNING: Irregular frame timing: %d us\n", frame_time);
+        if (frame_time < VIDEO_FIELD_PERIOD_US - VIDEO_FIELD_TOLERANCE_US ||
+            frame_time > VIDEO_FIELD_PERIOD_US + VIDEO_FIELD_TOLERANCE_US) {
+            trace_event(TRACE_EV_FIELD_TIMING, frame_time, VIDEO_FIELD_PERIOD_US);
         }
     }
     
     last_vsync_time = current_time;
-}
-
-// ===== MAIN FUNCTION =====
-int main() {
-    stdio_init_all();
-    
-    printf("PicoCrypt FPV Receiver v1.0\n");
-    printf("Pre-shared key: 0x%016llX\n", PRESHARED_KEY);
-    
-    // Initialize performance monitoring
-    init_performance_monitoring();
-    
-    // Run self-test
-    run_system_selftest();
-    
-    // Launch core 1 (decryption & output)
-    multicore_launch_core1(core1_decrypt_output);
-    
-    // Start data reception on core 0
-    core0_data_receiver();
-    
-    return 0;
-}
-
-// ===== PERFORMANCE MONITORING =====
-typedef struct {
-    uint32_t frame_count;
-    uint32_t line_count;
-    uint32_t sync_errors;
-    uint32_t max_latency_us;
-    uint32_t total_processing_time;
-} performance_stats_t;
-
-static performance_stats_t system_stats;
-
-void init_performance_monitoring(void) {
-    memset(&system_stats, 0, sizeof(system_stats));
-}
-
-void update_performance_stats(uint32_t latency_us) {
-    system_stats.line_count++;
-    system_stats.total_processing_time += latency_us;
     
-    if (latency_us > system_stats.max_latency_us) {
-        system_stats.max_latency_us = latency_us;
+    // Close this core's field; a full window goes to the trace
+    if (cpu_load_field(&cpu_load[1], hal_cycles())) {
+        trace_event(TRACE_EV_CPU_LOAD, cpu_load[1].busy_permille, cpu_load[1].peak_permille);
     }
     
-    // Report every 100 lines
-    if (system_stats.line_count % 100 == 0) {
-        uint32_t avg_latency = system_stats.total_processing_time / 100;
-        printf("Line %d: Avg latency %d us, Max %d us\n", 
-               system_stats.line_count, avg_latency, system_stats.max_latency_us);
-        system_stats.total_processing_time = 0;
-    }
+    handle_usb_input();
 }
 
-// ===== SELF-TEST FUNCTIONS =====
-void run_system_selftest(void) {
-    printf("Running PicoCrypt FPV Receiver self-test...\n");
-    
-    // Test encryption consistency
-    bool crypto_ok = test_encryption_consistency();
-    
-    // Test DAC output
-    bool dac_ok = test_dac_output();
-    
-    // Test PIO timing
-    bool pio_ok = test_pio_timing();
-    
-    // Test DMA transfer
-    bool dma_ok = test_dma_transfer();
-    
-    // Test multicore communication
-    bool multicore_ok = test_multicore_comms();
-    
-    printf("\n=== RECEIVER SELF-TEST RESULT ===\n");
-    printf("Decryption: %s\n", crypto_ok ? "OK" : "ERROR");
-    printf("DAC Output: %s\n", dac_ok ? "OK" : "ERROR");
-    printf("PIO Timing: %s\n", pio_ok ? "OK" : "ERROR");
-    printf("DMA Transfer: %s\n", dma_ok ? "OK" : "ERROR");
-    printf("Multicore Comms: %s\n", multicore_ok ? "OK" : "ERROR");
-    printf("===================================\n");
-    
-    if (crypto_ok && dac_ok && pio_ok && dma_ok && multicore_ok) {
-        printf("All tests PASSED! System ready.\n");
-    } else {
-        printf("WARNING: Some tests FAILED!\n");
+void handle_usb_input(void) {
+    // Per-stage latency histograms since the last request, on demand only.
+    // Replies are queued as trace text: stdio_usb can block on a slow
+    // host, and the drain writes only what the channel has room for.
+    static line_hist_snapshot_t since[LINE_LAT_COUNT];
+    static char line[KEY_COMMAND_MAX + 1];
+    static uint32_t length = 0;
+    static bool overflow = false;
+    int c;
+    
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+        if (c == STATS_COMMAND && length == 0) {
+            receiver_report_latency(&receiver, since);
+            cpu_load_report(cpu_load, 2, trace_printf);
+            trace_printf("bad lines %lu, concealed %lu\n", (unsigned long)receiver.lines_bad,
+                         (unsigned long)receiver.lines_concealed);
+            trace_printf("checked lines %lu, failed %lu, slips %lu, sync errors %lu\n",
+                         (unsigned long)receiver.check_lines,
+                         (unsigned long)receiver.check_errors,
+                         (unsigned long)receiver.check_slips,
+                         (unsigned long)receiver.sync_error_count);
+            trace_printf("key slot %lu, frame %lu\n", (unsigned long)rekey_slot(&receiver.rekey),
+                         (unsigned long)rekey_frame(&receiver.rekey));
+        } else if (c == '\r' || c == '\n') {
+            line[length] = '\0';
+            run_key_command(overflow ? "?" : line);
+            length = 0;
+            overflow = false;
+        } else if (length < KEY_COMMAND_MAX) {
+            line[length++] = (char)c;
+        } else {
+            overflow = true;
+        }
     }
 }
 
-bool test_encryption_consistency(void) {
-    uint8_t test_data[256];
-    uint8_t encrypted[256];
-    uint8_t decrypted[256];
-    
-    // Generate test data
-    for (int i = 0; i < 256; i++) {
-        test_data[i] = i;
-    }
-    
-    // Encrypt (simulate sender)
-    prng_state_t test_prng_sender;
-    init_prng_with_key(&test_prng_sender, PRESHARED_KEY);
-    
-    for (int i = 0; i < 256; i++) {
-        encrypted[i] = test_data[i] ^ (uint8_t)xorshift128_plus(&test_prng_sender);
+void run_key_command(const char* line) {
+    // Keys are never echoed
+    key_command_t command;
+    
+    switch (key_slots_parse_command(line, &command)) {
+    case KEY_COMMAND_SET:
+        key_slots_set(&key_slots, command.slot, &command.key);
+        trace_printf("key slot %lu set (w to keep it)\n", (unsigned long)command.slot);
+        break;
+    case KEY_COMMAND_REKEY: {
+        // Same slot and frame as the sender; core 1 owns the keystream
+        const crypto_key_t* key = key_slots_get(&key_slots, command.slot);
+        if (key && receiver_rekey(&receiver, key, command.slot, command.frame)) {
+            trace_printf("rekey to slot %lu at frame %lu\n", (unsigned long)command.slot,
+                         (unsigned long)command.frame);
+        } else {
+            trace_printf("rekey rejected: slot empty, switch pending or frame before %lu\n",
+                         (unsigned long)(rekey_frame(&receiver.rekey) + REKEY_LEAD_FRAMES));
+        }
+        break;
     }
-    
-    // Decrypt (receiver)
-    prng_state_t test_prng_receiver;
-    init_prng_with_key(&test_prng_receiver, PRESHARED_KEY);
-    
-    for (int i = 0; i < 256; i++) {
-        decrypted[i] = encrypted[i] ^ (uint8_t)xorshift128_plus(&test_prng_receiver);
+    case KEY_COMMAND_WRITE:
+        // Boot from the slot in use: a scheduled switch counts once it
+        // has happened. Stalls both cores for the sector erase: video
+        // breaks up briefly.
+        key_slots.boot_slot = rekey_slot(&receiver.rekey);
+        key_slots_save(&key_slots, key_image);
+        trace_printf("key slots %s\n", hal_key_store_write(key_image, sizeof(key_image)) ?
+                     "written" : "write FAILED");
+        break;
+    case KEY_COMMAND_ERROR:
+        trace_printf("commands: l | s <slot> <16 or 64 hex> | k <slot> <frame> | w\n");
+        break;
+    default:
+        break;
     }
-    
-    // Verify
-    bool success = (memcmp(test_data, decrypted, 256) == 0);
-    printf("Decryption consistency test: %s\n", success ? "OK" : "ERROR");
-    
-    return success;
 }
 
-bool test_dac_output(void) {
-    // Test DAC output by writing known pattern
-    for (int i = 0; i < 256; i++) {
-        // Output test pattern to DAC
-        for (int bit = 0; bit < 8; bit++) {
-            gpio_put(bit, (i >> bit) & 1);
-        }
-        sleep_us(10);
-    }
+// ===== MAIN FUNCTION =====
+int main() {
+    // Fastest jitter-free clk_sys up to SYS_CLK_KHZ; the receiver's ADC
+    // samples the link at the output rate
+    clock_plan_solve(&clock_plan, SYS_CLK_KHZ, VIDEO_SAMPLE_RATE_HZ, VIDEO_SAMPLE_RATE_HZ);
+    hal_clock_apply(&clock_plan);
     
-    printf("DAC output test: OK\n");
-    return true;
-}
-
-bool test_pio_timing(void) {
-    // Test PIO timing accuracy
-    printf("PIO timing test: OK\n");
-    return true;
-}
-
-bool test_dma_transfer(void) {
-    // Test DMA transfer functionality
-    printf("DMA transfer test: OK\n");
-    return true;
-}
-
-bool test_multicore_comms(void) {
-    // Test inter-core communication
-    multicore_fifo_push_blocking(0x12345678);
-    uint32_t result = multicore_fifo_pop_blocking();
+    stdio_init_all();
     
-    bool success = (result == 0x12345678);
-    printf("Multicore communication test: %s\n", success ? "OK" : "ERROR");
+    // Boot info goes through the trace ring: nothing here may block on a
+    // slow USB host (decode with trace_decode)
+    trace_init();
+    trace_event(TRACE_EV_BOOT, 'R', VIDEO_PROFILE);
+    trace_event(TRACE_EV_CLOCK_PLAN, clock_plan.sys_khz, clock_plan.line_cycles);
+    trace_event(TRACE_EV_CLOCK_DIVIDERS, clock_plan.pixel_div_x256,
+                clock_plan.adc_div_x256 * clock_plan.adc_cycles);
+    trace_event(TRACE_EV_CRYPTO_BUDGET, LINE_CRYPTO_CYCLES,
+                clock_plan.line_cycles * LINE_CPU_BUDGET_PERCENT / 100);
+    
+    // Key slots from flash; a blank sector runs on the build-time key
+    crypto_key_t fallback;
+    crypto_key_from_u64(&fallback, PRESHARED_KEY);
+    key_slots_load(&key_slots, hal_key_store_read(), &fallback);
+    trace_event(TRACE_EV_REKEY, 0, key_slots.boot_slot);
+    
+    // Decrypted picture sums for the line check (the DMA sniffer)
+    hal_line_sum_init(&line_sum);
+    receiver_init(&receiver, key_slots_get(&key_slots, key_slots.boot_slot), key_slots.boot_slot,
+                  VIDEO_LINE_SAMPLES, &video_in, &video_out, &line_sum);
     
-    return success;
+    // Launch core 1 (decryption & output)
+    multicore_launch_core1(core1_decrypt_output);
+    
+    // Start video input on core 0
+    core0_video_input();
+    
+    return 0;
 }
-
-// ===== PIO PROGRAMS =====
-static const uint16_t video_output_program_instructions[] = {
-    0x6008, // 0: out    pins, 8
-    0x0040, // 1: in     pins, 1
-    0x0081, // 2: jmp    pin, 1
-    0x0000, // 3: jmp    0
-};
-
-static const struct pio_program video_output_program = {
-    .instructions = video_output_program_instructions,
-    .length = 4,
-    .origin = -1,
-};
\ No newline at end of file
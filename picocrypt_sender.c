@@ -3,7 +3,7 @@
  * Complete implementation for Raspberry Pi Pico (RP2040)
  * 
  * Features:
- * - Video input via ADC (AD9280)
+ * - Video input via ADC (AD9280), line-locked PIO capture
  * - Real-time encryption with Xorshift128+ PRNG
  * - Line-by-line processing with minimal latency
  * - Dual-core architecture for optimal performance
@@ -12,316 +12,304 @@
 #include "pico/stdlib.h"
 #include "hardware/pio.h"
 #include "hardware/dma.h"
-#include "hardware/adc.h"
 #include "hardware/clocks.h"
 #include "pico/multicore.h"
+#include "pico/rand.h"
 #include "hardware/sync.h"
 #include "hardware/irq.h"
+#include "hardware/structs/sio.h"
+
+#include "clock_plan.h"
+#include "cpu_load.h"
+#include "crypto.h"
+#include "hal.h"
+#include "key_slots.h"
+#include "line_budget.h"
+#include "sender.h"
+#include "sync_pulse.h"
+#include "trace.h"
+#include "video_profile.h"
 
 // ===== CONFIGURATION =====
-#define PRESHARED_KEY       0x123456789ABCDEF0ULL  // 64-bit pre-shared key
-#define VIDEO_WIDTH         720
-#define VIDEO_HEIGHT        576
-#define SAMPLE_RATE         10000000    // 10 MS/s
-#define ADC_PIN             26          // ADC input pin
+#ifndef PRESHARED_KEY
+#define PRESHARED_KEY       0x123456789ABCDEF0ULL  // 64-bit key while the key sector is blank
+#endif
+#define DAC_DATA_PIN        0           // R-2R DAC D0..D7 on GPIO 0-7
+#define ADC_DATA_PIN        9           // AD9280 D0..D7 on GPIO 9-16
+#define ADC_CLK_PIN         17          // AD9280 clock, from the clock plan
+#define SYNC_PIN            18          // Composite sync from the sync separator, active low
+#define SYNC_READ_BATCH     8           // Edge stamps classified per loop pass
+
+// Video timing (samples per line, lines per field, sample rate) comes
+// from the compile-time profile in video_profile.h
 
-// ===== VIDEO CONSTANTS =====
-#define H_SYNC_PULSE        96      // 4.7μs at 20.25MHz
-#define H_BACK_PORCH        48      // 2.35μs
-#define H_ACTIVE_VIDEO      640     // 31.5μs  
-#define H_FRONT_PORCH       12      // 0.6μs
-#define V_SYNC_LINES        5       // 160μs
-#define V_BACK_PORCH_LINES  36      // 1.152ms
-#define V_ACTIVE_LINES      576     // 18.432ms
-#define V_FRONT_PORCH_LINES 4       // 128μs
+#define STATS_COMMAND       'l'         // USB CDC: print latency histograms and CPU load
+                                        // (key commands are lines: key_slots.h)
 
 // ===== GLOBAL VARIABLES =====
-static uint8_t video_buffer[VIDEO_WIDTH] __attribute__((aligned(32)));
-static uint8_t encrypted_buffer[VIDEO_WIDTH] __attribute__((aligned(32)));
+// clk_sys and PIO dividers, solved and applied at boot
+static clock_plan_t clock_plan;
+// Capture/encrypt/output pipeline (LINE_POOL_DEPTH buffers in flight)
+static sender_t sender;
+static hal_video_in_t video_in;
+static hal_video_out_t video_out;
+static hal_line_sum_t line_sum;
+static hal_sync_in_t sync_in;
+static sync_pulse_t sync_sep;
 static volatile bool new_frame = false;
-static volatile uint32_t line_counter = 0;
-static volatile bool h_sync_detected = false;
-static volatile bool v_sync_detected = false;
-
-// ===== CRYPTOGRAPHY STRUCTURES =====
-typedef struct {
-    uint64_t state[2];      // Xorshift128+ state
-    uint64_t initial_seed;  // Original seed for reset
-    uint32_t sync_counter;  // Frame synchronization counter
-} prng_state_t;
-
-static prng_state_t sender_prng;
+// Busy/idle cycles per core: the line loops sleep between wake events
+static cpu_load_t cpu_load[2];
+// Key slots from flash; the image buffer must be in RAM to be written
+static key_slots_t key_slots;
+static uint8_t key_image[KEY_SLOTS_IMAGE_BYTES];
+// Worst V-Sync handler time in clk_sys cycles: [0] plain, [1] switching keys
+static volatile uint32_t vsync_cycles[2];
 
 // ===== FUNCTION PROTOTYPES =====
-void init_encryption(void);
-void init_adc(void);
-void init_pio_sync(PIO pio, uint sm);
-void init_dma_adc(uint dma_chan);
-void init_r2r_dac(void);
-void init_pio_video_output(PIO pio, uint sm);
-void encrypt_line(uint8_t* input, uint8_t* output, uint length);
 void sender_vsync_handler(void);
-static inline uint64_t xorshift128_plus(prng_state_t* prng);
-
-// ===== ENCRYPTION FUNCTIONS =====
-
-void init_encryption(void) {
-    // Initialize PRNG with pre-shared key
-    sender_prng.state[0] = PRESHARED_KEY ^ 0xBF58476D1CE4E5B9ULL;
-    sender_prng.state[1] = PRESHARED_KEY ^ 0x94D049BB133111EBULL;
-    sender_prng.initial_seed = PRESHARED_KEY;
-    sender_prng.sync_counter = 0;
-    
-    // Warm up the PRNG
-    for (int i = 0; i < 10; i++) {
-        (void)xorshift128_plus(&sender_prng);
-    }
-}
-
-static inline uint64_t xorshift128_plus(prng_state_t* prng) {
-    uint64_t x = prng->state[0];
-    uint64_t const y = prng->state[1];
-    prng->state[0] = y;
-    x ^= x << 23;
-    x ^= x >> 17;
-    x ^= y ^ (y >> 26);
-    prng->state[1] = x;
-    return x + y;
-}
+void handle_vsync_output(void);
+void handle_usb_input(void);
+void run_key_command(const char* line);
+void ring_doorbell(void);
 
-void sync_encryption_on_vsync(prng_state_t* prng) {
-    // Reset PRNG to initial state
-    prng->state[0] = prng->initial_seed ^ 0xBF58476D1CE4E5B9ULL;
-    prng->state[1] = prng->initial_seed ^ 0x94D049BB133111EBULL;
-    prng->sync_counter++;
-    
-    // Optional: Slightly modify seed every 60 frames (2 seconds)
-    if (prng->sync_counter % 60 == 0) {
-        prng->initial_seed ^= 0xAAAAAAAA55555555ULL;
-    }
-    
-    // Warm up again
-    for (int i = 0; i < 10; i++) {
-        (void)xorshift128_plus(prng);
-    }
-}
-
-void encrypt_line(uint8_t* input, uint8_t* output, uint length) {
-    // Fast 32-bit XOR encryption
-    uint32_t* in_32 = (uint32_t*)input;
-    uint32_t* out_32 = (uint32_t*)output;
-    uint len_32 = length / 4;
-    
-    for (uint i = 0; i < len_32; i++) {
-        uint32_t keystream = (uint32_t)xorshift128_plus(&sender_prng);
-        out_32[i] = in_32[i] ^ keystream;
-    }
-    
-    // Handle remaining bytes
-    uint remainder = length % 4;
-    if (remainder > 0) {
-        uint8_t* in_rem = input + (len_32 * 4);
-        uint8_t* out_rem = output + (len_32 * 4);
-        for (uint i = 0; i < remainder; i++) {
-            out_rem[i] = in_rem[i] ^ (uint8_t)xorshift128_plus(&sender_prng);
-        }
+// ===== INTERRUPT HANDLERS =====
+void __not_in_flash_func(sender_vsync_handler)(void) {
+    // Resync keystream, refill it during V-blanking, tell core 1. Timed:
+    // a key switch must cost no more than a plain V-Sync.
+    uint32_t switches = sender.rekey.switches;
+    uint32_t start = hal_cycles();
+    sender_vsync(&sender);
+    uint32_t cycles = (hal_cycles() - start) & HAL_CYCLES_MASK;
+    uint32_t kind = sender.rekey.switches != switches;
+    if (cycles > vsync_cycles[kind]) {
+        vsync_cycles[kind] = cycles;
     }
-}
-
-// ===== ADC INITIALIZATION =====
-void init_adc(void) {
-    adc_init();
-    adc_gpio_init(ADC_PIN);
-    adc_select_input(0);  // ADC channel 0
-    adc_set_clkdiv(0);    // Maximum speed
-    
-    // Power on ADC
-    adc_hw->cs = ADC_CS_EN_BITS | ADC_CS_TS_EN_BITS;
-    adc_hw->cs = ADC_CS_EN_BITS;  // Disable temperature sensor
-}
-
-// ===== PIO PROGRAM FOR SYNC DETECTION =====
-void init_pio_sync(PIO pio, uint sm) {
-    // Simple PIO program to detect H-Sync pulses
-    uint offset = pio_add_program(pio, &video_sync_detect_program);
+    ring_doorbell();
     
-    pio_sm_config c = video_sync_detect_program_get_default_config(offset);
-    
-    // Configure GPIO for sync input
-    pio_gpio_init(pio, ADC_PIN);
-    gpio_set_function(ADC_PIN, GPIO_FUNC_PIO0);
-    
-    sm_config_set_in_pins(&c, ADC_PIN);
-    sm_config_set_jmp_pin(&c, ADC_PIN);
-    
-    pio_sm_init(pio, sm, offset, &c);
-    pio_sm_set_enabled(pio, sm, true);
-    
-    // Enable interrupts
-    pio_set_irqn_source_enabled(pio, 0, pis_interrupt0, true);
-    pio_set_irqn_source_enabled(pio, 1, pis_interrupt1, true);
-}
-
-// ===== DMA INITIALIZATION FOR ADC =====
-void init_dma_adc(uint dma_chan) {
-    dma_channel_config c = dma_channel_get_default_config(dma_chan);
-    
-    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
-    channel_config_set_read_increment(&c, false);   // ADC FIFO is fixed
-    channel_config_set_write_increment(&c, true);   // Buffer address increment
-    channel_config_set_dreq(&c, DREQ_ADC);
-    
-    // Configure for ring buffer if needed
-    channel_config_set_ring(&c, true, 0);  // Ring buffer on write
-}
-
-// ===== R-2R DAC INITIALIZATION =====
-void init_r2r_dac(void) {
-    // Configure GPIO pins for R-2R DAC output
-    // Using GPIO pins 0-7 for 8-bit DAC
-    for (int i = 0; i < 8; i++) {
-        gpio_init(i);
-        gpio_set_dir(i, GPIO_OUT);
-        gpio_put(i, 0);
-    }
+    // Signal new frame
+    new_frame = true;
 }
 
-// ===== PIO PROGRAM FOR VIDEO OUTPUT =====
-void init_pio_video_output(PIO pio, uint sm) {
-    // PIO program for precise video timing
-    uint offset = pio_add_program(pio, &video_output_program);
-    
-    pio_sm_config c = video_output_program_get_default_config(offset);
-    
-    // Configure for 13.5MHz pixel clock
-    float div = (float)clock_get_hz(clk_sys) / 13500000.0;
-    sm_config_set_clkdiv(&c, div);
-    
-    // Set up pins for video output
-    sm_config_set_set_pins(&c, 0, 8);  // 8 pins for DAC data
-    sm_config_set_sideset_pins(&c, 8); // 1 pin for sync
-    
-    // Initialize pins
-    for (int i = 0; i < 9; i++) {
-        pio_gpio_init(pio, i);
-        gpio_set_function(i, GPIO_FUNC_PIO1);
+// ===== INTER-CORE DOORBELL =====
+void __not_in_flash_func(ring_doorbell)(void) {
+    // If the FIFO is full, core 1 already has undrained doorbells. Plain
+    // SIO write: the SDK's push helper runs from flash.
+    if (multicore_fifo_wready()) {
+        sio_hw->fifo_wr = LINE_QUEUE_DOORBELL;
+        __sev();
     }
-    
-    pio_sm_init(pio, sm, offset, &c);
-    pio_sm_set_enabled(pio, sm, true);
 }
 
-// ===== INTERRUPT HANDLERS =====
-void sender_vsync_handler(void) {
-    // Reset line counter
-    line_counter = 0;
+// ===== CORE 0: VIDEO INPUT =====
+void __not_in_flash_func(core0_video_input)(void) {
+    trace_event(TRACE_EV_CORE_START, 0, 0);
     
-    // Resynchronize encryption
-    sync_encryption_on_vsync(&sender_prng);
+    // Core 1 parks this core in RAM while it writes the key sector
+    multicore_lockout_victim_init();
     
-    // Signal new frame
-    new_frame = true;
-    v_sync_detected = true;
-    
-    // Send V-Sync marker to core 1
-    multicore_fifo_push_blocking(0xFFFFFFFF);  // VSYNC marker
-}
-
-// ===== CORE 0: VIDEO INPUT =====
-void core0_video_input(void) {
-    // Initialize hardware
-    init_adc();
-    init_encryption();
+    // Sync edge timer: pulse widths in PIO ticks, classified below into
+    // line and field starts (no pin polling)
+    hal_sync_in_init(&sync_in, pio0, 0, SYNC_PIN);
+    sync_pulse_init(&sync_sep, hal_sync_in_tick_hz(&sync_in));
     
-    // PIO setup
-    PIO pio = pio0;
-    uint sm = 0;
-    init_pio_sync(pio, sm);
+    // AD9280 capture: line-locked ADC clock, lines at the ADC rate
+    hal_video_in_init(&video_in, pio0, 1, ADC_DATA_PIN, ADC_CLK_PIN, SYNC_PIN, &clock_plan,
+                      VIDEO_CAPTURE_SAMPLES);
     
-    // DMA setup
-    int adc_dma_chan = dma_claim_unused_channel(true);
-    init_dma_adc(adc_dma_chan);
+    // Sleep between sync pulses and finished captures
+    hal_cycles_init();
+    cpu_load_init(&cpu_load[0], HAL_CYCLES_MASK, hal_cycles());
+    hal_sync_in_wake(&sync_in);
+    hal_video_in_wake(&video_in);
     
     while (true) {
-        // Wait for H-Sync
-        if (h_sync_detected) {
-            h_sync_detected = false;
-            
-            // Start ADC DMA transfer for one line
-            dma_channel_configure(adc_dma_chan, 
-                dma_channel_get_default_config(adc_dma_chan),
-                video_buffer, &adc_hw->fifo, VIDEO_WIDTH, true);
-            
-            // Wait for DMA completion
-            dma_channel_wait_for_finish_blocking(adc_dma_chan);
-            
-            // Encrypt the line
-            encrypt_line(video_buffer, encrypted_buffer, VIDEO_WIDTH);
+        uint32_t edges[SYNC_READ_BATCH];
+        uint32_t count = hal_sync_in_read(&sync_in, edges, SYNC_READ_BATCH);
+        bool busy = count > 0;
+        
+        for (uint32_t i = 0; i < count; i++) {
+            sync_event_t event;
+            if (!sync_pulse_word(&sync_sep, edges[i], &event)) {
+                continue;
+            }
             
-            // Send to core 1
-            multicore_fifo_push_blocking((uint32_t)encrypted_buffer);
+            // Field start before the line: V-Sync restarts the line count.
+            // Lines already captured still belong to the old field.
+            if (event.flags & SYNC_EVENT_FIELD) {
+                while (sender_capture_step(&sender)) {
+                    ring_doorbell();
+                }
+                sender_vsync_handler();
+                if (cpu_load_field(&cpu_load[0], hal_cycles())) {
+                    trace_event(TRACE_EV_CPU_LOAD, cpu_load[0].busy_permille,
+                                cpu_load[0].peak_permille);
+                }
+            }
             
-            line_counter++;
+            // Line start: arm the capture of the next line into a free
+            // slot. It runs in the background while lines are encrypted.
+            if (event.flags & SYNC_EVENT_LINE) {
+                sender_hsync(&sender);
+            }
+        }
+        
+        // Encrypt the oldest captured line in place and hand it to core 1
+        if (sender_capture_step(&sender)) {
+            ring_doorbell();
+            busy = true;
         }
         
-        // Handle V-Sync
-        if (v_sync_detected) {
-            sender_vsync_handler();
-            v_sync_detected = false;
+        // Nothing left: sleep until the next sync pulse or capture
+        if (!busy) {
+            hal_idle(&cpu_load[0]);
         }
     }
 }
 
 // ===== CORE 1: VIDEO OUTPUT =====
-void core1_video_output(void) {
-    // Initialize R-2R DAC
-    init_r2r_dac();
+void __not_in_flash_func(core1_video_output)(void) {
+    trace_event(TRACE_EV_CORE_START, 1, 0);
     
-    // PIO setup for video output
-    PIO pio = pio1;
-    uint sm = 0;
-    init_pio_video_output(pio, sm);
+    // Field descriptor chain into the R-2R DAC PIO, one sample per
+    // cycle: core 1 only swaps in lines
+    hal_video_out_init(&video_out, pio1, 0, DAC_DATA_PIN, &clock_plan);
     
-    // DMA for DAC output
-    int dac_dma_chan = dma_claim_unused_channel(true);
-    dma_channel_config c = dma_channel_get_default_config(dac_dma_chan);
-    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
-    channel_config_set_read_increment(&c, true);
-    channel_config_set_write_increment(&c, false);
-    channel_config_set_dreq(&c, DREQ_PIO1_TX0);
+    // Sleep between doorbells and finished output descriptors
+    hal_cycles_init();
+    cpu_load_init(&cpu_load[1], HAL_CYCLES_MASK, hal_cycles());
+    hal_video_out_wake(&video_out);
     
     while (true) {
-        uint32_t data = multicore_fifo_pop_blocking();
+        // Free slots whose output DMA has finished
+        sender_retire(&sender);
+        
+        // Doorbell from core 0: output everything queued. Idle time
+        // streams the event trace (never blocks on USB), then sleeps.
+        if (!multicore_fifo_rvalid()) {
+            if (trace_drain() == 0) {
+                hal_idle(&cpu_load[1]);
+            }
+            continue;
+        }
+        (void)sio_hw->fifo_rd;      // Valid: plain SIO read, no flash helper
         
-        if (data == 0xFFFFFFFF) {
-            // V-Sync marker
+        for (uint32_t n = sender_output_step(&sender); n > 0; n--) {
             handle_vsync_output();
+        }
+    }
+}
+
+void handle_vsync_output(void) {
+    // Close this core's field; a full window goes to the trace
+    if (cpu_load_field(&cpu_load[1], hal_cycles())) {
+        trace_event(TRACE_EV_CPU_LOAD, cpu_load[1].busy_permille, cpu_load[1].peak_permille);
+    }
+    
+    handle_usb_input();
+}
+
+void handle_usb_input(void) {
+    // Per-stage latency histograms since the last request, on demand only.
+    // Replies are queued as trace text: stdio_usb can block on a slow
+    // host, and the drain writes only what the channel has room for.
+    static line_hist_snapshot_t since[LINE_LAT_COUNT];
+    static char line[KEY_COMMAND_MAX + 1];
+    static uint32_t length = 0;
+    static bool overflow = false;
+    int c;
+    
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+        if (c == STATS_COMMAND && length == 0) {
+            sender_report_latency(&sender, since);
+            cpu_load_report(cpu_load, 2, trace_printf);
+            trace_printf("key slot %lu, frame %lu; V-Sync worst %lu cycles, %lu switching keys\n",
+                         (unsigned long)rekey_slot(&sender.rekey),
+                         (unsigned long)rekey_frame(&sender.rekey), (unsigned long)vsync_cycles[0],
+                         (unsigned long)vsync_cycles[1]);
+        } else if (c == '\r' || c == '\n') {
+            line[length] = '\0';
+            run_key_command(overflow ? "?" : line);
+            length = 0;
+            overflow = false;
+        } else if (length < KEY_COMMAND_MAX) {
+            line[length++] = (char)c;
         } else {
-            // Encrypted data from core 0
-            uint8_t* encrypted_data = (uint8_t*)data;
-            
-            // Output directly to DAC via DMA
-            dma_channel_configure(dac_dma_chan, &c,
-                &pio1_hw->txf[0], encrypted_data, VIDEO_WIDTH, true);
-            
-            // Wait for completion before processing next line
-            dma_channel_wait_for_finish_blocking(dac_dma_chan);
+            overflow = true;
         }
     }
 }
 
+void run_key_command(const char* line) {
+    // Keys are never echoed
+    key_command_t command;
+    
+    switch (key_slots_parse_command(line, &command)) {
+    case KEY_COMMAND_SET:
+        key_slots_set(&key_slots, command.slot, &command.key);
+        trace_printf("key slot %lu set (w to keep it)\n", (unsigned long)command.slot);
+        break;
+    case KEY_COMMAND_REKEY: {
+        // Both units need the same slot and frame
+        const crypto_key_t* key = key_slots_get(&key_slots, command.slot);
+        if (key && sender_rekey(&sender, key, command.slot, command.frame)) {
+            trace_printf("rekey to slot %lu at frame %lu\n", (unsigned long)command.slot,
+                         (unsigned long)command.frame);
+        } else {
+            trace_printf("rekey rejected: slot empty, switch pending or frame before %lu\n",
+                         (unsigned long)(rekey_frame(&sender.rekey) + REKEY_LEAD_FRAMES));
+        }
+        break;
+    }
+    case KEY_COMMAND_WRITE:
+        // Boot from the slot in use: a scheduled switch counts once it
+        // has happened. Stalls both cores for the sector erase: video
+        // breaks up briefly.
+        key_slots.boot_slot = rekey_slot(&sender.rekey);
+        key_slots_save(&key_slots, key_image);
+        trace_printf("key slots %s\n", hal_key_store_write(key_image, sizeof(key_image)) ?
+                     "written" : "write FAILED");
+        break;
+    case KEY_COMMAND_ERROR:
+        trace_printf("commands: l | s <slot> <16 or 64 hex> | k <slot> <frame> | w\n");
+        break;
+    default:
+        break;
+    }
+}
+
 // ===== MAIN FUNCTION =====
 int main() {
-    stdio_init_all();
-    
-    printf("PicoCrypt FPV Sender v1.0\n");
-    printf("Pre-shared key: 0x%016llX\n", PRESHARED_KEY);
+    // Fastest jitter-free clk_sys up to SYS_CLK_KHZ, before anything
+    // derives a rate from it
+    clock_plan_solve(&clock_plan, SYS_CLK_KHZ, VIDEO_SAMPLE_RATE_HZ, VIDEO_ADC_RATE_HZ);
+    hal_clock_apply(&clock_plan);
     
-    // Initialize performance monitoring
-    init_performance_monitoring();
+    stdio_init_all();
     
-    // Run self-test
-    run_system_selftest();
+    // Boot info goes through the trace ring: nothing here may block on a
+    // slow USB host (decode with trace_decode)
+    trace_init();
+    trace_event(TRACE_EV_BOOT, 'S', VIDEO_PROFILE);
+    trace_event(TRACE_EV_CLOCK_PLAN, clock_plan.sys_khz, clock_plan.line_cycles);
+    trace_event(TRACE_EV_CLOCK_DIVIDERS, clock_plan.pixel_div_x256,
+                clock_plan.adc_div_x256 * clock_plan.adc_cycles);
+    trace_event(TRACE_EV_CRYPTO_BUDGET, LINE_CRYPTO_CYCLES,
+                clock_plan.line_cycles * LINE_CPU_BUDGET_PERCENT / 100);
+    
+    // Key slots from flash; a blank sector runs on the build-time key
+    crypto_key_t fallback;
+    crypto_key_from_u64(&fallback, PRESHARED_KEY);
+    key_slots_load(&key_slots, hal_key_store_read(), &fallback);
+    
+    // A fresh frame on every power-up, or the keystream of the last one
+    // repeats (the receiver follows through the VBI code)
+    uint32_t first_frame = get_rand_32();
+    trace_event(TRACE_EV_REKEY, first_frame, key_slots.boot_slot);
+    
+    // Plaintext picture sums for the line check (the DMA sniffer)
+    hal_line_sum_init(&line_sum);
+    sender_init(&sender, key_slots_get(&key_slots, key_slots.boot_slot), key_slots.boot_slot,
+                first_frame, VIDEO_LINE_SAMPLES, &video_in, &video_out, &line_sum);
     
     // Launch core 1
     multicore_launch_core1(core1_video_output);
@@ -331,36 +319,3 @@ int main() {
     
     return 0;
 }
-
-// ===== PIO PROGRAMS (would be in separate .pio file) =====
-static const uint16_t video_sync_detect_program_instructions[] = {
-    0x0080, // 0: jmp    pin, 0
-    0x0040, // 1: in     pins, 1
-    0x0041, // 2: in     x, 1
-    0x0080, // 3: jmp    pin, 0
-    0x80a0, // 4: push   block
-    0x0001, // 5: jmp    1
-};
-
-static const struct pio_program video_sync_detect_program = {
-    .instructions = video_sync_detect_program_instructions,
-    .length = 6,
-    .origin = -1,
-};
-
-static const uint16_t video_output_program_instructions[] = {
-    0x6001, // 0: out    pins, 1
-    0x6001, // 1: out    pins, 1
-    0x6001, // 2: out    pins, 1
-    0x6001, // 3: out    pins, 1
-    0x6001, // 4: out    pins, 1
-    0x6001, // 5: out    pins, 1
-    0x6001, // 6: out    pins, 1
-    0x6001, // 7: out    pins, 1
-};
-
-static const struct pio_program video_output_program = {
-    .instructions = video_output_program_instructions,
-    .length = 8,
-    .origin = -1,
-};
\ No newline at end of file
@@ -0,0 +1,149 @@
+/*
+ * PicoCrypt FPV - ChaCha Backend
+ * ChaCha8/12 in counter mode, tuned for the Cortex-M0+
+ *
+ * Input block: "expand 32-byte k" | 256-bit key | block counter | frame |
+ * line | 0. The block counter is the sample index / 64 within the line, so
+ * every (frame, line, sample) has its own keystream and seeking is O(1).
+ *
+ * The block function runs from SRAM (no XIP cache misses in the line loop)
+ * and keeps the state in 16 locals with fully unrolled quarter-rounds; the
+ * M0+ has single-cycle RORS, so every rotate is one instruction.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "crypto.h"
+#include "platform.h"
+
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_CHACHA
+
+// ===== CONFIGURATION =====
+#define CHACHA_CONST_0      0x61707865u     // "expa"
+#define CHACHA_CONST_1      0x3320646eu     // "nd 3"
+#define CHACHA_CONST_2      0x79622d32u     // "2-by"
+#define CHACHA_CONST_3      0x6b206574u     // "te k"
+
+#define CHACHA_COUNTER      12
+#define CHACHA_NONCE_FRAME  13
+#define CHACHA_NONCE_LINE   14
+#define CHACHA_NONCE_DOMAIN 15
+
+// ===== BLOCK FUNCTION =====
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define QUARTER_ROUND(a, b, c, d)               \
+    a += b; d ^= a; d = ROTL32(d, 16);          \
+    c += d; b ^= c; b = ROTL32(b, 12);          \
+    a += b; d ^= a; d = ROTL32(d, 8);           \
+    c += d; b ^= c; b = ROTL32(b, 7)
+
+void PICOCRYPT_RAM_FUNC(chacha_block)(uint32_t output[16], const uint32_t input[16]) {
+    uint32_t x0 = input[0],   x1 = input[1],   x2 = input[2],   x3 = input[3];
+    uint32_t x4 = input[4],   x5 = input[5],   x6 = input[6],   x7 = input[7];
+    uint32_t x8 = input[8],   x9 = input[9],   x10 = input[10], x11 = input[11];
+    uint32_t x12 = input[12], x13 = input[13], x14 = input[14], x15 = input[15];
+
+    for (int i = 0; i < CHACHA_ROUNDS; i += 2) {
+        // Column round
+        QUARTER_ROUND(x0, x4, x8,  x12);
+        QUARTER_ROUND(x1, x5, x9,  x13);
+        QUARTER_ROUND(x2, x6, x10, x14);
+        QUARTER_ROUND(x3, x7, x11, x15);
+        // Diagonal round
+        QUARTER_ROUND(x0, x5, x10, x15);
+        QUARTER_ROUND(x1, x6, x11, x12);
+        QUARTER_ROUND(x2, x7, x8,  x13);
+        QUARTER_ROUND(x3, x4, x9,  x14);
+    }
+
+    output[0]  = x0  + input[0];  output[1]  = x1  + input[1];
+    output[2]  = x2  + input[2];  output[3]  = x3  + input[3];
+    output[4]  = x4  + input[4];  output[5]  = x5  + input[5];
+    output[6]  = x6  + input[6];  output[7]  = x7  + input[7];
+    output[8]  = x8  + input[8];  output[9]  = x9  + input[9];
+    output[10] = x10 + input[10]; output[11] = x11 + input[11];
+    output[12] = x12 + input[12]; output[13] = x13 + input[13];
+    output[14] = x14 + input[14]; output[15] = x15 + input[15];
+}
+
+// ===== KEYING AND POSITION =====
+
+void crypto_init_key(prng_state_t* prng, const crypto_key_t* key) {
+    prng->input[0] = CHACHA_CONST_0;
+    prng->input[1] = CHACHA_CONST_1;
+    prng->input[2] = CHACHA_CONST_2;
+    prng->input[3] = CHACHA_CONST_3;
+    for (int i = 0; i < CRYPTO_KEY_WORDS; i++) {
+        prng->input[4 + i] = key->words[i];
+    }
+    prng->input[CHACHA_COUNTER] = 0;
+    prng->input[CHACHA_NONCE_DOMAIN] = 0;
+    crypto_seek(prng, 0, 0, 0);
+}
+
+void PICOCRYPT_RAM_FUNC(crypto_resync)(prng_state_t* prng) {
+    crypto_seek(prng, prng->sync_counter + 1, 0, 0);
+}
+
+void PICOCRYPT_RAM_FUNC(crypto_seek)(prng_state_t* prng, uint32_t frame, uint32_t line, uint32_t sample) {
+    prng->sync_counter = frame;
+    prng->line = line;
+    prng->sample = sample;
+    prng->input[CHACHA_NONCE_FRAME] = frame;
+    prng->input[CHACHA_NONCE_LINE] = line;
+}
+
+// ===== LINE CIPHER =====
+
+static void PICOCRYPT_RAM_FUNC(chacha_line)(prng_state_t* prng, const uint8_t* input,
+                                            uint8_t* output, size_t length) {
+    uint32_t ks[16];
+    uint32_t phase = prng->sample % CRYPTO_WORD_BYTES;
+    size_t done = 0;
+
+    prng->input[CHACHA_COUNTER] = prng->sample / CRYPTO_WORD_BYTES;
+
+    while (done < length) {
+        chacha_block(ks, prng->input);
+        prng->input[CHACHA_COUNTER]++;
+
+        size_t n = CRYPTO_WORD_BYTES - phase;
+        if (n > length - done) {
+            n = length - done;
+        }
+
+        const uint8_t* in = input ? input + done : NULL;
+        uint8_t* out = output + done;
+
+        if (n == CRYPTO_WORD_BYTES && (((uintptr_t)in | (uintptr_t)out) & 3) == 0) {
+            // Whole aligned block: 16 word XORs
+            for (int i = 0; i < 16; i++) {
+                ((uint32_t*)out)[i] = (in ? ((const uint32_t*)in)[i] : 0) ^ ks[i];
+            }
+        } else {
+            const uint8_t* ks_bytes = (const uint8_t*)ks;     // Little-endian
+            for (size_t b = 0; b < n; b++) {
+                out[b] = (in ? in[b] : 0) ^ ks_bytes[phase + b];
+            }
+        }
+
+        done += n;
+        phase = 0;
+    }
+
+    // Next line
+    crypto_seek(prng, prng->sync_counter, prng->line + 1, 0);
+}
+
+void PICOCRYPT_RAM_FUNC(crypto_xor_line)(prng_state_t* prng, const uint8_t* input,
+                                         uint8_t* output, size_t length) {
+    chacha_line(prng, input, output, length);
+}
+
+void PICOCRYPT_RAM_FUNC(crypto_keystream_line)(prng_state_t* prng, uint8_t* keystream, size_t length) {
+    chacha_line(prng, NULL, keystream, length);
+}
+
+#endif // CRYPTO_BACKEND_CHACHA
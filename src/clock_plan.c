@@ -0,0 +1,107 @@
+/*
+ * PicoCrypt FPV - Clock Plan
+ */
+
+#include "clock_plan.h"
+
+// Validated core voltage per clk_sys: stock up to 200 MHz, then a step
+// per 50 MHz of overclock
+static uint16_t voltage_for(uint32_t sys_khz) {
+    if (sys_khz <= 200000) {
+        return 1100;
+    }
+    if (sys_khz <= 250000) {
+        return 1150;
+    }
+    return 1200;
+}
+
+// 16.8 divider from clk_sys to `hz` per `cycles`, rounded to nearest
+static uint32_t divider_x256(uint32_t sys_khz, uint32_t hz, uint32_t cycles) {
+    uint64_t den = (uint64_t)hz * cycles;
+    return (uint32_t)(((uint64_t)sys_khz * 1000 * 256 + den / 2) / den);
+}
+
+// ADC clock: whole clk_sys cycles per ADC period, split into the fewest
+// PIO cycles at an integer divider. Otherwise a fractional divider on the
+// shortest loop.
+static void plan_adc(clock_plan_t* plan, uint32_t adc_hz) {
+    uint64_t sys_hz = (uint64_t)plan->sys_khz * 1000;
+
+    if (sys_hz % adc_hz == 0) {
+        uint32_t period = (uint32_t)(sys_hz / adc_hz);
+        for (uint32_t div = 1; period >= 2 * div; div++) {
+            if (period % div == 0 && period / div <= CLOCK_PLAN_ADC_MAX_CYCLES) {
+                plan->adc_div_x256 = div << 8;
+                plan->adc_cycles = (uint8_t)(period / div);
+                plan->adc_exact = true;
+                return;
+            }
+        }
+    }
+    plan->adc_cycles = 2;
+    plan->adc_div_x256 = divider_x256(plan->sys_khz, adc_hz, 2);
+    plan->adc_exact = false;
+}
+
+static uint32_t plan_score(const clock_plan_t* plan) {
+    return (plan->pixel_exact ? 2u : 0u) + (plan->adc_exact ? 1u : 0u);
+}
+
+// Higher score, then faster clk_sys, then the faster VCO (lower PLL jitter)
+static bool plan_better(const clock_plan_t* a, const clock_plan_t* b) {
+    if (plan_score(a) != plan_score(b)) {
+        return plan_score(a) > plan_score(b);
+    }
+    if (a->sys_khz != b->sys_khz) {
+        return a->sys_khz > b->sys_khz;
+    }
+    return a->vco_khz > b->vco_khz;
+}
+
+bool clock_plan_solve(clock_plan_t* plan, uint32_t max_khz, uint32_t pixel_hz, uint32_t adc_hz) {
+    uint64_t pixel_cycle_hz = (uint64_t)pixel_hz * VIDEO_PIO_CYCLES_PER_SAMPLE;
+    clock_plan_t best = { 0 };
+    bool found = false;
+
+    for (uint32_t pd1 = 1; pd1 <= CLOCK_PLAN_POSTDIV_MAX; pd1++) {
+        for (uint32_t pd2 = 1; pd2 <= pd1; pd2++) {
+            for (uint32_t fb = CLOCK_PLAN_FBDIV_MIN; fb <= CLOCK_PLAN_FBDIV_MAX; fb++) {
+                uint32_t vco = CLOCK_PLAN_XOSC_KHZ * fb;
+                if (vco < CLOCK_PLAN_VCO_MIN_KHZ || vco > CLOCK_PLAN_VCO_MAX_KHZ ||
+                    vco % (pd1 * pd2) != 0) {
+                    continue;
+                }
+                uint32_t sys = vco / (pd1 * pd2);
+                uint64_t sys_hz = (uint64_t)sys * 1000;
+                if (sys > max_khz || sys_hz < pixel_cycle_hz) {
+                    continue;
+                }
+
+                clock_plan_t c = { 0 };
+                c.sys_khz = sys;
+                c.vco_khz = vco;
+                c.fbdiv = (uint16_t)fb;
+                c.postdiv1 = (uint8_t)pd1;
+                c.postdiv2 = (uint8_t)pd2;
+                c.pixel_exact = sys_hz % pixel_cycle_hz == 0;
+                plan_adc(&c, adc_hz);
+                if (!found || plan_better(&c, &best)) {
+                    best = c;
+                    found = true;
+                }
+            }
+        }
+    }
+    if (!found) {
+        return false;
+    }
+
+    best.voltage_mv = voltage_for(best.sys_khz);
+    best.pixel_div_x256 = divider_x256(best.sys_khz, pixel_hz, VIDEO_PIO_CYCLES_PER_SAMPLE);
+    best.sync_tick_hz = (uint32_t)((uint64_t)best.sys_khz * 1000 / CLOCK_PLAN_SYNC_TICK_CYCLES);
+    best.line_cycles = (uint32_t)((uint64_t)best.sys_khz * 1000 * VIDEO_LINE_SAMPLES /
+                                  VIDEO_SAMPLE_RATE_HZ);
+    *plan = best;
+    return true;
+}
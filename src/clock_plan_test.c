@@ -0,0 +1,119 @@
+/*
+ * PicoCrypt FPV - Clock Plan Test (host)
+ * PLL limits, divider exactness and the chosen plans for the build's video
+ * profile, sender (ADC at VIDEO_ADC_RATE_HZ) and receiver (ADC at the
+ * sample rate)
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "clock_plan.h"
+
+// ===== CONFIGURATION =====
+static const uint32_t limits_khz[] = { 125000, 133000, 200000, 250000, SYS_CLK_KHZ };
+#define LIMIT_COUNT     (sizeof(limits_khz) / sizeof(limits_khz[0]))
+
+static int failures = 0;
+
+static void check(bool ok, const char* name) {
+    printf("%-40s %s\n", name, ok ? "OK" : "ERROR");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// PLL within the RP2040 limits, dividers consistent with their flags
+static bool plan_valid(const clock_plan_t* p, uint32_t max_khz, uint32_t adc_hz) {
+    uint64_t sys_hz = (uint64_t)p->sys_khz * 1000;
+    bool ok = true;
+
+    ok &= p->vco_khz == CLOCK_PLAN_XOSC_KHZ * p->fbdiv;
+    ok &= p->vco_khz >= CLOCK_PLAN_VCO_MIN_KHZ && p->vco_khz <= CLOCK_PLAN_VCO_MAX_KHZ;
+    ok &= p->fbdiv >= CLOCK_PLAN_FBDIV_MIN && p->fbdiv <= CLOCK_PLAN_FBDIV_MAX;
+    ok &= p->postdiv2 >= 1 && p->postdiv2 <= p->postdiv1 &&
+          p->postdiv1 <= CLOCK_PLAN_POSTDIV_MAX;
+    ok &= p->sys_khz * p->postdiv1 * p->postdiv2 == p->vco_khz;
+    ok &= p->sys_khz <= max_khz;
+    ok &= p->pixel_div_x256 >= 256;
+
+    if (p->pixel_exact) {
+        ok &= p->pixel_div_x256 % 256 == 0;
+        ok &= (p->pixel_div_x256 >> 8) * (uint64_t)VIDEO_SAMPLE_RATE_HZ *
+              VIDEO_PIO_CYCLES_PER_SAMPLE == sys_hz;
+    }
+    ok &= p->adc_cycles >= 2 && p->adc_cycles <= CLOCK_PLAN_ADC_MAX_CYCLES;
+    if (p->adc_exact) {
+        ok &= p->adc_div_x256 % 256 == 0;
+        ok &= (p->adc_div_x256 >> 8) * (uint64_t)p->adc_cycles * adc_hz == sys_hz;
+    }
+    ok &= p->line_cycles == sys_hz * VIDEO_LINE_SAMPLES / VIDEO_SAMPLE_RATE_HZ;
+    return ok;
+}
+
+static void print_plan(const char* role, uint32_t max_khz, const clock_plan_t* p) {
+    printf("%-8s %7.1f  %7.2f  %4u  %u/%u  %4.2f V  %6.2f %-5s  %3u x %6.2f %-5s  %6u\n",
+           role, max_khz / 1000.0, p->sys_khz / 1000.0, p->vco_khz / 1000,
+           p->postdiv1, p->postdiv2, p->voltage_mv / 1000.0,
+           p->pixel_div_x256 / 256.0, p->pixel_exact ? "exact" : "dith",
+           p->adc_cycles, p->adc_div_x256 / 256.0, p->adc_exact ? "exact" : "dith",
+           p->line_cycles);
+}
+
+// ===== TESTS =====
+static bool test_limits(const char* role, uint32_t adc_hz) {
+    bool ok = true;
+
+    for (uint32_t i = 0; i < LIMIT_COUNT; i++) {
+        clock_plan_t p;
+        if (!clock_plan_solve(&p, limits_khz[i], VIDEO_SAMPLE_RATE_HZ, adc_hz)) {
+            ok = false;
+            continue;
+        }
+        print_plan(role, limits_khz[i], &p);
+        ok &= plan_valid(&p, limits_khz[i], adc_hz);
+        // Every stock-voltage limit here has an integer pixel divider
+        ok &= p.pixel_exact;
+    }
+    return ok;
+}
+
+static bool test_overclock(uint32_t adc_hz) {
+    clock_plan_t p;
+
+    // 270 MHz: both clocks exact, at 1.2 V
+    if (!clock_plan_solve(&p, 270000, VIDEO_SAMPLE_RATE_HZ, adc_hz)) {
+        return false;
+    }
+    return p.sys_khz == 270000 && p.pixel_exact && p.adc_exact && p.voltage_mv == 1200 &&
+           p.sync_tick_hz == 270000000 / CLOCK_PLAN_SYNC_TICK_CYCLES;
+}
+
+static bool test_unreachable(void) {
+    clock_plan_t p = { .sys_khz = 1 };
+
+    // Below the pixel clock: no plan, plan untouched
+    return !clock_plan_solve(&p, VIDEO_SAMPLE_RATE_HZ / 1000 - 1, VIDEO_SAMPLE_RATE_HZ,
+                             VIDEO_ADC_RATE_HZ) && p.sys_khz == 1;
+}
+
+int main(void) {
+    printf("Clock plan: %s, pixel %.3f MHz, sender ADC %.3f MHz, limit %u kHz\n\n",
+           VIDEO_PROFILE_NAME, VIDEO_SAMPLE_RATE_HZ / 1e6, VIDEO_ADC_RATE_HZ / 1e6,
+           SYS_CLK_KHZ);
+    printf("role     max MHz  clk_sys  VCO   post  core    pixel div     ADC cycles x div  "
+           "cycles/line\n");
+
+    bool sender_ok = test_limits("sender", VIDEO_ADC_RATE_HZ);
+    bool receiver_ok = test_limits("receiver", VIDEO_SAMPLE_RATE_HZ);
+    printf("\n");
+
+    check(sender_ok, "Sender plans valid, pixel exact");
+    check(receiver_ok, "Receiver plans valid, pixel exact");
+    check(test_overclock(VIDEO_ADC_RATE_HZ), "Sender 270 MHz: both clocks exact");
+    check(test_overclock(VIDEO_SAMPLE_RATE_HZ), "Receiver 270 MHz: both clocks exact");
+    check(test_unreachable(), "Limit below the pixel clock rejected");
+
+    printf("\n%s\n", failures ? "FAILED" : "All tests passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * PicoCrypt FPV - CPU Load
+ */
+
+#include "cpu_load.h"
+#include "platform.h"
+
+// 32-bit only: no 64-bit division helper on the line path
+static uint32_t PICOCRYPT_RAM_FUNC(permille)(uint32_t part, uint32_t total) {
+    uint32_t unit = total / 1000;
+    uint32_t value = unit ? part / unit : 0;
+    return value < 1000 ? value : 1000;
+}
+
+// Cycles since the last transition, into the bucket of the state left
+static void PICOCRYPT_RAM_FUNC(account)(cpu_load_t* load, uint32_t now) {
+    uint32_t elapsed = (now - load->last) & load->mask;
+
+    if (load->sleeping) {
+        load->idle += elapsed;
+    } else {
+        load->busy += elapsed;
+    }
+    load->last = now;
+}
+
+void cpu_load_init(cpu_load_t* load, uint32_t mask, uint32_t now) {
+    load->mask = mask;
+    load->last = now;
+    load->sleeping = false;
+    load->busy = 0;
+    load->idle = 0;
+    load->window_busy = 0;
+    load->window_total = 0;
+    load->window_peak = 0;
+    load->fields = 0;
+    load->wakeups = 0;
+    atomic_store_explicit(&load->busy_permille, 0, memory_order_relaxed);
+    atomic_store_explicit(&load->peak_permille, 0, memory_order_relaxed);
+}
+
+void PICOCRYPT_RAM_FUNC(cpu_load_sleep)(cpu_load_t* load, uint32_t now) {
+    account(load, now);
+    load->sleeping = true;
+}
+
+void PICOCRYPT_RAM_FUNC(cpu_load_wake)(cpu_load_t* load, uint32_t now) {
+    account(load, now);
+    load->sleeping = false;
+    load->wakeups++;
+}
+
+bool PICOCRYPT_RAM_FUNC(cpu_load_field)(cpu_load_t* load, uint32_t now) {
+    account(load, now);
+
+    uint32_t field_peak = permille(load->busy, load->busy + load->idle);
+    if (field_peak > load->window_peak) {
+        load->window_peak = field_peak;
+    }
+    load->window_busy += load->busy;
+    load->window_total += load->busy + load->idle;
+    load->busy = 0;
+    load->idle = 0;
+    if (++load->fields < CPU_LOAD_WINDOW_FIELDS) {
+        return false;
+    }
+
+    atomic_store_explicit(&load->busy_permille, permille(load->window_busy, load->window_total),
+                          memory_order_relaxed);
+    atomic_store_explicit(&load->peak_permille, load->window_peak, memory_order_relaxed);
+    load->window_busy = 0;
+    load->window_total = 0;
+    load->window_peak = 0;
+    load->fields = 0;
+    return true;
+}
+
+void cpu_load_report(const cpu_load_t loads[], uint32_t cores,
+                     bool (*print)(const char* format, ...)) {
+    print("%-8s %6s %6s %8s  (%%, window %d fields)\n", "core", "busy", "peak", "wakeups",
+          CPU_LOAD_WINDOW_FIELDS);
+    for (uint32_t c = 0; c < cores; c++) {
+        uint32_t busy = atomic_load_explicit(&loads[c].busy_permille, memory_order_relaxed);
+        uint32_t peak = atomic_load_explicit(&loads[c].peak_permille, memory_order_relaxed);
+
+        print("%-8lu %4lu.%lu %4lu.%lu %8lu\n", (unsigned long)c,
+              (unsigned long)(busy / 10), (unsigned long)(busy % 10),
+              (unsigned long)(peak / 10), (unsigned long)(peak % 10),
+              (unsigned long)loads[c].wakeups);
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * PicoCrypt FPV - CPU Load Test (host)
+ * Busy/idle accounting across counter wraps and per-window publication
+ *
+ * Drives the accounting with a simulated 24-bit cycle counter (the
+ * RP2040's SysTick range): fields of a known busy share must come out at
+ * that share, across many counter wraps, and the busiest field of a
+ * window must be reported as its peak.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "cpu_load.h"
+
+// ===== CONFIGURATION =====
+#define COUNTER_MASK        0x00FFFFFFu     // 24-bit SysTick
+#define LINE_CYCLES         17280           // PAL line at 270 MHz
+#define FIELD_LINES         312
+
+static int failures = 0;
+
+static void check(bool ok, const char* name) {
+    printf("%-40s %s\n", name, ok ? "OK" : "ERROR");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// One field of lines, each `busy` cycles of work then a sleep
+static uint32_t run_field(cpu_load_t* load, uint32_t now, uint32_t busy) {
+    for (uint32_t line = 0; line < FIELD_LINES; line++) {
+        now += busy;
+        cpu_load_sleep(load, now & COUNTER_MASK);
+        now += LINE_CYCLES - busy;
+        cpu_load_wake(load, now & COUNTER_MASK);
+    }
+    return now;
+}
+
+// ===== TESTS =====
+static bool test_share(void) {
+    cpu_load_t load;
+    uint32_t now = COUNTER_MASK - 1000;         // Wraps in the first line
+    bool ok = true;
+
+    cpu_load_init(&load, COUNTER_MASK, now);
+    for (uint32_t f = 0; f < CPU_LOAD_WINDOW_FIELDS; f++) {
+        now = run_field(&load, now, LINE_CYCLES / 4);
+        bool published = cpu_load_field(&load, now & COUNTER_MASK);
+        ok &= published == (f == CPU_LOAD_WINDOW_FIELDS - 1);
+    }
+
+    uint32_t busy = atomic_load(&load.busy_permille);
+    uint32_t peak = atomic_load(&load.peak_permille);
+    printf("  25%% busy: %u.%u%%, peak %u.%u%%, %u wakeups\n", busy / 10, busy % 10,
+           peak / 10, peak % 10, load.wakeups);
+    ok &= busy >= 249 && busy <= 250;
+    ok &= peak >= 249 && peak <= 250;
+    ok &= load.wakeups == CPU_LOAD_WINDOW_FIELDS * FIELD_LINES;
+    return ok;
+}
+
+static bool test_peak(void) {
+    cpu_load_t load;
+    uint32_t now = 0;
+    bool ok = true;
+
+    // One field at 90%, the rest at 10%
+    cpu_load_init(&load, COUNTER_MASK, now);
+    for (uint32_t f = 0; f < CPU_LOAD_WINDOW_FIELDS; f++) {
+        uint32_t busy = f == 7 ? LINE_CYCLES * 9 / 10 : LINE_CYCLES / 10;
+        now = run_field(&load, now, busy);
+        cpu_load_field(&load, now & COUNTER_MASK);
+    }
+
+    uint32_t busy = atomic_load(&load.busy_permille);
+    uint32_t peak = atomic_load(&load.peak_permille);
+    uint32_t expect = (100 * (CPU_LOAD_WINDOW_FIELDS - 1) + 900) / CPU_LOAD_WINDOW_FIELDS;
+    printf("  one busy field: %u.%u%%, peak %u.%u%%\n", busy / 10, busy % 10,
+           peak / 10, peak % 10);
+    ok &= busy + 1 >= expect && busy <= expect;
+    ok &= peak >= 899 && peak <= 900;
+    return ok;
+}
+
+static bool test_idle_core(void) {
+    cpu_load_t load;
+    bool ok = true;
+
+    // Asleep all window long: woken only by the field event
+    cpu_load_init(&load, COUNTER_MASK, 0);
+    cpu_load_sleep(&load, 10);
+    uint32_t now = 10;
+    for (uint32_t f = 0; f < CPU_LOAD_WINDOW_FIELDS; f++) {
+        now += FIELD_LINES * LINE_CYCLES / 4;
+        cpu_load_wake(&load, now & COUNTER_MASK);
+        now += 10;
+        cpu_load_field(&load, now & COUNTER_MASK);
+        cpu_load_sleep(&load, now & COUNTER_MASK);
+    }
+    ok &= atomic_load(&load.busy_permille) == 0;
+    return ok;
+}
+
+int main(void) {
+    printf("CPU load accounting test (24-bit counter)\n\n");
+
+    check(test_share(), "Busy share across counter wraps");
+    check(test_peak(), "Busiest field as window peak");
+    check(test_idle_core(), "Sleeping core reads idle");
+
+    printf("\n%s\n", failures ? "FAILED" : "All tests passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,231 @@
+/*
+ * PicoCrypt FPV - Crypto Core
+ * Key handling, multi-lane Xorshift128+ backend and buffer XOR shared by
+ * sender and receiver. The ChaCha backend lives in chacha.c.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "crypto.h"
+#include "platform.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Keystream byte order assumes a little-endian target"
+#endif
+
+// ===== MIXING =====
+
+static inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * CRYPTO_SEED_MIX_0;
+    z = (z ^ (z >> 27)) * CRYPTO_SEED_MIX_1;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t splitmix64(uint64_t* x) {
+    *x += CRYPTO_LANE_STRIDE;
+    return mix64(*x);
+}
+
+// ===== KEYS =====
+
+void crypto_key_from_u64(crypto_key_t* key, uint64_t key64) {
+    uint64_t x = key64;
+
+    key->words[0] = (uint32_t)key64;
+    key->words[1] = (uint32_t)(key64 >> 32);
+    for (int i = 2; i < CRYPTO_KEY_WORDS; i += 2) {
+        uint64_t w = splitmix64(&x);
+        key->words[i] = (uint32_t)w;
+        key->words[i + 1] = (uint32_t)(w >> 32);
+    }
+}
+
+void crypto_init(prng_state_t* prng, uint64_t key64) {
+    crypto_key_t key;
+    crypto_key_from_u64(&key, key64);
+    crypto_init_key(prng, &key);
+}
+
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_XORSHIFT
+
+// ===== XORSHIFT SEEDING =====
+
+// Lane states for one line, derived from (key, frame, line)
+static void PICOCRYPT_RAM_FUNC(crypto_seed_line)(prng_state_t* prng, uint32_t frame, uint32_t line) {
+    uint64_t x = mix64(prng->initial_seed ^ mix64(((uint64_t)frame << 32) | line));
+
+    for (int lane = 0; lane < CRYPTO_LANES; lane++) {
+        prng->state[lane][0] = splitmix64(&x);
+        prng->state[lane][1] = splitmix64(&x) | 1;     // Never all-zero
+    }
+}
+
+void crypto_init_key(prng_state_t* prng, const crypto_key_t* key) {
+    // Every key word counts: a mix64 chain over the 64-bit halves. Off
+    // the V-Sync path (rekey.h), so the cost does not matter.
+    uint64_t seed = 0;
+    for (int i = 0; i < CRYPTO_KEY_WORDS; i += 2) {
+        seed = mix64(seed ^ ((uint64_t)key->words[i] | ((uint64_t)key->words[i + 1] << 32)));
+    }
+    prng->initial_seed = seed;
+    crypto_seek(prng, 0, 0, 0);
+}
+
+void PICOCRYPT_RAM_FUNC(crypto_resync)(prng_state_t* prng) {
+    crypto_seek(prng, prng->sync_counter + 1, 0, 0);
+}
+
+void PICOCRYPT_RAM_FUNC(crypto_seek)(prng_state_t* prng, uint32_t frame, uint32_t line, uint32_t sample) {
+    prng->sync_counter = frame;
+    prng->line = line;
+    prng->sample = sample;
+    crypto_seed_line(prng, frame, line);
+}
+
+// ===== LINE KERNEL =====
+
+// XOR (or, with input == NULL, store) one 64-bit keystream word.
+// Aligned buffers use two 32-bit accesses; the M0+ has no unaligned loads.
+static inline __attribute__((always_inline))
+void apply_word(const uint8_t* input, uint8_t* output, uint64_t ks, bool aligned) {
+    uint32_t lo = (uint32_t)ks;
+    uint32_t hi = (uint32_t)(ks >> 32);
+
+    if (aligned) {
+        if (input) {
+            lo ^= ((const uint32_t*)input)[0];
+            hi ^= ((const uint32_t*)input)[1];
+        }
+        ((uint32_t*)output)[0] = lo;
+        ((uint32_t*)output)[1] = hi;
+    } else {
+        uint32_t in[2] = {0, 0};
+        if (input) {
+            memcpy(in, input, 8);
+        }
+        in[0] ^= lo;
+        in[1] ^= hi;
+        memcpy(output, in, 8);
+    }
+}
+
+// Interleaved lanes have no dependency on each other, so each group of
+// CRYPTO_LANES words can issue in parallel.
+static inline __attribute__((always_inline))
+void line_kernel(prng_state_t* prng, const uint8_t* input, uint8_t* output,
+                 size_t length, bool aligned) {
+    size_t words = length / CRYPTO_WORD_BYTES;
+    size_t i = 0;
+
+    for (; i + CRYPTO_LANES <= words; i += CRYPTO_LANES) {
+        uint64_t ks[CRYPTO_LANES];
+        for (int lane = 0; lane < CRYPTO_LANES; lane++) {
+            ks[lane] = xorshift128_plus_lane(prng->state[lane]);
+        }
+        for (int lane = 0; lane < CRYPTO_LANES; lane++) {
+            size_t offset = (i + lane) * CRYPTO_WORD_BYTES;
+            apply_word(input ? input + offset : NULL, output + offset, ks[lane], aligned);
+        }
+    }
+
+    int lane = 0;
+    for (; i < words; i++, lane++) {
+        size_t offset = i * CRYPTO_WORD_BYTES;
+        uint64_t ks = xorshift128_plus_lane(prng->state[lane]);
+        apply_word(input ? input + offset : NULL, output + offset, ks, aligned);
+    }
+
+    // Partial last word: low bytes first
+    size_t offset = words * CRYPTO_WORD_BYTES;
+    if (offset < length) {
+        uint64_t ks = xorshift128_plus_lane(prng->state[lane]);
+        for (size_t b = 0; offset + b < length; b++) {
+            uint8_t in = input ? input[offset + b] : 0;
+            output[offset + b] = in ^ (uint8_t)(ks >> (8 * b));
+        }
+    }
+}
+
+// Line starting mid-way after a seek: skip to the sample, then finish the
+// partial word and any lanes out of step bytewise before the word kernel.
+static void PICOCRYPT_RAM_FUNC(line_from_sample)(prng_state_t* prng, const uint8_t* input,
+                                                 uint8_t* output, size_t length, uint32_t sample) {
+    uint32_t word = sample / CRYPTO_WORD_BYTES;
+    uint32_t phase = sample % CRYPTO_WORD_BYTES;
+    size_t done = 0;
+
+    for (uint32_t i = 0; i < word; i++) {
+        (void)xorshift128_plus_lane(prng->state[i % CRYPTO_LANES]);
+    }
+
+    while (done < length && (phase != 0 || word % CRYPTO_LANES != 0)) {
+        uint64_t ks = xorshift128_plus_lane(prng->state[word % CRYPTO_LANES]);
+        for (; phase < CRYPTO_WORD_BYTES && done < length; phase++, done++) {
+            uint8_t in = input ? input[done] : 0;
+            output[done] = in ^ (uint8_t)(ks >> (8 * phase));
+        }
+        phase = 0;
+        word++;
+    }
+
+    input = input ? input + done : NULL;
+    output += done;
+    if ((((uintptr_t)input | (uintptr_t)output) & 3) == 0) {
+        line_kernel(prng, input, output, length - done, true);
+    } else {
+        line_kernel(prng, input, output, length - done, false);
+    }
+}
+
+// ===== LINE CIPHER =====
+
+static void PICOCRYPT_RAM_FUNC(crypto_line)(prng_state_t* prng, const uint8_t* input,
+                                            uint8_t* output, size_t length) {
+    if (prng->sample != 0) {
+        line_from_sample(prng, input, output, length, prng->sample);
+    } else if ((((uintptr_t)input | (uintptr_t)output) & 3) == 0) {
+        line_kernel(prng, input, output, length, true);
+    } else {
+        line_kernel(prng, input, output, length, false);
+    }
+
+    // Next line
+    crypto_seek(prng, prng->sync_counter, prng->line + 1, 0);
+}
+
+void PICOCRYPT_RAM_FUNC(crypto_xor_line)(prng_state_t* prng, const uint8_t* input,
+                                         uint8_t* output, size_t length) {
+    crypto_line(prng, input, output, length);
+}
+
+void PICOCRYPT_RAM_FUNC(crypto_keystream_line)(prng_state_t* prng, uint8_t* keystream, size_t length) {
+    crypto_line(prng, NULL, keystream, length);
+}
+
+#endif // CRYPTO_BACKEND_XORSHIFT
+
+// ===== BUFFER XOR =====
+
+void PICOCRYPT_RAM_FUNC(crypto_xor_buffers)(const uint8_t* input, const uint8_t* keystream,
+                                            uint8_t* output, size_t length) {
+    size_t len_32 = length / 4;
+
+    if ((((uintptr_t)input | (uintptr_t)keystream | (uintptr_t)output) & 3) == 0) {
+        const uint32_t* in_32 = (const uint32_t*)input;
+        const uint32_t* ks_32 = (const uint32_t*)keystream;
+        uint32_t* out_32 = (uint32_t*)output;
+
+        for (size_t i = 0; i < len_32; i++) {
+            out_32[i] = in_32[i] ^ ks_32[i];
+        }
+    } else {
+        for (size_t i = 0; i < len_32 * 4; i++) {
+            output[i] = input[i] ^ keystream[i];
+        }
+    }
+
+    for (size_t i = len_32 * 4; i < length; i++) {
+        output[i] = input[i] ^ keystream[i];
+    }
+}
@@ -0,0 +1,173 @@
+/*
+ * PicoCrypt FPV - Crypto Benchmark (host)
+ * Per-line keystream cost against the 64 us PAL line budget
+ *
+ * Usage: crypto_bench [lines]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "crypto.h"
+#include "keystream.h"
+
+// ===== CONFIGURATION =====
+#define BENCH_KEY           0x123456789ABCDEF0ULL
+#define BENCH_LINES         200000      // Lines per measurement
+#define LINE_BUDGET_NS      64000.0     // PAL line period: 64 us
+#define MAX_WIDTH           768
+
+static const unsigned bench_widths[] = { 640, 720, 768 };
+
+static uint8_t input_buffer[MAX_WIDTH + 8] __attribute__((aligned(32)));
+static uint8_t output_buffer[MAX_WIDTH + 8] __attribute__((aligned(32)));
+static keystream_ring_t bench_ring;
+
+// ===== TIMING =====
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// ===== BENCHMARK =====
+static void bench_line(unsigned width, unsigned offset, unsigned lines) {
+    prng_state_t prng;
+    crypto_init(&prng, BENCH_KEY);
+
+    const uint8_t* in = input_buffer + offset;
+    uint8_t* out = output_buffer + offset;
+    volatile uint8_t sink = 0;
+
+    // Warm caches and branch predictors
+    for (unsigned i = 0; i < 1000; i++) {
+        crypto_xor_line(&prng, in, out, width);
+    }
+
+    double start = now_ns();
+    for (unsigned i = 0; i < lines; i++) {
+        crypto_xor_line(&prng, in, out, width);
+        sink ^= out[i % width];
+    }
+    double elapsed = now_ns() - start;
+    (void)sink;
+
+    double ns_per_line = elapsed / lines;
+    double ns_per_byte = ns_per_line / width;
+    double lines_per_sec = 1e9 / ns_per_line;
+    double headroom = 100.0 * (LINE_BUDGET_NS - ns_per_line) / LINE_BUDGET_NS;
+
+    printf("%5u  %-9s  %9.3f  %10.1f  %12.0f  %7.2f%%\n",
+           width, offset ? "unaligned" : "aligned",
+           ns_per_byte, ns_per_line, lines_per_sec, headroom);
+}
+
+// Active-video cost only: keystream prefetched in "blanking" (untimed)
+static void bench_prefetched(unsigned width, unsigned lines) {
+    prng_state_t prng;
+    crypto_init(&prng, BENCH_KEY);
+    keystream_ring_init(&bench_ring, width, 0);
+
+    const uint8_t* in = input_buffer;
+    uint8_t* out = output_buffer;
+    volatile uint8_t sink = 0;
+    double fused = 0.0, prefetched = 0.0;
+
+    for (unsigned done = 0; done < lines; done += KEYSTREAM_RING_LINES) {
+        double start = now_ns();
+        for (unsigned i = 0; i < KEYSTREAM_RING_LINES; i++) {
+            crypto_xor_line(&prng, in, out, width);
+        }
+        fused += now_ns() - start;
+        sink ^= out[done % width];
+
+        keystream_prefetch(&bench_ring, &prng, KEYSTREAM_RING_LINES);
+        start = now_ns();
+        for (unsigned i = 0; i < KEYSTREAM_RING_LINES; i++) {
+            keystream_xor_line(&bench_ring, in, out, width, NULL);
+        }
+        prefetched += now_ns() - start;
+        sink ^= out[done % width];
+    }
+    (void)sink;
+
+    fused /= lines;
+    prefetched /= lines;
+    printf("%5u  %12.1f  %15.1f  %8.1f%%\n", width, fused, prefetched,
+           100.0 * (fused - prefetched) / fused);
+}
+
+// Relock cost: seek to an arbitrary frame/line, then generate the rest of
+// that line from the given sample
+static void bench_seek(unsigned width, unsigned sample, unsigned lines) {
+    prng_state_t prng;
+    crypto_init(&prng, BENCH_KEY);
+    volatile uint32_t sink = 0;
+
+    double start = now_ns();
+    for (unsigned i = 0; i < lines; i++) {
+        crypto_seek(&prng, i * 2654435761u, i % 625, sample);
+        sink ^= prng.line;
+    }
+    double seek_only = (now_ns() - start) / lines;
+
+    start = now_ns();
+    for (unsigned i = 0; i < lines; i++) {
+        crypto_seek(&prng, i * 2654435761u, i % 625, sample);
+        crypto_xor_line(&prng, input_buffer, output_buffer, width - sample);
+        sink ^= output_buffer[0];
+    }
+    double seek_line = (now_ns() - start) / lines;
+    (void)sink;
+
+    printf("%5u  %6u  %10.1f  %16.1f\n", width, sample, seek_only, seek_line);
+}
+
+int main(int argc, char** argv) {
+    unsigned lines = BENCH_LINES;
+    if (argc > 1) {
+        lines = (unsigned)strtoul(argv[1], NULL, 0);
+        if (lines == 0) {
+            fprintf(stderr, "usage: %s [lines]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    for (unsigned i = 0; i < sizeof(input_buffer); i++) {
+        input_buffer[i] = (uint8_t)(i * 7);
+    }
+
+    printf("PicoCrypt FPV crypto benchmark (%u lines per run)\n", lines);
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_CHACHA
+    printf("Keystream: ChaCha%d, %zu blocks per 720-sample line\n",
+           CHACHA_ROUNDS, crypto_words_per_line(720));
+#else
+    printf("Keystream: Xorshift128+, %d lane(s), %zu PRNG calls per 720-sample line\n",
+           CRYPTO_LANES, crypto_words_per_line(720));
+#endif
+    printf("width  buffer     ns/byte     ns/line     lines/sec  headroom\n");
+
+    for (unsigned w = 0; w < sizeof(bench_widths) / sizeof(bench_widths[0]); w++) {
+        bench_line(bench_widths[w], 0, lines);
+        bench_line(bench_widths[w], 1, lines);
+    }
+
+    printf("headroom = share of the %.0f us PAL line left after the cipher\n",
+           LINE_BUDGET_NS / 1000.0);
+
+    printf("\nActive-video cost per line (keystream prefetched in blanking)\n");
+    printf("width  fused ns/line  prefetched ns/line  saved\n");
+    for (unsigned w = 0; w < sizeof(bench_widths) / sizeof(bench_widths[0]); w++) {
+        // Ring is sized for the build's video profile
+        if (bench_widths[w] <= KEYSTREAM_MAX_WIDTH) {
+            bench_prefetched(bench_widths[w], lines);
+        }
+    }
+
+    printf("\nKeystream seek (frame, line, sample)\n");
+    printf("width  sample  seek ns/op  seek+rest ns/line\n");
+    bench_seek(720, 0, lines);
+    bench_seek(720, 361, lines);
+    return 0;
+}
@@ -0,0 +1,291 @@
+/*
+ * PicoCrypt FPV - Crypto Test
+ * Runs on the host (ctest) and on the Pico (USB stdio)
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "crypto.h"
+#include "keystream.h"
+
+#ifdef LIB_PICO_STDLIB
+#include "pico/stdlib.h"
+#endif
+
+// ===== CONFIGURATION =====
+#define TEST_KEY        0x123456789ABCDEF0ULL
+#define TEST_WIDTH      723     // Not a multiple of 4: exercises the tail
+#define RING_WIDTH      (KEYSTREAM_MAX_WIDTH - 1)   // Ring is sized per profile
+
+static int failures = 0;
+
+static void check(bool ok, const char* name) {
+    printf("%-40s %s\n", name, ok ? "OK" : "ERROR");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// ===== TESTS =====
+
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_CHACHA
+
+// Keystream layout: block counter = sample / 64, nonce = (frame, line, 0)
+static bool test_reference_layout(void) {
+    uint8_t plain[TEST_WIDTH], cipher[TEST_WIDTH];
+    uint32_t input[16], block[16];
+    crypto_key_t key;
+    prng_state_t prng;
+
+    for (int i = 0; i < TEST_WIDTH; i++) {
+        plain[i] = (uint8_t)i;
+    }
+    crypto_key_from_u64(&key, TEST_KEY);
+    crypto_init_key(&prng, &key);
+    crypto_seek(&prng, 7, 42, 0);
+    crypto_xor_line(&prng, plain, cipher, TEST_WIDTH);
+
+    input[0] = 0x61707865u; input[1] = 0x3320646eu;
+    input[2] = 0x79622d32u; input[3] = 0x6b206574u;
+    memcpy(&input[4], key.words, sizeof(key.words));
+    input[13] = 7;
+    input[14] = 42;
+    input[15] = 0;
+
+    for (int i = 0; i < TEST_WIDTH; i++) {
+        if (i % 64 == 0) {
+            input[12] = (uint32_t)(i / 64);
+            chacha_block(block, input);
+        }
+        uint8_t ks = (uint8_t)(block[(i % 64) / 4] >> (8 * (i % 4)));
+        if (cipher[i] != (uint8_t)(plain[i] ^ ks)) {
+            return false;
+        }
+    }
+    return prng.line == 43;
+}
+
+#if CHACHA_ROUNDS == 20
+// RFC 8439 section 2.3.2 block function test vector
+static bool test_rfc8439_block(void) {
+    static const uint32_t expected[16] = {
+        0xe4e7f110, 0x15593bd1, 0x1fdd0f50, 0xc47120a3,
+        0xc7f4d1c7, 0x0368c033, 0x9aaa2204, 0x4e6cd4c3,
+        0x466482d2, 0x09aa9f07, 0x05d7c214, 0xa2028bd9,
+        0xd19c12b5, 0xb94e16de, 0xe883d0cb, 0x4e3c50a2,
+    };
+    uint32_t input[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        0x03020100, 0x07060504, 0x0b0a0908, 0x0f0e0d0c,
+        0x13121110, 0x17161514, 0x1b1a1918, 0x1f1e1d1c,
+        0x00000001, 0x09000000, 0x4a000000, 0x00000000,
+    };
+    uint32_t output[16];
+
+    chacha_block(output, input);
+    return memcmp(output, expected, sizeof(expected)) == 0;
+}
+#endif
+
+#else
+
+// Keystream layout: 64-bit word i from lane i % CRYPTO_LANES, applied
+// little-endian; the partial last word contributes its low bytes
+static bool test_reference_layout(void) {
+    uint8_t plain[TEST_WIDTH], cipher[TEST_WIDTH];
+    prng_state_t prng, ref;
+
+    for (int i = 0; i < TEST_WIDTH; i++) {
+        plain[i] = (uint8_t)i;
+    }
+    crypto_init(&prng, TEST_KEY);
+    crypto_init(&ref, TEST_KEY);
+    crypto_xor_line(&prng, plain, cipher, TEST_WIDTH);
+
+    for (int i = 0; i < TEST_WIDTH; i += 8) {
+        uint64_t ks = xorshift128_plus_lane(ref.state[(i / 8) % CRYPTO_LANES]);
+        for (int b = 0; b < 8 && i + b < TEST_WIDTH; b++) {
+            if (cipher[i + b] != (uint8_t)(plain[i + b] ^ (ks >> (8 * b)))) {
+                return false;
+            }
+        }
+    }
+    return prng.line == 1;
+}
+
+#endif // CRYPTO_BACKEND
+
+// Keys that differ only in words 2-7 (a 256-bit slot key past its first
+// 16 hex digits) must give different keystreams
+static bool test_full_key(void) {
+    uint8_t a[TEST_WIDTH], b[TEST_WIDTH];
+    crypto_key_t key;
+    prng_state_t prng;
+    bool ok = true;
+
+    crypto_key_from_u64(&key, TEST_KEY);
+    crypto_init_key(&prng, &key);
+    crypto_keystream_line(&prng, a, TEST_WIDTH);
+    for (int w = 2; w < CRYPTO_KEY_WORDS; w++) {
+        crypto_key_t changed = key;
+        changed.words[w] ^= 1u << (w * 5 % 32);
+        crypto_init_key(&prng, &changed);
+        crypto_keystream_line(&prng, b, TEST_WIDTH);
+        ok &= memcmp(a, b, TEST_WIDTH) != 0;
+    }
+    return ok;
+}
+
+static bool test_roundtrip_unaligned(void) {
+    static uint8_t plain[TEST_WIDTH + 3], cipher[TEST_WIDTH + 3],
+                   aligned[TEST_WIDTH], decrypted[TEST_WIDTH + 3];
+    prng_state_t tx, rx, ref;
+
+    for (int i = 0; i < TEST_WIDTH + 3; i++) {
+        plain[i] = (uint8_t)(i * 13);
+    }
+    crypto_init(&tx, TEST_KEY);
+    crypto_init(&rx, TEST_KEY);
+    crypto_init(&ref, TEST_KEY);
+
+    crypto_xor_line(&tx, plain + 1, cipher + 3, TEST_WIDTH);
+    crypto_xor_line(&ref, plain + 1, aligned, TEST_WIDTH);
+    crypto_xor_line(&rx, cipher + 3, decrypted + 2, TEST_WIDTH);
+
+    return memcmp(cipher + 3, aligned, TEST_WIDTH) == 0 &&
+           memcmp(decrypted + 2, plain + 1, TEST_WIDTH) == 0;
+}
+
+static bool test_in_place(void) {
+    uint8_t line[TEST_WIDTH], copy[TEST_WIDTH];
+    prng_state_t tx, rx;
+
+    for (int i = 0; i < TEST_WIDTH; i++) {
+        line[i] = copy[i] = (uint8_t)(255 - i);
+    }
+    crypto_init(&tx, TEST_KEY);
+    crypto_init(&rx, TEST_KEY);
+    crypto_xor_line(&tx, line, line, TEST_WIDTH);
+    bool changed = memcmp(line, copy, TEST_WIDTH) != 0;
+    crypto_xor_line(&rx, line, line, TEST_WIDTH);
+
+    return changed && memcmp(line, copy, TEST_WIDTH) == 0;
+}
+
+// V-Sync moves to line 0 of the next frame; every frame gets fresh keystream
+static bool test_resync(void) {
+    uint8_t zero[64] = {0}, first[64], second[64], again[64];
+    prng_state_t prng;
+
+    crypto_init(&prng, TEST_KEY);
+    crypto_xor_line(&prng, zero, first, sizeof(first));
+    crypto_resync(&prng);
+    bool position = prng.sync_counter == 1 && prng.line == 0;
+    crypto_xor_line(&prng, zero, second, sizeof(second));
+    crypto_seek(&prng, 0, 0, 0);
+    crypto_xor_line(&prng, zero, again, sizeof(again));
+
+    return position && memcmp(first, second, sizeof(first)) != 0 &&
+           memcmp(first, again, sizeof(first)) == 0;
+}
+
+// seek(frame, line, sample) followed by generation must match sequential
+// generation bit-for-bit, for sample offsets on and off word/lane boundaries
+static bool test_seek(void) {
+    enum { FRAMES = 3, LINES = 8 };
+    static uint8_t sequential[FRAMES][LINES][TEST_WIDTH];
+    static const uint32_t samples[] = { 0, 1, 7, 8, 13, 16, 64, 361, 720, 722 };
+    uint8_t seeked[TEST_WIDTH];
+    prng_state_t prng;
+
+    crypto_init(&prng, TEST_KEY);
+    for (int f = 0; f < FRAMES; f++) {
+        if (f > 0) {
+            crypto_resync(&prng);
+        }
+        for (int l = 0; l < LINES; l++) {
+            crypto_keystream_line(&prng, sequential[f][l], TEST_WIDTH);
+        }
+    }
+
+    for (int f = FRAMES - 1; f >= 0; f--) {
+        for (int l = LINES - 1; l >= 0; l--) {
+            for (size_t k = 0; k < sizeof(samples) / sizeof(samples[0]); k++) {
+                uint32_t s = samples[k];
+                crypto_seek(&prng, f, l, s);
+                crypto_keystream_line(&prng, seeked + (s & 3), TEST_WIDTH - s);
+                if (memcmp(seeked + (s & 3), &sequential[f][l][s], TEST_WIDTH - s) != 0) {
+                    return false;
+                }
+                // Generation continues with the following line
+                if (l + 1 < LINES) {
+                    crypto_keystream_line(&prng, seeked, TEST_WIDTH);
+                    if (memcmp(seeked, sequential[f][l + 1], TEST_WIDTH) != 0) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Prefetched lines must match the fused cipher, including across a V-Sync
+// reset and a ring underrun
+static bool test_keystream_ring(void) {
+    static keystream_ring_t ring;
+    uint8_t plain[TEST_WIDTH], fused[TEST_WIDTH], ringed[TEST_WIDTH];
+    prng_state_t ref, prng;
+
+    for (int i = 0; i < TEST_WIDTH; i++) {
+        plain[i] = (uint8_t)(i ^ 0x5A);
+    }
+    crypto_init(&ref, TEST_KEY);
+    crypto_init(&prng, TEST_KEY);
+    keystream_ring_init(&ring, RING_WIDTH, 0);
+
+    for (int line = 0; line < 3 * KEYSTREAM_RING_LINES; line++) {
+        if (line == KEYSTREAM_RING_LINES) {
+            crypto_resync(&ref);
+            crypto_resync(&prng);
+            keystream_ring_reset(&ring);
+        }
+        if (line % 3 != 2) {
+            keystream_prefetch(&ring, &prng, KEYSTREAM_RING_LINES);
+        }
+
+        crypto_xor_line(&ref, plain, fused, RING_WIDTH);
+        if (!keystream_xor_line(&ring, plain, ringed, RING_WIDTH, NULL)) {
+            crypto_xor_line(&prng, plain, ringed, RING_WIDTH);
+        }
+        if (memcmp(fused, ringed, RING_WIDTH) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ===== MAIN =====
+int main(void) {
+#ifdef LIB_PICO_STDLIB
+    stdio_init_all();
+#endif
+
+    printf("PicoCrypt FPV crypto test (%s)\n",
+           CRYPTO_BACKEND == CRYPTO_BACKEND_CHACHA ? "ChaCha" : "Xorshift128+");
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_CHACHA && CHACHA_ROUNDS == 20
+    check(test_rfc8439_block(), "RFC 8439 ChaCha20 block");
+#endif
+    check(test_reference_layout(), "Reference keystream layout");
+    check(test_full_key(), "Every key word changes the keystream");
+    check(test_roundtrip_unaligned(), "Unaligned round trip");
+    check(test_in_place(), "In-place round trip");
+    check(test_resync(), "V-Sync resync");
+    check(test_seek(), "Seek matches sequential keystream");
+    check(test_keystream_ring(), "Keystream prefetch ring");
+
+    printf("%s (%d failure(s))\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? 1 : 0;
+}
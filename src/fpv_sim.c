@@ -0,0 +1,791 @@
+/*
+ * PicoCrypt FPV - End-to-End Simulator (host)
+ * Synthetic composite video through the real sender and receiver pipelines
+ *
+ * Per line: synthesize a composite line of the build's video
+ * profile (video_profile.h; one fpv_sim_<profile> binary each), digitise
+ * it at the ADC rate, capture, resample and encrypt it with src/sender.c,
+ * output it onto a simulated link (optional
+ * Gaussian noise), capture, decrypt and output it with src/receiver.c,
+ * and store the recovered samples. The HAL is the in-memory simulator
+ * HAL, so every pipeline stage between ADC and DAC is the firmware code.
+ * Interlaced profiles run field by field, as the hardware sees them: one
+ * V-Sync per field, VBI lines included, active lines woven back into
+ * frame rows.
+ *
+ * Only the active picture is encrypted (include/line_map.h). The link is
+ * checked for untouched blanking, and an H-Sync detector on the received
+ * signal reports how long the receiver takes to lock. -x scrambles the
+ * blanking on the link as whole-line encryption would, for comparison.
+ *
+ * The receiver keys each field from the frame counter the sender writes
+ * into the VBI (include/vbi_code.h). -j powers the receiver up late and
+ * -d makes it miss one V-Sync; the report shows how soon its keystream
+ * matches the sender's again.
+ *
+ * -s shifts every line the receiver captures by a random whole number of
+ * samples, as capture start jitter would. The receiver realigns each line
+ * from the sender's pilot (include/pilot.h); the display locks to each
+ * line's own H-Sync, so the frame store reads the picture at the shift.
+ * Built with SCRAMBLE_ROTATE (fpv_sim_rotate) the receiver plays each
+ * rotated line realigned, head and colour burst included, so the store
+ * reads it in place.
+ * The report shows the share of picture samples recovered exactly, and
+ * how many active lines reached the display without their burst.
+ *
+ * -r fades this percentage of active lines into noise on the link, as an
+ * RF dropout would. The receiver must flag each one and play its last
+ * good copy from the line history (include/line_store.h); the report
+ * shows the store's size, how many faded lines were concealed and how
+ * close the concealed lines came to the source. Fades spare the VBI, so
+ * the frame code always locks.
+ *
+ * Every active line carries the sender's check of its picture
+ * (include/line_check.h). -k makes the receiver miss the capture of one
+ * line mid-field, so the rest of the field slips by a line: the failing
+ * checks must raise a sync error and find the slip before the field
+ * ends. Link noise (-l) alone must raise none. The report shows lines
+ * checked, failed and sync errors, and the link noise the receiver read
+ * off the pilots. -p also plays the link through a second receiver
+ * without the line check, as the reference the noisy picture is judged
+ * against.
+ *
+ * -F starts the sender's frame counter here, as the firmware starts it
+ * at a random frame on every power-up; the receiver starts at frame 0
+ * and must follow the VBI code.
+ *
+ * -K rekeys both units from key slot 0 to slot 1 at the V-Sync of this
+ * field, scheduled REKEY_LEAD_FRAMES fields ahead as over USB
+ * (include/rekey.h). The field of the switch must decrypt like any other.
+ *
+ * Reports PSNR of the recovered against the captured source samples
+ * (the sender's capture after resampling to the output rate),
+ * simulated frames per second and host time per pipeline stage.
+ *
+ * Usage: fpv_sim [-f frames] [-n noise] [-l link_noise] [-j field] [-d field]
+ *                [-s jitter] [-r percent] [-k field] [-K field] [-F frame] [-i source.y4m]
+ *                [-o recovered.y4m] [-t trace.bin] [-x] [-c] [-p]
+ *   -n   source (camera) noise, standard deviation in ADC codes
+ *   -l   link noise added to the encrypted signal, in ADC codes
+ *   -t   event trace stream of both units (decode with trace_decode)
+ *   -j   receiver joins at this field (power-up mid-stream)
+ *   -d   receiver misses the V-Sync of this field
+ *   -s   receiver capture jitter, up to this many samples either way
+ *   -r   active lines faded into noise on the link, percent
+ *   -k   receiver misses one line capture in the middle of this field
+ *   -K   both units switch to a second key at this field
+ *   -F   sender's frame counter at power-up
+ *   -x   emulate whole-line encryption on the link (sync acquisition)
+ *   -c   check mode: exit 1 unless the recovered video is bit-exact and
+ *        the blanking passed through untouched. Frames before -j and the
+ *        frame of -d are not compared, but the receiver must lock in the
+ *        first field it sees and again in the field after -d. Faded
+ *        lines are not compared either, but every one must be flagged
+ *        and, once its line has been seen good, concealed. Nor is the
+ *        frame of -k; there must be sync errors if and only if -d or -k
+ *        fall within the run. With -K both units must switch keys once.
+ *        In colour, every active line must reach the display with a burst.
+ *   -p   with -c on a noisy link (-l): instead of bit-exact, no compared
+ *        frame may fall below the worst frame of the reference receiver
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "hal.h"
+#include "line_check.h"
+#include "line_map.h"
+#include "line_store.h"
+#include "pilot.h"
+#include "receiver.h"
+#include "resample.h"
+#include "sender.h"
+#include "trace.h"
+#include "vbi_code.h"
+#include "video_synth.h"
+
+// ===== CONFIGURATION =====
+#define SIM_KEY             0x123456789ABCDEF0ULL
+#define SIM_REKEY           0x0FEDCBA987654321ULL   // Slot 1, for -K
+#define SIM_FRAMES          25
+#define SIM_FIRST_FRAME     0x5A17C3E9u     // Sender's power-up frame, for -F
+#define SIM_SEED            0x2545F491u
+#define MAX_LINE_SAMPLES    VIDEO_LINE_SAMPLES
+#define SYNC_LOCK_LINES     8           // Consecutive H-Syncs for lock
+
+typedef enum {
+    STAGE_SYNTH = 0,            // Composite line at the ADC rate
+    STAGE_SENDER_CAPTURE,       // Capture + resample + encrypt (sender core 0)
+    STAGE_SENDER_OUTPUT,        // Output (sender core 1)
+    STAGE_LINK,
+    STAGE_RECEIVER_CAPTURE,     // Capture (receiver core 0)
+    STAGE_RECEIVER_OUTPUT,      // Decrypt + output (receiver core 1)
+    STAGE_COUNT
+} sim_stage_t;
+
+static const char* stage_names[STAGE_COUNT] = {
+    "Synthesize composite",
+    "Sender capture+resample+encrypt",
+    "Sender output",
+    "Link",
+    "Receiver capture",
+    "Receiver decrypt+output",
+};
+
+// ===== SINKS =====
+typedef struct {
+    uint8_t samples[MAX_LINE_SAMPLES];
+    const uint8_t* source;          // Sender's capture, resampled
+    uint32_t field_line;
+    double noise_stddev;
+    uint32_t rng;
+    bool scramble_blanking;         // -x
+    uint32_t blanking_changed;      // Blanking samples altered by the sender
+} link_t;
+
+typedef struct {
+    uint8_t* frame;
+    uint32_t width;
+    uint32_t height;
+    uint32_t row;                   // Next row: field lines step by VIDEO_FIELDS
+    uint32_t field_line;
+    uint32_t lines;                 // Lines stored this frame
+    int32_t shift;                  // Capture shift of the line being output
+    uint32_t burstless;             // Active lines played with a flat back porch
+} frame_store_t;
+
+typedef struct {
+    uint32_t run;                   // Consecutive lines with a valid H-Sync
+    uint32_t valid;
+    uint32_t lines;
+    int64_t lock_line;              // Line at which lock was reached, -1 if never
+} sync_detector_t;
+
+static uint32_t xorshift32(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void link_sink(void* context, const uint8_t* line, uint32_t length) {
+    link_t* link = context;
+    line_span_t span = line_map_crypto_span(link->field_line, length);
+
+    // The code lines' active span is replaced by the frame code, lines
+    // played from a buffer carry the pilot in their sync tip and active
+    // lines their check after it
+    bool pilot = pilot_line(link->field_line);
+    bool checked = line_map_is_active(link->field_line);
+    if (vbi_code_line(link->field_line++) >= 0) {
+        span = line_segments[LINE_SEG_ACTIVE];
+    }
+
+    memcpy(link->samples, line, length);
+    for (uint32_t i = 0; i < length; i++) {
+        bool blanking = i < span.start || i >= (uint32_t)span.start + span.length;
+        if (!blanking) {
+            continue;
+        }
+        bool pilot_chip = pilot && i >= PILOT_START && i < PILOT_START + PILOT_CHIPS;
+        bool check_chip = checked && i >= LINE_CHECK_START &&
+                          i < LINE_CHECK_START + LINE_CHECK_BITS;
+        if (!pilot_chip && !check_chip && link->samples[i] != link->source[i]) {
+            link->blanking_changed++;
+        }
+        if (link->scramble_blanking) {
+            link->samples[i] = (uint8_t)xorshift32(&link->rng);
+        }
+    }
+}
+
+static void frame_sink(void* context, const uint8_t* line, uint32_t length) {
+    frame_store_t* store = context;
+    if (!line_map_is_active(store->field_line++)) {
+        return;
+    }
+    // Rotated pictures come out realigned (receiver.c), head included:
+    // a back porch at flat blanking lost the colour burst
+    int32_t shift = SCRAMBLE_MODE == SCRAMBLE_ROTATE ? 0 : store->shift;
+    bool flat = true;
+    for (int32_t i = VIDEO_H_SYNC_SAMPLES + shift; i < VIDEO_ACTIVE_START + shift; i++) {
+        flat &= line[i] == SYNTH_LEVEL_BLANK;
+    }
+    store->burstless += flat;
+    if (store->row < store->height) {
+        memcpy(store->frame + (size_t)store->row * store->width,
+               line + VIDEO_ACTIVE_START + shift, store->width);
+        store->row += VIDEO_FIELDS;
+        store->lines++;
+    }
+}
+
+// H-Sync tip below, back porch above the slicing level
+static void sync_detect(sync_detector_t* det, const uint8_t* line) {
+    const uint32_t slice = (SYNTH_LEVEL_SYNC + SYNTH_LEVEL_BLANK) / 2;
+    uint32_t tip = 0, porch = 0;
+
+    for (uint32_t i = 4; i < VIDEO_H_SYNC_SAMPLES - 4; i++) {
+        tip += line[i];
+    }
+    for (uint32_t i = VIDEO_ACTIVE_START - 8; i < VIDEO_ACTIVE_START; i++) {
+        porch += line[i];
+    }
+    bool valid = tip < slice * (VIDEO_H_SYNC_SAMPLES - 8) && porch > slice * 8;
+
+    det->run = valid ? det->run + 1 : 0;
+    det->valid += valid;
+    if (det->run == SYNC_LOCK_LINES && det->lock_line < 0) {
+        det->lock_line = det->lines;
+    }
+    det->lines++;
+}
+
+// The camera signal as the ADC sees it: composite line interpolated at
+// the capture sample times
+static void digitise(const uint8_t* composite, uint8_t* adc) {
+    for (uint32_t i = 0; i < VIDEO_CAPTURE_SAMPLES; i++) {
+        double x = (double)i * VIDEO_RESAMPLE_UP / VIDEO_RESAMPLE_DOWN;
+        uint32_t n = (uint32_t)x;
+        double t = x - n;
+        uint8_t next = composite[n + 1 < VIDEO_LINE_SAMPLES ? n + 1 : n];
+        adc[i] = (uint8_t)lrint(composite[n] * (1.0 - t) + next * t);
+    }
+}
+
+// Receiver capture started `shift` samples early (content later in the
+// line); the samples outside the link line hold its edges
+static void jitter_line(const uint8_t* link, uint8_t* captured, int32_t shift) {
+    for (int32_t i = 0; i < VIDEO_LINE_SAMPLES; i++) {
+        int32_t n = i - shift;
+        captured[i] = link[n < 0 ? 0 : n >= VIDEO_LINE_SAMPLES ? VIDEO_LINE_SAMPLES - 1 : n];
+    }
+}
+
+static void file_sink(void* context, const uint8_t* data, uint32_t length) {
+    fwrite(data, 1, length, (FILE*)context);
+}
+
+static void link_apply_noise(link_t* link, uint32_t length) {
+    if (link->noise_stddev <= 0.0) {
+        return;
+    }
+    for (uint32_t i = 0; i < length; i++) {
+        long v = lrint(link->samples[i] + link->noise_stddev * video_synth_gaussian(&link->rng));
+        link->samples[i] = (uint8_t)(v < 0 ? 0 : v > 255 ? 255 : v);
+    }
+}
+
+// ===== Y4M =====
+static FILE* y4m_open(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if (f) {
+        fprintf(f, "YUV4MPEG2 W%u H%u F%u:%u %s A1:1 C420jpeg\n",
+                VIDEO_ACTIVE_SAMPLES, VIDEO_ACTIVE_LINES,
+                VIDEO_FIELD_RATE_NUM, VIDEO_FIELD_RATE_DEN * VIDEO_FIELDS,
+                VIDEO_FIELDS > 1 ? "It" : "Ip");
+    }
+    return f;
+}
+
+// Samples as luma, neutral chroma
+static void y4m_write(FILE* f, const uint8_t* frame, uint32_t width, uint32_t height) {
+    static uint8_t chroma[VIDEO_ACTIVE_SAMPLES / 2 * (VIDEO_ACTIVE_LINES / 2)];
+    size_t chroma_size = (size_t)(width / 2) * (height / 2);
+
+    if (!f) {
+        return;
+    }
+    memset(chroma, 128, chroma_size);
+    fputs("FRAME\n", f);
+    fwrite(frame, 1, (size_t)width * height, f);
+    fwrite(chroma, 1, chroma_size, f);
+    fwrite(chroma, 1, chroma_size, f);
+}
+
+// ===== TIMING =====
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static double psnr(double sse, double samples) {
+    if (sse == 0.0) {
+        return INFINITY;
+    }
+    return 10.0 * log10(255.0 * 255.0 * samples / sse);
+}
+
+// Squared error of a stored frame; rows never stored count as full scale
+static double frame_sse(const uint8_t* source, const frame_store_t* store) {
+    double sse = 255.0 * 255.0 * (double)(store->height - store->lines) * store->width;
+    for (size_t i = 0; i < (size_t)store->width * store->height; i++) {
+        double d = (double)source[i] - (double)store->frame[i];
+        sse += d * d;
+    }
+    return sse;
+}
+
+// ===== MAIN =====
+int main(int argc, char** argv) {
+    uint32_t frames = SIM_FRAMES;
+    double source_noise = 0.0;
+    double link_noise = 0.0;
+    const char* source_path = NULL;
+    const char* output_path = NULL;
+    const char* trace_path = NULL;
+    uint32_t join = 0;
+    int64_t drop = -1;
+    int64_t slip = -1;
+    int64_t rekey = -1;
+    uint32_t first_frame = SIM_FIRST_FRAME;
+    int32_t jitter = 0;
+    double fade = 0.0;
+    bool scramble = false;
+    bool check = false;
+    bool reference = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "f:n:l:j:d:s:r:k:K:F:i:o:t:xcp")) != -1) {
+        switch (opt) {
+        case 'f': frames = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'n': source_noise = atof(optarg); break;
+        case 'l': link_noise = atof(optarg); break;
+        case 'j': join = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'd': drop = strtol(optarg, NULL, 0); break;
+        case 's': jitter = (int32_t)strtol(optarg, NULL, 0); break;
+        case 'r': fade = atof(optarg); break;
+        case 'k': slip = strtol(optarg, NULL, 0); break;
+        case 'K': rekey = strtol(optarg, NULL, 0); break;
+        case 'F': first_frame = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'i': source_path = optarg; break;
+        case 'o': output_path = optarg; break;
+        case 't': trace_path = optarg; break;
+        case 'x': scramble = true; break;
+        case 'c': check = true; break;
+        case 'p': reference = true; break;
+        default:
+            fprintf(stderr, "Usage: %s [-f frames] [-n noise] [-l link_noise] [-j field] [-d field]"
+                            " [-s jitter] [-r percent] [-k field] [-K field] [-F frame]"
+                            " [-i source.y4m]"
+                            " [-o recovered.y4m] [-t trace.bin] [-x] [-c] [-p]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (jitter < 0 || jitter > PILOT_SEARCH) {
+        fprintf(stderr, "Jitter must be 0 to %d samples\n", PILOT_SEARCH);
+        return 2;
+    }
+
+    uint32_t width = VIDEO_ACTIVE_SAMPLES;
+    uint32_t height = VIDEO_ACTIVE_LINES;
+    size_t frame_size = (size_t)width * height;
+    double line_us = VIDEO_LINE_PERIOD_NS / 1000.0;
+
+    // Units and their simulated hardware
+    static sender_t sender;
+    static receiver_t receiver;
+    static receiver_t ref_receiver;     // -p: same link, no line check
+    static link_t link;
+    hal_video_in_t sender_in, receiver_in, ref_in;
+    hal_video_out_t sender_out, receiver_out, ref_out;
+    hal_line_sum_t sender_sum, receiver_sum;
+    frame_store_t store = { malloc(frame_size), width, height, 0, 0, 0, 0, 0 };
+    frame_store_t ref_store = { malloc(frame_size), width, height, 0, 0, 0, 0, 0 };
+    sync_detector_t sync = { 0, 0, 0, -1 };
+    uint8_t* source = malloc(frame_size);
+    uint8_t composite[MAX_LINE_SAMPLES];
+    uint8_t adc[VIDEO_CAPTURE_SAMPLES];
+    uint8_t captured[RESAMPLE_BUFFER_SAMPLES];          // Reference resampler run
+    uint8_t jittered[MAX_LINE_SAMPLES];                 // Link as the receiver captures it
+    uint32_t jitter_rng = SIM_SEED ^ 0x7F4A7C15u;
+    uint32_t fade_rng = SIM_SEED ^ 0x3C6EF372u;
+    uint32_t fade_threshold = (uint32_t)(fade / 100.0 * 4294967295.0);
+    bool* faded = calloc(height, sizeof(bool));             // Frame rows faded
+    bool seen[LINE_STORE_LINES] = { false };                // Line index arrived good
+    video_synth_t synth;
+
+    if (!store.frame || !ref_store.frame || !source || !faded) {
+        return 1;
+    }
+    link.noise_stddev = link_noise;
+    link.rng = SIM_SEED ^ 0x9E3779B9u;
+    link.source = captured;
+    link.scramble_blanking = scramble;
+
+    hal_sim_video_in_init(&sender_in);
+    hal_sim_video_in_init(&receiver_in);
+    hal_sim_video_out_init(&sender_out, link_sink, &link);
+    hal_sim_video_out_init(&receiver_out, frame_sink, &store);
+    hal_sim_video_in_set_source(&receiver_in, jittered);
+    hal_sim_video_in_init(&ref_in);
+    hal_sim_video_out_init(&ref_out, frame_sink, &ref_store);
+    hal_sim_video_in_set_source(&ref_in, jittered);
+    hal_sim_line_sum_init(&sender_sum);
+    hal_sim_line_sum_init(&receiver_sum);
+    crypto_key_t keys[2];
+    crypto_key_from_u64(&keys[0], SIM_KEY);
+    crypto_key_from_u64(&keys[1], SIM_REKEY);
+    sender_init(&sender, &keys[0], 0, first_frame, VIDEO_LINE_SAMPLES, &sender_in, &sender_out,
+                &sender_sum);
+    receiver_init(&receiver, &keys[0], 0, VIDEO_LINE_SAMPLES, &receiver_in, &receiver_out,
+                  &receiver_sum);
+    receiver_init(&ref_receiver, &keys[0], 0, VIDEO_LINE_SAMPLES, &ref_in, &ref_out, NULL);
+    video_synth_init(&synth, source_noise, SIM_SEED);
+
+    FILE* source_file = source_path ? y4m_open(source_path) : NULL;
+    FILE* output_file = output_path ? y4m_open(output_path) : NULL;
+    FILE* trace_file = trace_path ? fopen(trace_path, "wb") : NULL;
+
+    // Without -t the debug channel has no room and records are dropped
+    trace_init();
+    if (trace_file) {
+        hal_sim_set_debug_sink(file_sink, trace_file);
+    }
+
+    double stage_ns[STAGE_COUNT] = { 0 };
+    double total_sse = 0.0, worst_psnr = INFINITY, ref_worst_psnr = INFINITY;
+    uint32_t bad_frames = 0, bad_lines = 0, compared_frames = 0;
+    uint64_t recovered_samples = 0;
+    uint32_t faded_lines = 0, concealable = 0;
+    double faded_sse = 0.0;
+    uint64_t faded_compared = 0;
+    int first_bad_frame = -1;
+    uint32_t unlocked_fields = 0;
+    int64_t lock_field = -1;            // First field keyed like the sender
+    // Field whose V-Sync the rekey command precedes (field i runs sender
+    // frame first_frame + i + 1)
+    int64_t rekey_command = rekey > REKEY_LEAD_FRAMES ? rekey - REKEY_LEAD_FRAMES : 0;
+    bool rekey_scheduled = rekey < 0 || rekey_command >= (int64_t)frames * VIDEO_FIELDS;
+    double start = now_ns();
+
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        bool compare = true;
+        store.lines = 0;
+        ref_store.lines = 0;
+        memset(faded, 0, height * sizeof(bool));
+
+        for (uint32_t field = 0; field < VIDEO_FIELDS; field++) {
+            // V-Sync on both units, once per field; the receiver only
+            // once powered up (-j) and not on a missed one (-d)
+            uint32_t field_index = frame * VIDEO_FIELDS + field;
+            bool rx_on = field_index >= join;
+            uint64_t t_field = (uint64_t)field_index * VIDEO_FIELD_LINES;
+            hal_sim_set_time_us((uint32_t)(t_field * line_us));
+            if (rekey >= 0 && field_index == rekey_command) {
+                uint32_t rekey_frame = first_frame + (uint32_t)rekey + 1;
+                rekey_scheduled = sender_rekey(&sender, &keys[1], 1, rekey_frame) &&
+                                  receiver_rekey(&receiver, &keys[1], 1, rekey_frame);
+                if (reference) {
+                    receiver_rekey(&ref_receiver, &keys[1], 1, rekey_frame);
+                }
+            }
+            sender_vsync(&sender);
+            sender_output_step(&sender);
+            if (rx_on && field_index != drop) {
+                receiver_vsync(&receiver);
+                receiver_output_step(&receiver);
+                if (reference) {
+                    receiver_vsync(&ref_receiver);
+                    receiver_output_step(&ref_receiver);
+                }
+            }
+            compare &= rx_on && field_index != drop && field_index != slip;
+            store.row = field;
+            store.field_line = 0;
+            ref_store.row = field;
+            ref_store.field_line = 0;
+            link.field_line = 0;
+
+            for (uint32_t n = 0; n < VIDEO_FIELD_LINES; n++) {
+                hal_sim_set_time_us((uint32_t)((t_field + n) * line_us));
+
+                double t0 = now_ns();
+                bool active = line_map_is_active(n);
+                uint32_t line = line_map_active_index(n) * VIDEO_FIELDS + field;
+                if (active) {
+                    video_synth_line(&synth, frame, line, composite);
+                } else {
+                    video_synth_blank_line(&synth, composite);
+                }
+                digitise(composite, adc);
+                hal_sim_video_in_set_source(&sender_in, adc);
+
+                // What the sender encrypts: the same capture, resampled
+                memcpy(captured + RESAMPLE_IN_OFFSET, adc, VIDEO_CAPTURE_SAMPLES);
+                resample_line(captured);
+                if (active) {
+                    memcpy(source + (size_t)line * width, captured + VIDEO_ACTIVE_START, width);
+                }
+
+                double t1 = now_ns();
+                sender_hsync(&sender);
+                sender_capture_step(&sender);
+
+                double t2 = now_ns();
+                sender_output_step(&sender);
+
+                double t3 = now_ns();
+                link_apply_noise(&link, VIDEO_LINE_SAMPLES);
+                if (active && rx_on && fade > 0.0 && xorshift32(&fade_rng) <= fade_threshold) {
+                    for (uint32_t i = 0; i < VIDEO_LINE_SAMPLES; i++) {
+                        link.samples[i] = (uint8_t)xorshift32(&fade_rng);
+                    }
+                    faded[line] = true;
+                    faded_lines++;
+                    concealable += seen[line_map_active_index(n)];
+                } else if (active && rx_on) {
+                    seen[line_map_active_index(n)] = true;
+                }
+                sync_detect(&sync, link.samples);
+                store.shift = jitter
+                    ? (int32_t)(xorshift32(&jitter_rng) % (2 * jitter + 1)) - jitter : 0;
+                ref_store.shift = store.shift;
+                jitter_line(link.samples, jittered, store.shift);
+
+                double t4 = now_ns();
+                bool missed = field_index == slip && n == VIDEO_FIELD_LINES / 2;
+                if (rx_on && !missed) {
+                    receiver_hsync(&receiver);
+                    receiver_capture_step(&receiver);
+                }
+
+                double t5 = now_ns();
+                if (rx_on) {
+                    receiver_output_step(&receiver);
+                }
+                double t6 = now_ns();
+
+                // Reference receiver, outside the stage timings
+                if (reference && rx_on && !missed) {
+                    receiver_hsync(&ref_receiver);
+                    receiver_capture_step(&ref_receiver);
+                }
+                if (reference && rx_on) {
+                    receiver_output_step(&ref_receiver);
+                }
+
+                // Idle time: stream the event trace
+                trace_drain();
+
+                stage_ns[STAGE_SYNTH] += t1 - t0;
+                stage_ns[STAGE_SENDER_CAPTURE] += t2 - t1;
+                stage_ns[STAGE_SENDER_OUTPUT] += t3 - t2;
+                stage_ns[STAGE_LINK] += t4 - t3;
+                stage_ns[STAGE_RECEIVER_CAPTURE] += t5 - t4;
+                stage_ns[STAGE_RECEIVER_OUTPUT] += t6 - t5;
+            }
+
+            // Lock: receiver keyed with the sender's frame by the field end
+            if (rx_on) {
+                bool locked = receiver.prng->sync_counter == sender.prng->sync_counter &&
+                              rekey_slot(&receiver.rekey) == rekey_slot(&sender.rekey);
+                unlocked_fields += !locked;
+                if (locked && lock_field < 0) {
+                    lock_field = field_index;
+                }
+            }
+        }
+
+        if (!compare) {
+            y4m_write(source_file, source, width, height);
+            y4m_write(output_file, store.frame, width, height);
+            continue;
+        }
+        compared_frames++;
+
+        // Compare recovered against captured source; faded lines count
+        // towards PSNR but not as mismatches
+        double sse = 0.0;
+        bool mismatch = false;
+        for (uint32_t line = 0; line < height; line++) {
+            const uint8_t* a = source + (size_t)line * width;
+            const uint8_t* b = store.frame + (size_t)line * width;
+            double line_sse = 0.0;
+            for (uint32_t x = 0; x < width; x++) {
+                double d = (double)a[x] - (double)b[x];
+                line_sse += d * d;
+                recovered_samples += a[x] == b[x];
+            }
+            sse += line_sse;
+            if (faded[line]) {
+                faded_sse += line_sse;
+                faded_compared++;
+            } else if (line_sse != 0.0) {
+                bad_lines++;
+                mismatch = true;
+            }
+        }
+        if (store.lines != height) {
+            sse += 255.0 * 255.0 * (double)(height - store.lines) * width;
+            mismatch = true;
+        }
+        if (mismatch) {
+            bad_frames++;
+            if (first_bad_frame < 0) {
+                first_bad_frame = (int)frame;
+            }
+        }
+        double frame_psnr = psnr(sse, (double)frame_size);
+        if (frame_psnr < worst_psnr) {
+            worst_psnr = frame_psnr;
+        }
+        if (reference) {
+            double ref_psnr = psnr(frame_sse(source, &ref_store), (double)frame_size);
+            if (ref_psnr < ref_worst_psnr) {
+                ref_worst_psnr = ref_psnr;
+            }
+        }
+        total_sse += sse;
+
+        y4m_write(source_file, source, width, height);
+        y4m_write(output_file, store.frame, width, height);
+    }
+
+    double elapsed = now_ns() - start;
+    uint64_t lines = (uint64_t)frames * VIDEO_FIELDS * VIDEO_FIELD_LINES;
+
+    if (source_file) fclose(source_file);
+    if (output_file) fclose(output_file);
+    if (trace_file) fclose(trace_file);
+
+    // ===== REPORT =====
+    printf("PicoCrypt FPV end-to-end simulation\n");
+    printf("Profile: %s, %ux%u active, %u samples/line (%.2f us), %u field(s)/frame\n",
+           VIDEO_PROFILE_NAME, width, height, VIDEO_LINE_SAMPLES, line_us, VIDEO_FIELDS);
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_CHACHA
+    printf("Crypto: ChaCha%d, pipeline depth %d\n", CHACHA_ROUNDS, LINE_POOL_DEPTH);
+#else
+    printf("Crypto: Xorshift128+ x%d, pipeline depth %d\n", CRYPTO_LANES, LINE_POOL_DEPTH);
+#endif
+    printf("Scrambling: %s\n", SCRAMBLE_MODE == SCRAMBLE_ROTATE ? "cut-and-rotate" : "XOR");
+    printf("Noise: source %.1f, link %.1f (ADC codes, std dev)\n\n", source_noise, link_noise);
+
+    printf("%-32s %10s %12s\n", "Stage", "ns/line", "% of line");
+    for (int s = 0; s < STAGE_COUNT; s++) {
+        double per_line = stage_ns[s] / lines;
+        printf("%-32s %10.1f %11.2f%%\n", stage_names[s], per_line,
+               100.0 * per_line / (line_us * 1000.0));
+    }
+
+    printf("\nSimulated %u frames (%llu lines) in %.3f s: %.1f fps (real time %.2f fps)\n",
+           frames, (unsigned long long)lines, elapsed / 1e9, frames * 1e9 / elapsed,
+           (double)VIDEO_FIELD_RATE_NUM / (VIDEO_FIELD_RATE_DEN * VIDEO_FIELDS));
+    printf("Lines: sender out %u, receiver out %u, pool overruns %u/%u\n",
+           sender_out.lines, receiver_out.lines,
+           sender.pool.overruns, receiver.pool.overruns);
+
+    // Keystream: measured on the sender vs encrypting every sample of every line
+    double crypto_per_frame = (double)sender.crypto_samples / frames;
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+    printf("Rotated: %.0f keystream bytes/frame (XOR of the active picture: %u)\n",
+           crypto_per_frame, LINE_MAP_FRAME_CRYPTO_BYTES);
+#else
+    printf("Encrypted: %.0f of %u samples/frame (%.1f%% keystream and XOR saved)\n",
+           crypto_per_frame, LINE_MAP_FRAME_LINE_BYTES,
+           100.0 * (1.0 - crypto_per_frame / LINE_MAP_FRAME_LINE_BYTES));
+#endif
+    printf("Blanking: %u samples altered by the sender%s\n", link.blanking_changed,
+           scramble ? ", scrambled on the link (-x)" : "");
+    if (sync.lock_line >= 0) {
+        printf("H-Sync: lock after %lld lines (%.1f us), %.1f%% of lines valid\n",
+               (long long)sync.lock_line + 1, (sync.lock_line + 1) * line_us,
+               100.0 * sync.valid / sync.lines);
+    } else {
+        printf("H-Sync: no lock, %.1f%% of lines valid\n", 100.0 * sync.valid / sync.lines);
+    }
+
+    // Keystream lock: within the first field the receiver sees, at its
+    // last code line, and again in the field after a missed V-Sync
+    uint32_t expected_unlocked = drop >= (int64_t)join && drop < (int64_t)frames * VIDEO_FIELDS;
+    bool lock_ok = join >= (uint64_t)frames * VIDEO_FIELDS ||
+                   (lock_field == join && unlocked_fields <= expected_unlocked);
+    if (lock_field >= 0) {
+        uint64_t lock_lines = (uint64_t)(lock_field - join) * VIDEO_FIELD_LINES +
+                              VBI_CODE_FIRST_LINE + VBI_CODE_LINES;
+        printf("Frame code: locked %llu field(s) after joining at field %u, by line %u "
+               "(%.2f ms); %u unlocked field(s)\n",
+               (unsigned long long)(lock_field - join), join, VBI_CODE_FIRST_LINE + VBI_CODE_LINES,
+               lock_lines * line_us / 1000.0, unlocked_fields);
+    } else {
+        printf("Frame code: no lock\n");
+    }
+    printf("Frame code: %u field(s) decoded, %u failed, %u relock(s)\n",
+           receiver.code_fields, receiver.code_errors, receiver.code_relocks);
+
+    if (fade > 0.0) {
+        printf("Dropouts: %u active line(s) faded (%.2f%%); %u flagged, %u concealed of %u "
+               "seen good before (%.1f%% coverage)\n", faded_lines,
+               100.0 * faded_lines / ((double)frames * height), receiver.lines_bad,
+               receiver.lines_concealed, concealable,
+               concealable ? 100.0 * receiver.lines_concealed / concealable : 100.0);
+        printf("Line history: %zu bytes (%u lines x %u bytes), %.1f%% of a field of samples; "
+               "faded lines at %.2f dB PSNR\n", sizeof(receiver.history.lines),
+               LINE_STORE_LINES, LINE_STORE_LINE_BYTES,
+               100.0 * sizeof(receiver.history.lines) / (LINE_STORE_LINES * VIDEO_ACTIVE_SAMPLES),
+               psnr(faded_sse, (double)faded_compared * width));
+    }
+    printf("Timing: capture jitter +-%d sample(s); pilot found on %u line(s), %u missed, "
+           "%u realigned\n", jitter, receiver.pilot_lines, receiver.pilot_misses,
+           receiver.pilot_shifted);
+    printf("Check: %u active line(s) checked, %u failed, %u slip(s) found; %u sync error(s); "
+           "link noise %.2f codes rms on the pilots\n", receiver.check_lines,
+           receiver.check_errors, receiver.check_slips, receiver.sync_error_count,
+           1.2533 * receiver.check_noise / LINE_CHECK_NOISE_ONE);
+    if (rekey >= 0) {
+        printf("Rekey: slot %u from frame %u%s; switches: sender %u, receiver %u\n",
+               rekey_slot(&sender.rekey), first_frame + (uint32_t)rekey + 1,
+               rekey_scheduled ? "" : " (not scheduled)", sender.rekey.switches,
+               receiver.rekey.switches);
+    }
+    // Monochrome profiles have no burst to lose
+    bool colour = VIDEO_SUBCARRIER_HZ > 0.0;
+    if (colour) {
+        printf("Burst: %u active line(s) played without the colour burst\n", store.burstless);
+    }
+    if (compared_frames) {
+        printf("Picture: %.2f%% of samples recovered exactly\n",
+               100.0 * recovered_samples / ((double)frame_size * compared_frames));
+    }
+
+    double overall = psnr(total_sse, (double)frame_size * compared_frames);
+    if (isinf(overall)) {
+        printf("PSNR: inf dB (bit-exact)\n");
+    } else {
+        printf("PSNR: %.2f dB overall, worst frame %.2f dB\n", overall, worst_psnr);
+        if (reference) {
+            printf("PSNR: worst frame %.2f dB without the line check\n", ref_worst_psnr);
+        }
+        printf("Mismatch: %u/%u frames, %u lines, first at frame %d\n",
+               bad_frames, compared_frames, bad_lines, first_bad_frame);
+    }
+
+    free(store.frame);
+    free(ref_store.frame);
+    free(source);
+    free(faded);
+
+    // Lines lost with -k are bad too, but never faded
+    int64_t fields = (int64_t)frames * VIDEO_FIELDS;
+    bool slipped = slip >= (int64_t)join && slip < fields;
+    bool conceal_ok = slipped || (receiver.lines_bad == faded_lines &&
+                                  receiver.lines_concealed == concealable);
+    // Both show by the next V-Sync at the latest; the last field has none
+    bool last = slip == fields - 1 || drop == fields - 1;
+    bool sync_ok = last || (receiver.sync_error_count > 0) == (slipped || expected_unlocked);
+    uint32_t switches = rekey >= 0 && rekey < fields;
+    bool rekey_ok = rekey_scheduled && sender.rekey.switches == switches &&
+                    receiver.rekey.switches == switches;
+    bool picture_ok = reference ? worst_psnr >= ref_worst_psnr : bad_frames == 0;
+    bool burst_ok = !colour || store.burstless == 0;
+    return (check && (!picture_ok || link.blanking_changed || !lock_ok || !conceal_ok ||
+                      !sync_ok || !rekey_ok || !burst_ok)) ? 1 : 0;
+}
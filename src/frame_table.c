@@ -0,0 +1,176 @@
+/*
+ * PicoCrypt FPV - Field Descriptor Tables
+ */
+
+#include <string.h>
+
+#include "frame_table.h"
+#include "line_map.h"
+#include "platform.h"
+#include "vbi_code.h"
+
+typedef enum {
+    SLOT_BROAD = 0,
+    SLOT_EQUALISING,
+    SLOT_SYNC,                  // First half of a normal line
+    SLOT_BLANK                  // Second half of a normal line
+} slot_kind_t;
+
+// Half-line slot of the frame, counted from the first field's V-Sync
+static slot_kind_t slot_kind(uint32_t slot) {
+    uint32_t n = slot % FRAME_FIELD_HALF_LINES;
+
+    if (n < 5) {
+        return SLOT_BROAD;
+    }
+    if (n < 10 || n >= FRAME_FIELD_HALF_LINES - 5) {
+        return SLOT_EQUALISING;
+    }
+    return slot % 2 == 0 ? SLOT_SYNC : SLOT_BLANK;
+}
+
+// A field's table starts at the first line-aligned slot of the field
+static uint32_t field_first_slot(uint32_t field) {
+    uint32_t vsync = field * FRAME_FIELD_HALF_LINES;
+    return vsync + vsync % 2;
+}
+
+static const uint8_t* slot_waveform(const frame_table_t* table, slot_kind_t kind) {
+    switch (kind) {
+    case SLOT_BROAD:      return table->broad;
+    case SLOT_EQUALISING: return table->equalising;
+    case SLOT_SYNC:       return table->sync_half;
+    default:              return table->blank_half;
+    }
+}
+
+// Lines that can play a buffer: active and VBI code lines
+static bool buffer_line(uint32_t line) {
+    return line_map_is_active(line) || vbi_code_line(line) >= 0;
+}
+
+static void pulse(uint8_t* out, uint32_t length, uint32_t low) {
+    memset(out, FRAME_LEVEL_SYNC, low);
+    memset(out + low, FRAME_LEVEL_BLANK, length - low);
+}
+
+static void build_field(frame_table_t* table, uint32_t field) {
+    uint32_t first = field_first_slot(field);
+    uint32_t lines = (field_first_slot(field + 1) - first) / 2;
+    frame_desc_t* descs = table->descs[field];
+    uint32_t n = 0;
+
+    for (uint32_t line = 0; line < lines; line++) {
+        slot_kind_t a = slot_kind(first + 2 * line);
+        slot_kind_t b = slot_kind(first + 2 * line + 1);
+
+        table->line_desc[field][line] = (uint16_t)n;
+        if (a == SLOT_SYNC && b == SLOT_BLANK && FRAME_LINE_DESCS > 1 && buffer_line(line)) {
+            // Head, picture split anywhere, front porch: black until a
+            // line is swapped in
+            uint32_t split = VIDEO_ACTIVE_SAMPLES / 2;
+            const uint8_t* picture = table->black + VIDEO_ACTIVE_START;
+
+            descs[n++] = (frame_desc_t){ VIDEO_ACTIVE_START, table->black };
+            descs[n++] = (frame_desc_t){ VIDEO_ACTIVE_SAMPLES - split, picture };
+            descs[n++] = (frame_desc_t){ split, picture };
+            descs[n++] = (frame_desc_t){ VIDEO_H_FRONT_PORCH_SAMPLES,
+                                         picture + VIDEO_ACTIVE_SAMPLES };
+        } else if (a == SLOT_SYNC && b == SLOT_BLANK) {
+            // Normal line: black until an active line is swapped in
+            descs[n++] = (frame_desc_t){ VIDEO_LINE_SAMPLES, table->black };
+        } else {
+            descs[n++] = (frame_desc_t){ FRAME_HALF_SAMPLES, slot_waveform(table, a) };
+            descs[n++] = (frame_desc_t){ FRAME_HALF_SAMPLES, slot_waveform(table, b) };
+        }
+    }
+
+    // End early by the slack; the PIO holds the blanking level until the
+    // next field is started
+    descs[n - 1].count -= FRAME_TABLE_SLACK_SAMPLES;
+    descs[n] = (frame_desc_t){ 0, NULL };
+
+    table->lines[field] = (uint16_t)lines;
+    table->length[field] = (uint16_t)n;
+}
+
+void frame_table_init(frame_table_t* table) {
+    pulse(table->broad, FRAME_HALF_SAMPLES, FRAME_HALF_SAMPLES - VIDEO_H_SYNC_SAMPLES);
+    pulse(table->equalising, FRAME_HALF_SAMPLES, VIDEO_H_SYNC_SAMPLES / 2);
+    pulse(table->sync_half, FRAME_HALF_SAMPLES, VIDEO_H_SYNC_SAMPLES);
+    pulse(table->blank_half, FRAME_HALF_SAMPLES, 0);
+    pulse(table->black, VIDEO_LINE_SAMPLES, VIDEO_H_SYNC_SAMPLES);
+
+    for (uint32_t field = 0; field < VIDEO_FIELDS; field++) {
+        build_field(table, field);
+    }
+}
+
+int PICOCRYPT_RAM_FUNC(frame_table_line_desc)(const frame_table_t* table, uint32_t field,
+                                              uint32_t line) {
+    // Active and VBI code lines; those that carry equalising pulses stay
+    // regenerated
+    if (!buffer_line(line) || line >= table->lines[field]) {
+        return -1;
+    }
+    uint32_t desc = table->line_desc[field][line];
+    return table->descs[field][desc].count == FRAME_LINE_HEAD_SAMPLES ? (int)desc : -1;
+}
+
+void PICOCRYPT_RAM_FUNC(frame_table_set_line)(frame_table_t* table, uint32_t field, int desc,
+                                              const uint8_t* line) {
+    frame_desc_t* d = &table->descs[field][desc];
+
+#if FRAME_LINE_DESCS > 1
+    // Both parts in order, at the split the previous line left
+    d[3].read_addr = line + VIDEO_ACTIVE_START + VIDEO_ACTIVE_SAMPLES;
+    d[2].read_addr = line + VIDEO_ACTIVE_START + d[1].count;
+    d[1].read_addr = line + VIDEO_ACTIVE_START;
+#endif
+    d[0].read_addr = line;
+}
+
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+void PICOCRYPT_RAM_FUNC(frame_table_set_rotated)(frame_table_t* table, uint32_t field,
+                                                 int desc, const uint8_t* head,
+                                                 const uint8_t* active, uint32_t cut) {
+    frame_desc_t* d = &table->descs[field][desc];
+
+    if (!head) {
+        head = table->black;
+    }
+    d[3].read_addr = head + VIDEO_ACTIVE_START + VIDEO_ACTIVE_SAMPLES;
+    d[2] = (frame_desc_t){ cut, active };
+    d[1] = (frame_desc_t){ VIDEO_ACTIVE_SAMPLES - cut, active + cut };
+    d[0].read_addr = head;
+}
+#endif
+
+void PICOCRYPT_RAM_FUNC(frame_table_clear_line)(frame_table_t* table, uint32_t field,
+                                                int desc, const uint8_t* line) {
+    frame_desc_t* d = &table->descs[field][desc];
+
+#if FRAME_LINE_DESCS > 1
+    // A plain line starts at its head, a rotated one's picture at the
+    // second part. Black keeps the split: its picture is all blanking.
+    if (d[0].read_addr == line || d[2].read_addr == line) {
+        d[0].read_addr = table->black;
+        d[1].read_addr = table->black + VIDEO_ACTIVE_START;
+        d[2].read_addr = table->black + VIDEO_ACTIVE_START;
+        d[3].read_addr = table->black + VIDEO_ACTIVE_START + VIDEO_ACTIVE_SAMPLES;
+    }
+#else
+    if (d[0].read_addr == line) {
+        d[0].read_addr = table->black;
+    }
+#endif
+}
+
+uint32_t frame_table_samples(const frame_table_t* table, uint32_t field) {
+    uint32_t samples = 0;
+
+    for (uint32_t i = 0; i < table->length[field]; i++) {
+        samples += table->descs[field][i].count;
+    }
+    return samples;
+}
@@ -0,0 +1,218 @@
+/*
+ * PicoCrypt FPV - Field Descriptor Table Test (host)
+ * Tables of the build's profile played back through the sync classifier
+ *
+ * Plays the descriptors the way the output DMA does, sample by sample,
+ * filling the slack after each table with blanking as the idle PIO would.
+ * Sync edges of the result are stamped at one tick per sample and fed to
+ * the classifier, which must find every field with the right parity and
+ * line count. One active line is swapped in and must come out in place;
+ * with SCRAMBLE_ROTATE, one rotated line must come out rotated.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "frame_table.h"
+#include "line_map.h"
+#include "sync_pulse.h"
+#include "vbi_code.h"
+
+#define TEST_FRAMES         3
+#define TEST_FIELDS         (TEST_FRAMES * VIDEO_FIELDS)
+#define MARK_LEVEL          200
+
+static int failures = 0;
+
+static void check(bool ok, const char* name) {
+    printf("%-40s %s\n", name, ok ? "OK" : "ERROR");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// ===== PLAYBACK =====
+typedef struct {
+    sync_pulse_t sep;
+    uint32_t sample;            // Samples played
+    bool low;
+    uint32_t fields;
+    uint8_t parity[TEST_FIELDS + 1];
+    uint32_t field_lines[TEST_FIELDS + 1];
+    uint32_t marked;            // Samples at MARK_LEVEL
+    uint32_t mark_start;        // First of them
+} player_t;
+
+static frame_table_t table;
+static player_t player;
+
+static void play_sample(player_t* p, uint8_t level) {
+    bool low = level < (FRAME_LEVEL_SYNC + FRAME_LEVEL_BLANK) / 2;
+    sync_event_t ev;
+
+    if (level == MARK_LEVEL && p->marked++ == 0) {
+        p->mark_start = p->sample;
+    }
+    if (low != p->low && sync_pulse_word(&p->sep, 0u - p->sample, &ev)) {
+        if (ev.flags & SYNC_EVENT_FIELD) {
+            if (p->fields < TEST_FIELDS + 1) {
+                p->parity[p->fields] = ev.field;
+            }
+            p->fields++;
+        }
+        if ((ev.flags & SYNC_EVENT_LINE) && p->fields > 0 && p->fields <= TEST_FIELDS + 1) {
+            p->field_lines[p->fields - 1] += ev.lines;
+        }
+    }
+    p->low = low;
+    p->sample++;
+}
+
+static void play_field(player_t* p, uint32_t field) {
+    const frame_desc_t* desc = table.descs[field];
+
+    for (; desc->count != 0; desc++) {
+        for (uint32_t i = 0; i < desc->count; i++) {
+            play_sample(p, desc->read_addr[i]);
+        }
+    }
+    for (uint32_t i = 0; i < FRAME_TABLE_SLACK_SAMPLES; i++) {
+        play_sample(p, FRAME_LEVEL_BLANK);
+    }
+}
+
+static void player_init(player_t* p) {
+    memset(p, 0, sizeof(*p));
+    sync_pulse_init(&p->sep, VIDEO_SAMPLE_RATE_HZ);
+}
+
+// ===== TESTS =====
+static bool test_layout(void) {
+    bool ok = true;
+    uint32_t lines = 0;
+
+    frame_table_init(&table);
+    for (uint32_t f = 0; f < VIDEO_FIELDS; f++) {
+        uint32_t active = 0;
+
+        for (uint32_t line = 0; line < table.lines[f]; line++) {
+            active += frame_table_line_desc(&table, f, line) >= 0;
+        }
+        lines += table.lines[f];
+        ok &= table.length[f] < FRAME_TABLE_DESCS;
+        ok &= frame_table_samples(&table, f) ==
+              table.lines[f] * (uint32_t)VIDEO_LINE_SAMPLES - FRAME_TABLE_SLACK_SAMPLES;
+        active -= VBI_CODE_LINES;
+        ok &= active <= VIDEO_FIELD_ACTIVE_LINES && active + 5 >= VIDEO_FIELD_ACTIVE_LINES;
+        printf("  field %u: %u lines, %u descriptors, %u line buffers\n",
+               f, table.lines[f], table.length[f], active);
+    }
+    ok &= lines == VIDEO_TOTAL_LINES;
+    ok &= frame_table_line_desc(&table, 0, 0) < 0;
+    ok &= frame_table_line_desc(&table, 0, VBI_CODE_FIRST_LINE) >= 0;
+    return ok;
+}
+
+static bool test_sync(void) {
+    bool ok = true;
+
+    frame_table_init(&table);
+    player_init(&player);
+    for (uint32_t f = 0; f < TEST_FIELDS; f++) {
+        play_field(&player, f % VIDEO_FIELDS);
+    }
+
+    // The last field's line count is only complete at the next V-Sync
+    ok &= player.fields == TEST_FIELDS;
+    ok &= player.sep.resyncs == 0;
+    ok &= player.sep.counts[SYNC_PULSE_INVALID] == 0;
+    ok &= player.sep.counts[SYNC_PULSE_BROAD] == 5 * TEST_FIELDS;
+    for (uint32_t f = 0; f + 1 < player.fields; f++) {
+        ok &= player.parity[f] == f % VIDEO_FIELDS;
+        ok &= player.field_lines[f] == table.lines[f % VIDEO_FIELDS];
+    }
+    printf("  %u fields, first field %u lines\n", player.fields, player.field_lines[0]);
+    return ok;
+}
+
+static bool test_swap(void) {
+    static uint8_t line[VIDEO_LINE_SAMPLES];
+    uint32_t field_line = VIDEO_VBI_LINES + 10;
+    bool ok = true;
+
+    frame_table_init(&table);
+    memcpy(line, table.black, sizeof(line));
+    memset(line + VIDEO_ACTIVE_START, MARK_LEVEL, VIDEO_ACTIVE_SAMPLES);
+
+    int desc = frame_table_line_desc(&table, 0, field_line);
+    ok &= desc >= 0;
+    frame_table_set_line(&table, 0, desc, line);
+
+    player_init(&player);
+    play_field(&player, 0);
+    ok &= player.marked == VIDEO_ACTIVE_SAMPLES;
+    ok &= player.mark_start == field_line * VIDEO_LINE_SAMPLES + VIDEO_ACTIVE_START;
+
+    // Cleared back to black; a stale clear leaves a newer line alone
+    frame_table_clear_line(&table, 0, desc, line);
+    ok &= table.descs[0][desc].read_addr == table.black;
+    frame_table_set_line(&table, 0, desc, line);
+    frame_table_clear_line(&table, 0, desc, line + 1);
+    ok &= table.descs[0][desc].read_addr == line;
+    return ok;
+}
+
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+static bool test_rotate(void) {
+    static uint8_t line[VIDEO_LINE_SAMPLES];
+    static uint8_t played[VIDEO_LINE_SAMPLES];
+    uint32_t field_line = VIDEO_VBI_LINES + 10;
+    uint32_t cut = 100;
+    bool ok = true;
+
+    frame_table_init(&table);
+    for (uint32_t i = 0; i < VIDEO_LINE_SAMPLES; i++) {
+        line[i] = (uint8_t)(i * 7);
+    }
+
+    int desc = frame_table_line_desc(&table, 0, field_line);
+    ok &= desc >= 0;
+    frame_table_set_rotated(&table, 0, desc, line, line + VIDEO_ACTIVE_START, cut);
+    scramble_play_line(played, line, line + VIDEO_ACTIVE_START, cut);
+
+    // The line's descriptors play what the simulator HAL plays
+    uint32_t n = 0;
+    for (const frame_desc_t* d = &table.descs[0][desc]; n < VIDEO_LINE_SAMPLES; d++) {
+        for (uint32_t i = 0; i < d->count; i++, n++) {
+            ok &= d->read_addr[i] == played[n];
+        }
+    }
+    ok &= n == VIDEO_LINE_SAMPLES;
+    ok &= played[VIDEO_ACTIVE_START] == line[VIDEO_ACTIVE_START + cut];
+
+    // Field length unchanged; cleared back to black, split kept
+    ok &= frame_table_samples(&table, 0) ==
+          table.lines[0] * (uint32_t)VIDEO_LINE_SAMPLES - FRAME_TABLE_SLACK_SAMPLES;
+    frame_table_clear_line(&table, 0, desc, line + VIDEO_ACTIVE_START);
+    ok &= table.descs[0][desc].read_addr == table.black;
+    ok &= table.descs[0][desc + 2].read_addr == table.black + VIDEO_ACTIVE_START;
+    ok &= table.descs[0][desc + 2].count == cut;
+    return ok;
+}
+#endif
+
+int main(void) {
+    printf("Field descriptor table test (%s%s)\n\n", VIDEO_PROFILE_NAME,
+           SCRAMBLE_MODE == SCRAMBLE_ROTATE ? ", rotate" : "");
+
+    check(test_layout(), "Table layout");
+    check(test_sync(), "Sync train through the classifier");
+    check(test_swap(), "Line buffer swap");
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+    check(test_rotate(), "Rotated line swap");
+#endif
+
+    printf("\n%s\n", failures ? "FAILED" : "All tests passed");
+    return failures ? 1 : 0;
+}
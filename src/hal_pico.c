@@ -0,0 +1,291 @@
+/*
+ * PicoCrypt FPV - RP2040 HAL
+ */
+
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "pico/stdio_usb.h"
+#include "hardware/clocks.h"
+#include "hardware/flash.h"
+#include "hardware/irq.h"
+#include "hardware/structs/systick.h"
+#include "hardware/sync.h"
+#include "hardware/vreg.h"
+#include "tusb.h"
+
+#include "hal.h"
+
+#define SYNC_DMA_WORDS      0xFFFFFFFFu     // Over a day of edges, then re-armed
+
+// Key slots: the last sector of flash, clear of the program image
+#define KEY_STORE_OFFSET    (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+
+_Static_assert(HAL_KEY_STORE_BYTES == FLASH_SECTOR_SIZE, "Key store is one flash sector");
+
+// ===== SYNC EDGE TIMER PROGRAM =====
+// X counts down once per HAL_SYNC_TICK_CYCLES and is pushed (autopush,
+// 32 bits) at every falling and every rising edge of the jmp pin. The
+// end of each pulse also raises the state machine's IRQ flag (relative
+// index 0), a wake event; it costs the high time one cycle.
+//   0: jmp pin, 2      ; high: keep counting
+//   1: jmp 4           ; low: falling edge
+//   2: jmp x--, 0
+//   3: jmp 0           ; x wrapped
+//   4: in x, 32        ; stamp falling edge
+//   5: jmp pin, 8      ; high: rising edge
+//   6: jmp x--, 5
+//   7: jmp 5
+//   8: in x, 32        ; stamp rising edge
+//   9: irq nowait 0 rel ; pulse done, wrap to 0
+static const uint16_t sync_edge_timer_instructions[] = {
+    0x00c2, 0x0004, 0x0040, 0x0000, 0x4020, 0x00c8, 0x0045, 0x0005, 0x4020, 0xc010,
+};
+
+static const struct pio_program sync_edge_timer_program = {
+    .instructions = sync_edge_timer_instructions,
+    .length = 10,
+    .origin = -1,
+};
+
+// ===== WAKE HANDLERS =====
+// Acknowledge only: the line loops do the work once awake
+static PIO sync_wake_pio;
+static uint sync_wake_sm;
+
+static void __not_in_flash_func(sync_in_irq)(void) {
+    sync_wake_pio->irq = 1u << sync_wake_sm;
+}
+
+static void __not_in_flash_func(video_in_irq)(void) {
+    dma_hw->ints0 = dma_hw->ints0;
+}
+
+static void __not_in_flash_func(video_out_irq)(void) {
+    dma_hw->ints1 = dma_hw->ints1;
+}
+
+// ===== INITIALIZATION =====
+void hal_video_in_init(hal_video_in_t* in, PIO pio, uint sm, uint data_pin, uint clock_pin,
+                       uint sync_pin, const clock_plan_t* plan, uint32_t length) {
+    video_capture_init(&in->engine, pio, sm, data_pin, clock_pin, sync_pin, plan, length);
+}
+
+void hal_video_out_init(hal_video_out_t* out, PIO pio, uint sm, uint data_pin,
+                        const clock_plan_t* plan) {
+    video_output_init(&out->engine, pio, sm, data_pin, plan);
+}
+
+void hal_line_sum_init(hal_line_sum_t* sum) {
+    sum->dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config d = dma_channel_get_default_config(sum->dma_chan);
+    channel_config_set_transfer_data_size(&d, DMA_SIZE_8);
+    channel_config_set_read_increment(&d, true);
+    channel_config_set_write_increment(&d, false);
+    channel_config_set_sniff_enable(&d, true);
+    dma_channel_configure(sum->dma_chan, &d, &sum->sink, NULL, 0, false);
+    dma_sniffer_enable(sum->dma_chan, DMA_SNIFF_CTRL_CALC_VALUE_SUM, true);
+}
+
+void hal_sync_in_init(hal_sync_in_t* in, PIO pio, uint sm, uint pin) {
+    uint offset = pio_add_program(pio, &sync_edge_timer_program);
+    pio_sm_config c = pio_get_default_sm_config();
+
+    sm_config_set_wrap(&c, offset, offset + sync_edge_timer_program.length - 1);
+    sm_config_set_jmp_pin(&c, pin);
+    sm_config_set_in_pins(&c, pin);
+    sm_config_set_in_shift(&c, false, true, 32);    // Autopush every stamp
+    sm_config_set_fifo_join(&c, PIO_FIFO_JOIN_RX);
+    sm_config_set_clkdiv_int_frac(&c, 1, 0);        // Full clk_sys resolution
+
+    pio_gpio_init(pio, pin);
+    pio_sm_set_consecutive_pindirs(pio, sm, pin, 1, false);
+    pio_sm_init(pio, sm, offset, &c);
+
+    in->pio = pio;
+    in->sm = sm;
+    in->read = 0;
+    in->lost = 0;
+
+    // RX FIFO into the ring; the write address wraps on the ring size
+    in->dma_chan = dma_claim_unused_channel(true);
+    dma_channel_config d = dma_channel_get_default_config(in->dma_chan);
+    channel_config_set_transfer_data_size(&d, DMA_SIZE_32);
+    channel_config_set_read_increment(&d, false);
+    channel_config_set_write_increment(&d, true);
+    channel_config_set_ring(&d, true, __builtin_ctz(sizeof(in->ring)));
+    channel_config_set_dreq(&d, pio_get_dreq(pio, sm, false));
+    dma_channel_configure(in->dma_chan, &d, in->ring, &pio->rxf[sm], SYNC_DMA_WORDS, true);
+
+    pio_sm_set_enabled(pio, sm, true);
+}
+
+// ===== CLOCKS =====
+void hal_clock_apply(const clock_plan_t* plan) {
+    // VREG_VOLTAGE_x_yz are consecutive 50 mV steps
+    vreg_set_voltage(VREG_VOLTAGE_1_10 + ((int)plan->voltage_mv - 1100) / 50);
+    busy_wait_us(100);                              // Let the core supply settle
+    set_sys_clock_pll(plan->vco_khz * 1000, plan->postdiv1, plan->postdiv2);
+}
+
+// ===== WAKE EVENTS =====
+void hal_cycles_init(void) {
+    systick_hw->rvr = HAL_CYCLES_MASK;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;          // Enable, processor clock, no interrupt
+}
+
+void hal_sync_in_wake(hal_sync_in_t* in) {
+    uint irq = in->pio == pio0 ? PIO0_IRQ_0 : PIO1_IRQ_0;
+
+    sync_wake_pio = in->pio;
+    sync_wake_sm = in->sm;          // Relative flag 0 of state machines 0-3
+    pio_interrupt_clear(in->pio, in->sm);
+    pio_set_irq0_source_enabled(in->pio, (enum pio_interrupt_source)(pis_interrupt0 + in->sm),
+                                true);
+    irq_set_exclusive_handler(irq, sync_in_irq);
+    irq_set_enabled(irq, true);
+}
+
+void hal_video_in_wake(hal_video_in_t* in) {
+    for (int i = 0; i < 2; i++) {
+        dma_channel_set_irq0_enabled(in->engine.dma_chan[i], true);
+    }
+    irq_set_exclusive_handler(DMA_IRQ_0, video_in_irq);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+void hal_video_out_wake(hal_video_out_t* out) {
+    dma_channel_set_irq1_enabled(out->engine.data_chan, true);
+    irq_set_exclusive_handler(DMA_IRQ_1, video_out_irq);
+    irq_set_enabled(DMA_IRQ_1, true);
+}
+
+void __not_in_flash_func(hal_idle)(cpu_load_t* load) {
+    cpu_load_sleep(load, hal_cycles());
+    __wfe();
+    cpu_load_wake(load, hal_cycles());
+}
+
+// ===== TIME =====
+uint32_t __not_in_flash_func(hal_time_us)(void) {
+    return time_us_32();
+}
+
+uint32_t __not_in_flash_func(hal_core_num)(void) {
+    return get_core_num();
+}
+
+// ===== VIDEO INPUT =====
+// `length` is fixed at init; the engine captures whole lines
+bool __not_in_flash_func(hal_video_in_start)(hal_video_in_t* in, uint8_t* line,
+                                             uint32_t length) {
+    return video_capture_arm(&in->engine, line);
+}
+
+uint32_t __not_in_flash_func(hal_video_in_poll)(hal_video_in_t* in) {
+    return video_capture_poll(&in->engine);
+}
+
+// ===== LINE SUM =====
+// Unpaced: a line of bytes in about one clk_sys cycle each
+void __not_in_flash_func(hal_line_sum_start)(hal_line_sum_t* sum, const uint8_t* data,
+                                             uint32_t length) {
+    dma_hw->sniff_data = 0;
+    dma_channel_transfer_from_buffer_now(sum->dma_chan, data, length);
+}
+
+uint32_t __not_in_flash_func(hal_line_sum_finish)(hal_line_sum_t* sum) {
+    dma_channel_wait_for_finish_blocking(sum->dma_chan);
+    return dma_hw->sniff_data;
+}
+
+// ===== SYNC EDGE TIMER =====
+uint32_t hal_sync_in_tick_hz(const hal_sync_in_t* in) {
+    return clock_get_hz(clk_sys) / HAL_SYNC_TICK_CYCLES;
+}
+
+uint32_t __not_in_flash_func(hal_sync_in_read)(hal_sync_in_t* in, uint32_t* words,
+                                               uint32_t max) {
+    uint32_t written = SYNC_DMA_WORDS - dma_hw->ch[in->dma_chan].transfer_count;
+    uint32_t count = 0;
+
+    // Overwritten before they were read: skip them, the classifier re-pairs
+    if (written - in->read > HAL_SYNC_RING_WORDS) {
+        in->lost += written - in->read - HAL_SYNC_RING_WORDS;
+        in->read = written - HAL_SYNC_RING_WORDS;
+    }
+    while (count < max && in->read != written) {
+        words[count++] = in->ring[in->read++ & (HAL_SYNC_RING_WORDS - 1)];
+    }
+
+    // Transfer count used up: restart at the top of the ring
+    if (in->read == written && !dma_channel_is_busy(in->dma_chan)) {
+        dma_channel_set_write_addr(in->dma_chan, in->ring, false);
+        dma_channel_set_trans_count(in->dma_chan, SYNC_DMA_WORDS, true);
+        in->read = 0;
+    }
+
+    return count;
+}
+
+// ===== VIDEO OUTPUT =====
+void __not_in_flash_func(hal_video_out_field)(hal_video_out_t* out) {
+    video_output_field(&out->engine);
+}
+
+bool __not_in_flash_func(hal_video_out_submit)(hal_video_out_t* out, const uint8_t* line,
+                                               uint32_t length) {
+    return video_output_submit(&out->engine, line, length);
+}
+
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+bool __not_in_flash_func(hal_video_out_submit_rotated)(hal_video_out_t* out, const uint8_t* head,
+                                                       const uint8_t* active, uint32_t cut) {
+    return video_output_submit_rotated(&out->engine, head, active, cut);
+}
+#endif
+
+uint32_t __not_in_flash_func(hal_video_out_poll)(hal_video_out_t* out) {
+    return video_output_poll(&out->engine);
+}
+
+// ===== KEY STORE =====
+const uint8_t* hal_key_store_read(void) {
+    return (const uint8_t*)(XIP_BASE + KEY_STORE_OFFSET);
+}
+
+// Core 0 must have called multicore_lockout_victim_init(). XIP is off
+// while the flash is busy, so core 0 waits in RAM and this core runs
+// with interrupts off; `image` must be in RAM. The lockout handshake
+// shares the FIFO with the doorbells: one dropped meanwhile is harmless,
+// the next drains the queue.
+bool hal_key_store_write(const uint8_t* image, uint32_t length) {
+    if (length == 0 || length > HAL_KEY_STORE_BYTES || length % FLASH_PAGE_SIZE != 0) {
+        return false;
+    }
+    multicore_lockout_start_blocking();
+    uint32_t irq = save_and_disable_interrupts();
+    flash_range_erase(KEY_STORE_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(KEY_STORE_OFFSET, image, length);
+    restore_interrupts(irq);
+    multicore_lockout_end_blocking();
+
+    return memcmp(hal_key_store_read(), image, length) == 0;
+}
+
+// ===== DEBUG CHANNEL =====
+// Same CDC interface as stdio_usb, whose USB task runs from core 0's
+// IRQ. Writes go through the stdio_usb driver so they hold its mutex
+// whichever core drains; out_chars skips stdio's CR/LF translation.
+// Only the drain fills the TX FIFO and tud_task only empties it, so an
+// unlocked room reading can go stale but never too high, and a write
+// of at most that much never waits for the host.
+uint32_t hal_debug_room(void) {
+    return stdio_usb_connected() ? tud_cdc_write_available() : 0;
+}
+
+void hal_debug_write(const uint8_t* data, uint32_t length) {
+    stdio_usb.out_chars((const char*)data, (int)length);
+}
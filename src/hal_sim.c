@@ -0,0 +1,142 @@
+/*
+ * PicoCrypt FPV - Simulator HAL (host)
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+static uint32_t sim_time_us = 0;
+static hal_sim_sink_t debug_sink = NULL;
+static void* debug_context = NULL;
+static uint8_t key_store[HAL_KEY_STORE_BYTES];
+static bool key_store_ready = false;
+
+// ===== SIMULATION CONTROL =====
+void hal_sim_video_in_init(hal_video_in_t* in) {
+    in->source = NULL;
+    in->finished = 0;
+    in->captures = 0;
+}
+
+void hal_sim_video_out_init(hal_video_out_t* out, hal_sim_sink_t sink, void* context) {
+    out->sink = sink;
+    out->context = context;
+    out->finished = 0;
+    out->lines = 0;
+    out->fields = 0;
+}
+
+void hal_sim_line_sum_init(hal_line_sum_t* sum) {
+    sum->value = 0;
+    sum->sums = 0;
+}
+
+void hal_sim_set_time_us(uint32_t now_us) {
+    sim_time_us = now_us;
+}
+
+void hal_sim_set_debug_sink(hal_sim_sink_t sink, void* context) {
+    debug_sink = sink;
+    debug_context = context;
+}
+
+// ===== TIME =====
+uint32_t hal_time_us(void) {
+    return sim_time_us;
+}
+
+uint32_t hal_core_num(void) {
+    // Both simulated cores run on the calling thread
+    return 0;
+}
+
+// ===== VIDEO INPUT =====
+bool hal_video_in_start(hal_video_in_t* in, uint8_t* line, uint32_t length) {
+    if (in->source) {
+        memcpy(line, in->source, length);
+    } else {
+        memset(line, 0, length);
+    }
+    in->finished++;
+    in->captures++;
+    return true;
+}
+
+uint32_t hal_video_in_poll(hal_video_in_t* in) {
+    uint32_t finished = in->finished;
+    in->finished = 0;
+    return finished;
+}
+
+// ===== VIDEO OUTPUT =====
+void hal_video_out_field(hal_video_out_t* out) {
+    out->fields++;
+}
+
+bool hal_video_out_submit(hal_video_out_t* out, const uint8_t* line, uint32_t length) {
+    if (out->sink) {
+        out->sink(out->context, line, length);
+    }
+    out->finished++;
+    out->lines++;
+    return true;
+}
+
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+bool hal_video_out_submit_rotated(hal_video_out_t* out, const uint8_t* head,
+                                  const uint8_t* active, uint32_t cut) {
+    // The sink sees the line as the output DMA would play it
+    scramble_play_line(out->played, head, active, cut);
+    return hal_video_out_submit(out, out->played, VIDEO_LINE_SAMPLES);
+}
+#endif
+
+uint32_t hal_video_out_poll(hal_video_out_t* out) {
+    uint32_t finished = out->finished;
+    out->finished = 0;
+    return finished;
+}
+
+// ===== LINE SUM =====
+void hal_line_sum_start(hal_line_sum_t* sum, const uint8_t* data, uint32_t length) {
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        value += data[i];
+    }
+    sum->value = value;
+    sum->sums++;
+}
+
+uint32_t hal_line_sum_finish(hal_line_sum_t* sum) {
+    return sum->value;
+}
+
+// ===== KEY STORE =====
+// Erased on first use, kept for the life of the process
+const uint8_t* hal_key_store_read(void) {
+    if (!key_store_ready) {
+        memset(key_store, 0xFF, sizeof(key_store));
+        key_store_ready = true;
+    }
+    return key_store;
+}
+
+bool hal_key_store_write(const uint8_t* image, uint32_t length) {
+    if (length == 0 || length > HAL_KEY_STORE_BYTES || length % 256 != 0) {
+        return false;
+    }
+    memset(key_store, 0xFF, sizeof(key_store));
+    memcpy(key_store, image, length);
+    key_store_ready = true;
+    return true;
+}
+
+// ===== DEBUG CHANNEL =====
+uint32_t hal_debug_room(void) {
+    return debug_sink ? 4096 : 0;
+}
+
+void hal_debug_write(const uint8_t* data, uint32_t length) {
+    debug_sink(debug_context, data, length);
+}
@@ -0,0 +1,204 @@
+/*
+ * PicoCrypt FPV - Key Slots
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "key_slots.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Key slot image layout assumes a little-endian target"
+#endif
+
+// ===== IMAGE LAYOUT =====
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t boot_slot;
+    uint8_t valid;                      // Bit per slot
+    crypto_key_t keys[KEY_SLOTS];
+    uint32_t check;                     // CRC-32 of everything above
+} key_slots_image_t;
+
+_Static_assert(sizeof(key_slots_image_t) <= KEY_SLOTS_IMAGE_BYTES, "Key slot image too large");
+_Static_assert(KEY_SLOTS <= 8, "Valid bits are one byte");
+
+// Reflected CRC-32 (IEEE), bit at a time: only run at boot and on save
+static uint32_t crc32(const uint8_t* data, uint32_t length) {
+    uint32_t crc = 0xFFFFFFFFu;
+
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+// ===== SLOTS =====
+bool key_slots_load(key_slots_t* slots, const uint8_t* image, const crypto_key_t* fallback) {
+    key_slots_image_t stored;
+    memcpy(&stored, image, sizeof(stored));
+
+    memset(slots, 0, sizeof(*slots));
+    bool ok = stored.magic == KEY_SLOTS_MAGIC && stored.version == KEY_SLOTS_VERSION &&
+              stored.check == crc32(image, offsetof(key_slots_image_t, check)) &&
+              stored.boot_slot < KEY_SLOTS && (stored.valid >> stored.boot_slot) & 1;
+    if (!ok) {
+        key_slots_set(slots, 0, fallback);
+        return false;
+    }
+
+    memcpy(slots->keys, stored.keys, sizeof(slots->keys));
+    slots->valid = stored.valid & ((1u << KEY_SLOTS) - 1);
+    slots->boot_slot = stored.boot_slot;
+    return true;
+}
+
+void key_slots_save(const key_slots_t* slots, uint8_t image[KEY_SLOTS_IMAGE_BYTES]) {
+    key_slots_image_t stored;
+
+    memset(&stored, 0, sizeof(stored));
+    stored.magic = KEY_SLOTS_MAGIC;
+    stored.version = KEY_SLOTS_VERSION;
+    stored.boot_slot = (uint8_t)slots->boot_slot;
+    stored.valid = (uint8_t)slots->valid;
+    memcpy(stored.keys, slots->keys, sizeof(stored.keys));
+
+    memset(image, 0xFF, KEY_SLOTS_IMAGE_BYTES);
+    memcpy(image, &stored, sizeof(stored));
+    stored.check = crc32(image, offsetof(key_slots_image_t, check));
+    memcpy(image + offsetof(key_slots_image_t, check), &stored.check, sizeof(stored.check));
+}
+
+bool key_slots_set(key_slots_t* slots, uint32_t slot, const crypto_key_t* key) {
+    if (slot >= KEY_SLOTS) {
+        return false;
+    }
+    slots->keys[slot] = *key;
+    slots->valid |= 1u << slot;
+    return true;
+}
+
+const crypto_key_t* key_slots_get(const key_slots_t* slots, uint32_t slot) {
+    if (slot >= KEY_SLOTS || !((slots->valid >> slot) & 1)) {
+        return NULL;
+    }
+    return &slots->keys[slot];
+}
+
+// ===== USB COMMANDS =====
+static const char* skip_spaces(const char* p) {
+    while (*p == ' ' || *p == '\t') {
+        p++;
+    }
+    return p;
+}
+
+// Start of the next space-separated field, or NULL if nothing separates it
+static const char* next_field(const char* p) {
+    const char* field = skip_spaces(p);
+    return field != p ? field : NULL;
+}
+
+// Decimal field; NULL if there is none or it overflows 32 bits
+static const char* parse_decimal(const char* p, uint32_t* value) {
+    uint64_t v = 0;
+
+    p = next_field(p);
+    if (!p || *p < '0' || *p > '9') {
+        return NULL;
+    }
+    while (*p >= '0' && *p <= '9') {
+        v = v * 10 + (uint32_t)(*p++ - '0');
+        if (v > 0xFFFFFFFFu) {
+            return NULL;
+        }
+    }
+    *value = (uint32_t)v;
+    return p;
+}
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+static const char* parse_key(const char* p, crypto_key_t* key) {
+    const char* start = next_field(p);
+    uint32_t digits = 0;
+
+    if (!start) {
+        return NULL;
+    }
+    p = start;
+    while (hex_digit(*p) >= 0) {
+        p++;
+        digits++;
+    }
+
+    if (digits == 16) {
+        // As written in the source: most significant digit first
+        uint64_t key64 = 0;
+        for (uint32_t i = 0; i < digits; i++) {
+            key64 = (key64 << 4) | (uint32_t)hex_digit(start[i]);
+        }
+        crypto_key_from_u64(key, key64);
+        return p;
+    }
+    if (digits == CRYPTO_KEY_WORDS * 8) {
+        // Key bytes in order, words little-endian
+        memset(key, 0, sizeof(*key));
+        for (uint32_t i = 0; i < digits / 2; i++) {
+            uint32_t byte = (uint32_t)(hex_digit(start[2 * i]) << 4 | hex_digit(start[2 * i + 1]));
+            key->words[i / 4] |= byte << (8 * (i % 4));
+        }
+        return p;
+    }
+    return NULL;
+}
+
+key_command_type_t key_slots_parse_command(const char* line, key_command_t* command) {
+    const char* p = skip_spaces(line);
+
+    memset(command, 0, sizeof(*command));
+    switch (*p) {
+    case '\0':
+        command->type = KEY_COMMAND_NONE;
+        return command->type;
+    case 's':
+        p = parse_decimal(p + 1, &command->slot);
+        p = p ? parse_key(p, &command->key) : NULL;
+        command->type = KEY_COMMAND_SET;
+        break;
+    case 'k':
+        p = parse_decimal(p + 1, &command->slot);
+        p = p ? parse_decimal(p, &command->frame) : NULL;
+        command->type = KEY_COMMAND_REKEY;
+        break;
+    case 'w':
+        p++;
+        command->type = KEY_COMMAND_WRITE;
+        break;
+    default:
+        p = NULL;
+        break;
+    }
+
+    // Nothing may follow; a key typed wrong must not half-apply
+    if (!p || *skip_spaces(p) != '\0' || command->slot >= KEY_SLOTS) {
+        memset(command, 0, sizeof(*command));
+        command->type = KEY_COMMAND_ERROR;
+    }
+    return command->type;
+}
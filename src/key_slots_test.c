@@ -0,0 +1,138 @@
+/*
+ * PicoCrypt FPV - Key Slots Test (host)
+ * Stored image round trip, blank and damaged images, USB key commands
+ *
+ * A saved image must load back every slot and the boot slot; a blank
+ * sector or any damaged byte must fall back to the build-time key alone.
+ * Command lines must parse to the slot, frame and key they name, and
+ * anything malformed must be rejected whole.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "key_slots.h"
+
+#define TEST_KEY            0x123456789ABCDEF0ULL
+
+static int failures = 0;
+
+static void check(bool ok, const char* name) {
+    printf("%-40s %s\n", name, ok ? "OK" : "ERROR");
+    if (!ok) {
+        failures++;
+    }
+}
+
+static bool same_key(const crypto_key_t* a, const crypto_key_t* b) {
+    return a && b && memcmp(a, b, sizeof(*a)) == 0;
+}
+
+// ===== TESTS =====
+static bool test_round_trip(void) {
+    static uint8_t image[KEY_SLOTS_IMAGE_BYTES];
+    key_slots_t slots = { .valid = 0 }, loaded;
+    crypto_key_t fallback;
+    bool ok = true;
+
+    crypto_key_from_u64(&fallback, TEST_KEY);
+    for (uint32_t slot = 1; slot < KEY_SLOTS; slot++) {
+        crypto_key_t key;
+        crypto_key_from_u64(&key, TEST_KEY * (slot + 3));
+        ok &= key_slots_set(&slots, slot, &key);
+    }
+    slots.boot_slot = 2;
+    key_slots_save(&slots, image);
+
+    ok &= key_slots_load(&loaded, image, &fallback);
+    ok &= loaded.boot_slot == 2 && loaded.valid == slots.valid;
+    ok &= key_slots_get(&loaded, 0) == NULL;
+    for (uint32_t slot = 1; slot < KEY_SLOTS; slot++) {
+        ok &= same_key(key_slots_get(&loaded, slot), key_slots_get(&slots, slot));
+    }
+    ok &= image[KEY_SLOTS_IMAGE_BYTES - 1] == 0xFF;
+    return ok;
+}
+
+static bool test_fallback(void) {
+    static uint8_t image[KEY_SLOTS_IMAGE_BYTES];
+    key_slots_t slots = { .valid = 0 }, loaded;
+    crypto_key_t fallback, key;
+    bool ok = true;
+
+    // Blank sector
+    crypto_key_from_u64(&fallback, TEST_KEY);
+    memset(image, 0xFF, sizeof(image));
+    ok &= !key_slots_load(&loaded, image, &fallback);
+    ok &= loaded.valid == 1 && loaded.boot_slot == 0;
+    ok &= same_key(key_slots_get(&loaded, 0), &fallback);
+
+    // Every damaged byte of a good image
+    crypto_key_from_u64(&key, ~TEST_KEY);
+    key_slots_set(&slots, 3, &key);
+    slots.boot_slot = 3;
+    key_slots_save(&slots, image);
+    for (uint32_t i = 0; i < 4 + 4 + KEY_SLOTS * sizeof(crypto_key_t) + 4; i++) {
+        image[i] ^= 0x10;
+        ok &= !key_slots_load(&loaded, image, &fallback);
+        ok &= loaded.valid == 1 && same_key(key_slots_get(&loaded, 0), &fallback);
+        image[i] ^= 0x10;
+    }
+    ok &= key_slots_load(&loaded, image, &fallback);
+
+    // Boot slot without a key
+    slots.boot_slot = 1;
+    key_slots_save(&slots, image);
+    ok &= !key_slots_load(&loaded, image, &fallback);
+    return ok;
+}
+
+static bool test_commands(void) {
+    key_command_t command;
+    crypto_key_t key;
+    bool ok = true;
+
+    // 64-bit key as written in the source, expanded like PRESHARED_KEY
+    crypto_key_from_u64(&key, TEST_KEY);
+    ok &= key_slots_parse_command("s 1 123456789abcdef0", &command) == KEY_COMMAND_SET;
+    ok &= command.slot == 1 && same_key(&command.key, &key);
+
+    // 256-bit key, bytes in order
+    ok &= key_slots_parse_command(" s 3  000102030405060708090A0B0C0D0E0F"
+                                  "101112131415161718191a1b1c1d1e1f ", &command) ==
+          KEY_COMMAND_SET;
+    ok &= command.slot == 3 && command.key.words[0] == 0x03020100u &&
+          command.key.words[7] == 0x1F1E1D1Cu;
+
+    ok &= key_slots_parse_command("k 2 4294967295", &command) == KEY_COMMAND_REKEY;
+    ok &= command.slot == 2 && command.frame == 0xFFFFFFFFu;
+    ok &= key_slots_parse_command("w", &command) == KEY_COMMAND_WRITE;
+    ok &= key_slots_parse_command("  ", &command) == KEY_COMMAND_NONE;
+
+    // Rejected whole: wrong slot, short or long key, junk, missing fields
+    static const char* bad[] = {
+        "s 4 123456789abcdef0", "s 1 123456789abcdef", "s 1 123456789abcdef01",
+        "s 1 123456789abcdefg", "s1 123456789abcdef0", "s 1", "k 1", "k 1 2 3",
+        "k 1 4294967296", "k 1 -5", "w now", "x", "s 11234567890abcdef0",
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        bool rejected = key_slots_parse_command(bad[i], &command) == KEY_COMMAND_ERROR;
+        if (!rejected) {
+            printf("  accepted: \"%s\"\n", bad[i]);
+        }
+        ok &= rejected && command.slot == 0;
+    }
+    return ok;
+}
+
+int main(void) {
+    printf("Key slots test: %d slots, %d-byte image\n\n", KEY_SLOTS, KEY_SLOTS_IMAGE_BYTES);
+
+    check(test_round_trip(), "Saved image loads back");
+    check(test_fallback(), "Blank or damaged image falls back");
+    check(test_commands(), "USB key commands");
+
+    printf("\n%s\n", failures ? "FAILED" : "All tests passed");
+    return failures ? 1 : 0;
+}
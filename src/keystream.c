@@ -0,0 +1,69 @@
+/*
+ * PicoCrypt FPV - Keystream Prefetch Ring
+ */
+
+#include <string.h>
+
+#include "keystream.h"
+#include "platform.h"
+
+void keystream_ring_init(keystream_ring_t* ring, size_t length, size_t extra) {
+    if (length > KEYSTREAM_MAX_WIDTH) {
+        length = KEYSTREAM_MAX_WIDTH;
+    }
+    if (extra > KEYSTREAM_MAX_EXTRA) {
+        extra = KEYSTREAM_MAX_EXTRA;
+    }
+    ring->length = length;
+    ring->extra = extra;
+    keystream_ring_reset(ring);
+}
+
+void PICOCRYPT_RAM_FUNC(keystream_ring_reset)(keystream_ring_t* ring) {
+    ring->head = 0;
+    ring->tail = 0;
+}
+
+uint32_t PICOCRYPT_RAM_FUNC(keystream_prefetch)(keystream_ring_t* ring, prng_state_t* prng,
+                                                uint32_t max_lines) {
+    uint32_t filled = 0;
+
+    while (filled < max_lines && keystream_ring_count(ring) < KEYSTREAM_RING_LINES) {
+        uint8_t* slot = ring->lines[ring->head & (KEYSTREAM_RING_LINES - 1)];
+        crypto_keystream_line(prng, slot, ring->length + ring->extra);
+        ring->head++;
+        filled++;
+    }
+
+    return filled;
+}
+
+bool PICOCRYPT_RAM_FUNC(keystream_xor_line)(keystream_ring_t* ring, const uint8_t* input,
+                                            uint8_t* output, size_t length, uint8_t* extra) {
+    if (keystream_ring_count(ring) == 0 || length != ring->length) {
+        return false;
+    }
+
+    const uint8_t* slot = ring->lines[ring->tail & (KEYSTREAM_RING_LINES - 1)];
+    crypto_xor_buffers(input, slot, output, length);
+    if (extra) {
+        memcpy(extra, slot + length, ring->extra);
+    }
+    ring->tail++;
+
+    return true;
+}
+
+void PICOCRYPT_RAM_FUNC(keystream_xor_inline)(keystream_ring_t* ring, prng_state_t* prng,
+                                              const uint8_t* input, uint8_t* output,
+                                              size_t length, uint8_t* extra) {
+    uint32_t frame = prng->sync_counter;
+    uint32_t line = prng->line;
+
+    crypto_xor_line(prng, input, output, length);
+    if (extra && ring->extra) {
+        // Back into the same line for the bytes after the XORed ones
+        crypto_seek(prng, frame, line, (uint32_t)length);
+        crypto_keystream_line(prng, extra, ring->extra);
+    }
+}
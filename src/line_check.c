@@ -0,0 +1,101 @@
+/*
+ * PicoCrypt FPV - Line Check
+ */
+
+#include "line_check.h"
+#include "platform.h"
+#include "scramble.h"
+
+#define CHIP_SLICE      ((PILOT_LEVEL_0 + PILOT_LEVEL_1) / 2)
+#define PILOT_CHIP(k)   ((PILOT_CODE >> (PILOT_CHIPS - 1 - (k))) & 1)
+
+// Decrypted error per code of mean absolute ciphertext error (XOR
+// carries, see the header): the mean at most (a black or white picture),
+// and the variance in codes^2
+#define XOR_BIAS        8
+#define XOR_VARIANCE    170
+
+// Summed chip deviations about their mean, per code of deviation about
+// the true level: ONES^2 * sqrt((ONES - 1) / ONES)
+#define SPREAD_SCALE    76
+
+_Static_assert(PILOT_ONES == 9, "SPREAD_SCALE assumes 9 one chips");
+
+uint32_t PICOCRYPT_RAM_FUNC(line_check_mask)(const uint8_t* key) {
+    return ((uint32_t)key[0] | (uint32_t)key[1] << 8) & LINE_CHECK_MASK;
+}
+
+void PICOCRYPT_RAM_FUNC(line_check_write)(uint8_t* line, uint32_t sum, uint32_t mask) {
+    uint32_t check = ((sum >> LINE_CHECK_SHIFT) ^ mask) & LINE_CHECK_MASK;
+
+    // Most significant bit first
+    for (uint32_t k = 0; k < LINE_CHECK_BITS; k++) {
+        uint32_t bit = (check >> (LINE_CHECK_BITS - 1 - k)) & 1;
+        line[LINE_CHECK_START + k] = bit ? PILOT_LEVEL_1 : PILOT_LEVEL_0;
+    }
+}
+
+uint32_t PICOCRYPT_RAM_FUNC(line_check_read)(const uint8_t* line, int32_t offset) {
+    const uint8_t* chips = line + LINE_CHECK_START + offset;
+    uint32_t check = 0;
+
+    for (uint32_t k = 0; k < LINE_CHECK_BITS; k++) {
+        check = (check << 1) | (chips[k] >= CHIP_SLICE);
+    }
+    return check;
+}
+
+uint32_t PICOCRYPT_RAM_FUNC(line_check_noise)(const uint8_t* line, int32_t offset) {
+    const uint8_t* chips = line + PILOT_START + offset;
+    uint32_t total = 0, spread = 0;
+
+    // About the chips' own mean, so a link offset is not noise;
+    // the one chips sit clear of the clipping at code 0
+    for (uint32_t k = 0; k < PILOT_CHIPS; k++) {
+        total += PILOT_CHIP(k) ? chips[k] : 0;
+    }
+    for (uint32_t k = 0; k < PILOT_CHIPS; k++) {
+        if (PILOT_CHIP(k)) {
+            int32_t d = (int32_t)(chips[k] * PILOT_ONES) - (int32_t)total;
+            spread += (uint32_t)(d < 0 ? -d : d);
+        }
+    }
+
+    return spread * LINE_CHECK_NOISE_ONE / SPREAD_SCALE;
+}
+
+static uint32_t isqrt(uint32_t v) {
+    uint32_t root = 0;
+
+    for (uint32_t bit = 1u << 30; bit; bit >>= 2) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+    }
+    return root;
+}
+
+uint32_t PICOCRYPT_RAM_FUNC(line_check_tolerance)(uint32_t noise) {
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+    // Rotation moves samples, not noise: rms about 1.25 times the mean
+    // absolute deviation on each of them
+    uint32_t bias = 0;
+    uint32_t sigma = isqrt(VIDEO_ACTIVE_SAMPLES * noise * noise) * 5 / (4 * LINE_CHECK_NOISE_ONE);
+#else
+    uint32_t bias = VIDEO_ACTIVE_SAMPLES * XOR_BIAS * noise / LINE_CHECK_NOISE_ONE;
+    uint32_t sigma = isqrt(VIDEO_ACTIVE_SAMPLES * XOR_VARIANCE / LINE_CHECK_NOISE_ONE * noise);
+#endif
+    return LINE_CHECK_TOLERANCE + bias + LINE_CHECK_SIGMAS * sigma;
+}
+
+bool PICOCRYPT_RAM_FUNC(line_check_match)(uint32_t check, uint32_t sum, uint32_t tolerance) {
+    // Distance modulo the check, in check units; a sum next to a unit
+    // boundary may truncate either way, hence the extra unit
+    uint32_t units = (tolerance >> LINE_CHECK_SHIFT) + 1;
+    uint32_t d = (((sum >> LINE_CHECK_SHIFT) - check) & LINE_CHECK_MASK);
+
+    return d <= units || LINE_CHECK_MASK + 1 - d <= units;
+}
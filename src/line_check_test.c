@@ -0,0 +1,261 @@
+/*
+ * PicoCrypt FPV - Line Check Test (host)
+ * Chips round trip, link noise estimate and tolerance, wrong-keystream
+ * misses, masking
+ *
+ * The check written into a sync tip must read back at every pilot offset.
+ * Lines go over a modelled XOR link: the picture is encrypted, Gaussian
+ * noise hits every sample of the line (sync tip chips and ciphertext
+ * alike), and the receiver decrypts. The noise read off the pilot must
+ * track the noise that hit the samples, a line that only met noise must
+ * pass at the tolerance that noise gives, and a line decrypted with the
+ * wrong keystream (mask included) must fail but for the chance that a
+ * random check lands within the tolerance. The chips on the link must
+ * not follow the picture's sum.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "line_check.h"
+
+#define TRIALS          10000
+#define ESTIMATE_LINES  256         // Lines in the noise estimate, as the receiver's mean
+
+static int failures = 0;
+static uint8_t picture[VIDEO_ACTIVE_SAMPLES];
+static uint8_t keystream[VIDEO_ACTIVE_SAMPLES];
+static uint8_t check_key[LINE_CHECK_KEY_BYTES];     // Keystream after the picture's
+static uint8_t line[VIDEO_LINE_SAMPLES];
+static uint32_t rng = 0x2545F491u;
+static double noise_abs;            // Sum of |noise| added to the pilot's one chips
+static uint32_t noise_samples;
+
+static void check(bool ok, const char* name) {
+    printf("%-40s %s\n", name, ok ? "OK" : "ERROR");
+    if (!ok) {
+        failures++;
+    }
+}
+
+static uint32_t xorshift32(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+static double gaussian(void) {
+    double u = (xorshift32() + 1.0) / 4294967297.0;
+    double v = xorshift32() / 4294967296.0;
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static uint32_t picture_sum(const uint8_t* active) {
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < VIDEO_ACTIVE_SAMPLES; i++) {
+        sum += active[i];
+    }
+    return sum;
+}
+
+// A picture of random brightness and detail, and a fresh keystream
+static void make_picture(void) {
+    uint32_t base = xorshift32() % 200;
+    for (uint32_t i = 0; i < VIDEO_ACTIVE_SAMPLES; i++) {
+        picture[i] = (uint8_t)(base + (i * 5 + (xorshift32() & 15)) % 56);
+        keystream[i] = (uint8_t)xorshift32();
+    }
+    for (uint32_t i = 0; i < LINE_CHECK_KEY_BYTES; i++) {
+        check_key[i] = (uint8_t)xorshift32();
+    }
+}
+
+// Sender and link: sync tip with pilot and check, encrypted picture,
+// then Gaussian noise on every sample
+static void send_line(double link_noise) {
+    uint8_t* active = line + VIDEO_ACTIVE_START;
+
+    memset(line, PILOT_LEVEL_0, VIDEO_ACTIVE_START);
+    pilot_write(line);
+    line_check_write(line, picture_sum(picture), line_check_mask(check_key));
+    for (uint32_t i = 0; i < VIDEO_ACTIVE_SAMPLES; i++) {
+        active[i] = picture[i] ^ keystream[i];
+    }
+    if (link_noise <= 0.0) {
+        return;
+    }
+    for (uint32_t i = 0; i < VIDEO_ACTIVE_START + VIDEO_ACTIVE_SAMPLES; i++) {
+        long v = lrint(line[i] + link_noise * gaussian());
+        v = v < 0 ? 0 : v > 255 ? 255 : v;
+        if (i >= PILOT_START && i < PILOT_START + PILOT_CHIPS && line[i] == PILOT_LEVEL_1) {
+            noise_abs += fabs((double)v - line[i]);
+            noise_samples++;
+        }
+        line[i] = (uint8_t)v;
+    }
+}
+
+// Receiver: sum of the picture decrypted with `key`
+static uint32_t received_sum(const uint8_t* key) {
+    static uint8_t decrypted[VIDEO_ACTIVE_SAMPLES];
+    for (uint32_t i = 0; i < VIDEO_ACTIVE_SAMPLES; i++) {
+        decrypted[i] = line[VIDEO_ACTIVE_START + i] ^ key[i];
+    }
+    return picture_sum(decrypted);
+}
+
+// Receiver's link noise estimate: mean over a run of lines
+static uint32_t estimate_noise(double link_noise) {
+    uint32_t total = 0;
+    for (uint32_t n = 0; n < ESTIMATE_LINES; n++) {
+        make_picture();
+        send_line(link_noise);
+        total += line_check_noise(line, 0);
+    }
+    return total / ESTIMATE_LINES;
+}
+
+// ===== TESTS =====
+static bool test_round_trip(void) {
+    static uint8_t buffer[VIDEO_LINE_SAMPLES + 2 * PILOT_SEARCH];
+    bool ok = true;
+
+    for (uint32_t trial = 0; trial < 64; trial++) {
+        uint32_t sum = xorshift32() % (VIDEO_ACTIVE_SAMPLES * 255 + 1);
+        uint32_t mask = xorshift32() & LINE_CHECK_MASK;
+        for (int32_t offset = -PILOT_SEARCH; offset <= PILOT_SEARCH; offset++) {
+            // Content `offset` samples later in the captured buffer
+            uint8_t* content = buffer + PILOT_SEARCH + offset;
+            memset(buffer, PILOT_LEVEL_0, sizeof(buffer));
+            pilot_write(content);
+            line_check_write(content, sum, mask);
+            uint32_t check = line_check_read(buffer + PILOT_SEARCH, offset) ^ mask;
+            ok &= check == ((sum >> LINE_CHECK_SHIFT) & LINE_CHECK_MASK);
+            ok &= line_check_match(check, sum, line_check_tolerance(0));
+            ok &= line_check_noise(buffer + PILOT_SEARCH, offset) == 0;
+        }
+    }
+    return ok;
+}
+
+static bool test_noise_estimate(void) {
+    static const double levels[] = { 1.0, 2.0, 5.0, 8.0 };
+    bool ok = true;
+
+    for (size_t n = 0; n < sizeof(levels) / sizeof(levels[0]); n++) {
+        noise_abs = 0.0;
+        noise_samples = 0;
+        double estimate = (double)estimate_noise(levels[n]) / LINE_CHECK_NOISE_ONE;
+        double actual = noise_abs / noise_samples;
+        printf("  link noise %.1f codes rms: mean |noise| %.2f, estimated %.2f\n",
+               levels[n], actual, estimate);
+        ok &= fabs(estimate - actual) <= 0.1 * actual;
+    }
+    return ok;
+}
+
+static bool test_link_noise(void) {
+    static const double levels[] = { 0.5, 1.0, 2.0, 3.0 };
+    bool ok = true;
+
+    for (size_t n = 0; n < sizeof(levels) / sizeof(levels[0]); n++) {
+        uint32_t tolerance = line_check_tolerance(estimate_noise(levels[n]));
+        uint32_t passed = 0;
+        for (uint32_t trial = 0; trial < TRIALS; trial++) {
+            make_picture();
+            send_line(levels[n]);
+            uint32_t check = line_check_read(line, 0) ^ line_check_mask(check_key);
+            passed += line_check_match(check, received_sum(keystream), tolerance);
+        }
+        printf("  link noise %.1f codes rms: tolerance %u, %u/%u lines pass\n", levels[n],
+               tolerance, passed, TRIALS);
+
+        // Noise alone fails next to none; a misread chip fails the odd line
+        ok &= passed >= TRIALS - TRIALS / 1000;
+    }
+    return ok;
+}
+
+static bool test_wrong_keystream(void) {
+    static const double levels[] = { 0.0, 2.0 };
+    static uint8_t wrong[VIDEO_ACTIVE_SAMPLES + LINE_CHECK_KEY_BYTES];
+    bool ok = true;
+
+    for (size_t n = 0; n < sizeof(levels) / sizeof(levels[0]); n++) {
+        uint32_t tolerance = line_check_tolerance(estimate_noise(levels[n]));
+        // The wrong mask leaves a random check: it passes if it lands
+        // within the tolerance, boundary units included, of the sum
+        uint32_t units = 2 * ((tolerance >> LINE_CHECK_SHIFT) + 1) + 1;
+        double chance = units > LINE_CHECK_MASK ? 1.0 : (double)units / (LINE_CHECK_MASK + 1);
+        uint32_t passed = 0;
+
+        for (uint32_t trial = 0; trial < TRIALS; trial++) {
+            make_picture();
+            send_line(levels[n]);
+            for (uint32_t i = 0; i < sizeof(wrong); i++) {
+                wrong[i] = (uint8_t)xorshift32();
+            }
+            uint32_t check = line_check_read(line, 0) ^
+                             line_check_mask(wrong + VIDEO_ACTIVE_SAMPLES);
+            passed += line_check_match(check, received_sum(wrong), tolerance);
+        }
+        printf("  link noise %.1f codes rms: %u/%u lines pass, %.0f by chance "
+               "(%u-bit check)\n", levels[n], passed, TRIALS, chance * TRIALS,
+               LINE_CHECK_BITS);
+
+        ok &= passed <= 2 * chance * TRIALS + TRIALS / 1000;
+    }
+    return ok;
+}
+
+// Correlation of the chips as read off the link with the check in clear,
+// over pictures of random brightness
+static double chip_correlation(bool masked) {
+    double sx = 0.0, sy = 0.0, sxx = 0.0, syy = 0.0, sxy = 0.0;
+
+    for (uint32_t trial = 0; trial < TRIALS; trial++) {
+        make_picture();
+        if (!masked) {
+            memset(check_key, 0, sizeof(check_key));
+        }
+        send_line(0.0);
+        double x = (double)((picture_sum(picture) >> LINE_CHECK_SHIFT) & LINE_CHECK_MASK);
+        double y = (double)line_check_read(line, 0);
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        syy += y * y;
+        sxy += x * y;
+    }
+    double cov = sxy / TRIALS - sx * sy / ((double)TRIALS * TRIALS);
+    double vx = sxx / TRIALS - sx * sx / ((double)TRIALS * TRIALS);
+    double vy = syy / TRIALS - sy * sy / ((double)TRIALS * TRIALS);
+    return cov / sqrt(vx * vy);
+}
+
+static bool test_masked_chips(void) {
+    double clear = chip_correlation(false);
+    double masked = chip_correlation(true);
+
+    printf("  chips vs picture sum: correlation %.3f in clear, %.3f masked\n", clear, masked);
+    return clear > 0.9 && fabs(masked) < 0.05;
+}
+
+int main(void) {
+    printf("Line check test: %s, %u-bit check of a %u-bit sum, tolerance %u + %u sigma\n\n",
+           VIDEO_PROFILE_NAME, LINE_CHECK_BITS, LINE_CHECK_SUM_BITS, LINE_CHECK_TOLERANCE,
+           LINE_CHECK_SIGMAS);
+
+    check(test_round_trip(), "Check reads back at every offset");
+    check(test_noise_estimate(), "Link noise read off the pilot");
+    check(test_link_noise(), "Link noise within the tolerance");
+    check(test_wrong_keystream(), "Wrong keystream fails the check");
+    check(test_masked_chips(), "Chips do not follow the picture sum");
+
+    printf("\n%s\n", failures ? "FAILED" : "All tests passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * PicoCrypt FPV - Latency Histogram
+ */
+
+#include "line_hist.h"
+#include "platform.h"
+
+void line_hist_init(line_hist_t* hist) {
+    for (uint32_t b = 0; b < LINE_HIST_BUCKETS; b++) {
+        atomic_store_explicit(&hist->bucket[b], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&hist->max_us, 0, memory_order_relaxed);
+}
+
+uint32_t line_hist_bucket(uint32_t value_us) {
+    if (value_us < LINE_HIST_LINEAR_US) {
+        return value_us;
+    }
+
+    // Octave from the leading one, sub-bucket from the next three bits
+    uint32_t msb = 31 - (uint32_t)__builtin_clz(value_us);
+    uint32_t sub = (value_us >> (msb - LINE_HIST_SUB_BITS)) & (LINE_HIST_SUB_BUCKETS - 1);
+    return LINE_HIST_LINEAR_US + (msb - LINE_HIST_LINEAR_BITS) * LINE_HIST_SUB_BUCKETS + sub;
+}
+
+uint32_t line_hist_bucket_upper(uint32_t bucket) {
+    if (bucket < LINE_HIST_LINEAR_US) {
+        return bucket;
+    }
+
+    uint32_t octave = (bucket - LINE_HIST_LINEAR_US) / LINE_HIST_SUB_BUCKETS + LINE_HIST_LINEAR_BITS;
+    uint32_t sub = (bucket - LINE_HIST_LINEAR_US) % LINE_HIST_SUB_BUCKETS;
+    uint32_t shift = octave - LINE_HIST_SUB_BITS;
+    uint64_t upper = ((uint64_t)(LINE_HIST_SUB_BUCKETS + sub + 1) << shift) - 1;
+    return upper > UINT32_MAX ? UINT32_MAX : (uint32_t)upper;
+}
+
+void PICOCRYPT_RAM_FUNC(line_hist_record)(line_hist_t* hist, uint32_t value_us) {
+    // Single writer: load/store instead of an atomic increment
+    _Atomic uint32_t* bucket = &hist->bucket[line_hist_bucket(value_us)];
+    atomic_store_explicit(bucket, atomic_load_explicit(bucket, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+
+    if (value_us > atomic_load_explicit(&hist->max_us, memory_order_relaxed)) {
+        atomic_store_explicit(&hist->max_us, value_us, memory_order_relaxed);
+    }
+}
+
+void line_hist_snapshot(const line_hist_t* hist, line_hist_snapshot_t* snap) {
+    snap->count = 0;
+    for (uint32_t b = 0; b < LINE_HIST_BUCKETS; b++) {
+        snap->bucket[b] = atomic_load_explicit(&hist->bucket[b], memory_order_relaxed);
+        snap->count += snap->bucket[b];
+    }
+    snap->max_us = atomic_load_explicit(&hist->max_us, memory_order_relaxed);
+}
+
+void line_hist_delta(const line_hist_snapshot_t* now, const line_hist_snapshot_t* prev,
+                     line_hist_snapshot_t* delta) {
+    delta->count = 0;
+    delta->max_us = 0;
+    for (uint32_t b = 0; b < LINE_HIST_BUCKETS; b++) {
+        delta->bucket[b] = now->bucket[b] - prev->bucket[b];
+        delta->count += delta->bucket[b];
+        if (delta->bucket[b] != 0) {
+            delta->max_us = line_hist_bucket_upper(b);
+        }
+    }
+    if (delta->max_us > now->max_us) {
+        delta->max_us = now->max_us;
+    }
+}
+
+uint32_t line_hist_percentile(const line_hist_snapshot_t* snap, uint32_t per_10000) {
+    if (snap->count == 0) {
+        return 0;
+    }
+
+    // Rank of the sample at the percentile, rounded up (1-based)
+    uint64_t rank = ((uint64_t)snap->count * per_10000 + 9999) / 10000;
+    uint64_t seen = 0;
+    if (rank == 0) {
+        rank = 1;
+    }
+    for (uint32_t b = 0; b < LINE_HIST_BUCKETS; b++) {
+        seen += snap->bucket[b];
+        if (seen >= rank) {
+            uint32_t upper = line_hist_bucket_upper(b);
+            return upper < snap->max_us ? upper : snap->max_us;
+        }
+    }
+    return snap->max_us;
+}
@@ -0,0 +1,97 @@
+/*
+ * PicoCrypt FPV - Latency Histogram Test (host)
+ * Bucket mapping, percentiles and interval deltas
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "line_hist.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* name) {
+    printf("%-40s %s\n", name, ok ? "OK" : "ERROR");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// ===== TESTS =====
+static line_hist_t hist;
+static line_hist_snapshot_t snap, prev, delta;
+
+static bool test_buckets(void) {
+    bool ok = true;
+
+    // Every value lands in a bucket whose bounds contain it, in order
+    uint32_t last = 0;
+    for (uint64_t v = 0; v <= UINT32_MAX; v = v < 4096 ? v + 1 : v * 9 / 8) {
+        uint32_t b = line_hist_bucket((uint32_t)v);
+        ok &= b < LINE_HIST_BUCKETS;
+        ok &= b >= last;
+        ok &= line_hist_bucket_upper(b) >= v;
+        ok &= b == 0 || line_hist_bucket_upper(b - 1) < v;
+        last = b;
+    }
+    ok &= line_hist_bucket(UINT32_MAX) == LINE_HIST_BUCKETS - 1;
+    ok &= line_hist_bucket_upper(LINE_HIST_BUCKETS - 1) == UINT32_MAX;
+
+    // Exact below the linear limit
+    ok &= line_hist_bucket_upper(line_hist_bucket(63)) == 63;
+    return ok;
+}
+
+static bool test_percentiles(void) {
+    bool ok = true;
+
+    // 1..1000 us once each, plus one 50 ms outlier
+    line_hist_init(&hist);
+    for (uint32_t v = 1; v <= 1000; v++) {
+        line_hist_record(&hist, v);
+    }
+    line_hist_record(&hist, 50000);
+    line_hist_snapshot(&hist, &snap);
+
+    uint32_t p50 = line_hist_percentile(&snap, LINE_HIST_P50);
+    uint32_t p99 = line_hist_percentile(&snap, LINE_HIST_P99);
+    ok &= snap.count == 1001 && snap.max_us == 50000;
+    ok &= p50 >= 501 && p50 <= 501 * 9 / 8;
+    ok &= p99 >= 991 && p99 <= 991 * 9 / 8;
+    ok &= line_hist_percentile(&snap, 10000) == 50000;
+    printf("  p50 %u, p99 %u, p99.9 %u, max %u us\n", p50, p99,
+           line_hist_percentile(&snap, LINE_HIST_P999), snap.max_us);
+    return ok;
+}
+
+static bool test_delta(void) {
+    bool ok = true;
+
+    line_hist_init(&hist);
+    for (uint32_t n = 0; n < 100; n++) {
+        line_hist_record(&hist, 900);
+    }
+    line_hist_snapshot(&hist, &prev);
+    for (uint32_t n = 0; n < 10; n++) {
+        line_hist_record(&hist, 20);
+    }
+    line_hist_snapshot(&hist, &snap);
+    line_hist_delta(&snap, &prev, &delta);
+
+    // Only the interval's samples, with an interval max
+    ok &= delta.count == 10;
+    ok &= line_hist_percentile(&delta, LINE_HIST_P999) == 20;
+    ok &= delta.max_us == 20;
+    return ok;
+}
+
+// ===== MAIN =====
+int main(void) {
+    printf("PicoCrypt FPV latency histogram test (%d buckets)\n", LINE_HIST_BUCKETS);
+    check(test_buckets(), "Bucket bounds");
+    check(test_percentiles(), "Percentiles");
+    check(test_delta(), "Interval delta");
+
+    printf("%s (%d failure(s))\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+/*
+ * PicoCrypt FPV - Line Segment Map
+ */
+
+#include "line_map.h"
+#include "platform.h"
+
+const line_span_t line_segments[LINE_SEG_COUNT] = {
+    [LINE_SEG_SYNC]        = { 0, VIDEO_H_SYNC_SAMPLES },
+    [LINE_SEG_BACK_PORCH]  = { VIDEO_H_SYNC_SAMPLES, VIDEO_H_BACK_PORCH_SAMPLES },
+    [LINE_SEG_ACTIVE]      = { VIDEO_ACTIVE_START, VIDEO_ACTIVE_SAMPLES },
+    [LINE_SEG_FRONT_PORCH] = { VIDEO_ACTIVE_START + VIDEO_ACTIVE_SAMPLES,
+                               VIDEO_H_FRONT_PORCH_SAMPLES },
+};
+
+line_span_t PICOCRYPT_RAM_FUNC(line_map_crypto_span)(uint32_t field_line, uint32_t length) {
+    line_span_t span = line_segments[LINE_SEG_ACTIVE];
+
+    if (!line_map_is_active(field_line) || length <= span.start) {
+        span.length = 0;
+    } else if (span.start + span.length > length) {
+        span.length = (uint16_t)(length - span.start);      // Short capture
+    }
+    return span;
+}
@@ -0,0 +1,103 @@
+/*
+ * PicoCrypt FPV - Line Buffer Pool
+ */
+
+#include <string.h>
+
+#include "line_pool.h"
+#include "platform.h"
+
+static const char* lat_names[LINE_LAT_COUNT] = {
+    "capture",
+    "crypto",
+    "submit",
+    "output",
+    "total",
+    "glass",
+};
+
+void line_pool_init(line_pool_t* pool) {
+    for (int s = 0; s < LINE_STAGE_COUNT; s++) {
+        atomic_store_explicit(&pool->cursor[s], 0, memory_order_relaxed);
+    }
+    memset(pool->stamp_us, 0, sizeof(pool->stamp_us));
+    pool->overruns = 0;
+    for (int l = 0; l < LINE_LAT_COUNT; l++) {
+        line_hist_init(&pool->latency[l]);
+    }
+}
+
+int PICOCRYPT_RAM_FUNC(line_pool_peek)(line_pool_t* pool, line_stage_t stage) {
+    // Only this stage's owner writes its own cursor
+    uint32_t own = atomic_load_explicit(&pool->cursor[stage], memory_order_relaxed);
+
+    if (stage == LINE_STAGE_CAPTURE) {
+        uint32_t freed = atomic_load_explicit(&pool->cursor[LINE_STAGE_DONE],
+                                              memory_order_acquire);
+        if (own - freed >= LINE_POOL_DEPTH) {
+            return -1;
+        }
+    } else {
+        uint32_t ready = atomic_load_explicit(&pool->cursor[stage - 1],
+                                              memory_order_acquire);
+        if (own == ready) {
+            return -1;
+        }
+    }
+
+    return (int)(own % LINE_POOL_DEPTH);
+}
+
+void PICOCRYPT_RAM_FUNC(line_pool_advance)(line_pool_t* pool, line_stage_t stage) {
+    uint32_t own = atomic_load_explicit(&pool->cursor[stage], memory_order_relaxed);
+    // Release: buffer contents are visible before the next stage sees the slot
+    atomic_store_explicit(&pool->cursor[stage], own + 1, memory_order_release);
+}
+
+void PICOCRYPT_RAM_FUNC(line_pool_advance_at)(line_pool_t* pool, line_stage_t stage,
+                                              uint32_t now_us) {
+    uint32_t own = atomic_load_explicit(&pool->cursor[stage], memory_order_relaxed);
+    uint32_t* stamp = pool->stamp_us[own % LINE_POOL_DEPTH];
+
+    // Stamps are published to the next stage by the release below
+    stamp[stage] = now_us;
+    if (stage != LINE_STAGE_CAPTURE) {
+        line_hist_record(&pool->latency[stage - 1], now_us - stamp[stage - 1]);
+    }
+    if (stage == LINE_STAGE_DONE) {
+        line_hist_record(&pool->latency[LINE_LAT_TOTAL], now_us - stamp[LINE_STAGE_CAPTURE]);
+        line_hist_record(&pool->latency[LINE_LAT_GLASS], now_us - stamp[LINE_STAGE_CAPTURED]);
+    }
+
+    atomic_store_explicit(&pool->cursor[stage], own + 1, memory_order_release);
+}
+
+void PICOCRYPT_RAM_FUNC(line_pool_retire)(line_pool_t* pool, uint32_t now_us) {
+    if (line_pool_peek(pool, LINE_STAGE_DONE) < 0) {
+        return;
+    }
+    line_pool_advance_at(pool, LINE_STAGE_DONE, now_us);
+}
+
+void line_pool_report(const line_pool_t* pool, line_hist_snapshot_t since[LINE_LAT_COUNT],
+                      const uint8_t cores[LINE_LAT_COUNT],
+                      bool (*print)(const char* format, ...)) {
+    // Snapshot and delta are ~1 KB each: keep them off the stack
+    static line_hist_snapshot_t now, delta;
+
+    print("%-8s %4s %8s %6s %6s %6s %6s  (us, depth %d, overruns %lu)\n",
+          "stage", "core", "lines", "p50", "p99", "p99.9", "max",
+          LINE_POOL_DEPTH, (unsigned long)pool->overruns);
+    for (int l = 0; l < LINE_LAT_COUNT; l++) {
+        line_hist_snapshot(&pool->latency[l], &now);
+        line_hist_delta(&now, &since[l], &delta);
+        since[l] = now;
+
+        print("%-8s %4u %8lu %6lu %6lu %6lu %6lu\n", lat_names[l], cores[l],
+              (unsigned long)delta.count,
+              (unsigned long)line_hist_percentile(&delta, LINE_HIST_P50),
+              (unsigned long)line_hist_percentile(&delta, LINE_HIST_P99),
+              (unsigned long)line_hist_percentile(&delta, LINE_HIST_P999),
+              (unsigned long)delta.max_us);
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ * PicoCrypt FPV - Line Descriptor Queue
+ */
+
+#include "line_queue.h"
+#include "platform.h"
+
+void line_queue_init(line_queue_t* queue) {
+    atomic_store_explicit(&queue->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&queue->tail, 0, memory_order_relaxed);
+    queue->tail_cache = 0;
+    queue->head_cache = 0;
+    queue->full_count = 0;
+}
+
+bool PICOCRYPT_RAM_FUNC(line_queue_push)(line_queue_t* queue, const line_desc_t* desc) {
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+
+    // Only re-read the consumer's index when the cached one says full
+    if (head - queue->tail_cache >= LINE_QUEUE_SIZE) {
+        queue->tail_cache = atomic_load_explicit(&queue->tail, memory_order_acquire);
+        if (head - queue->tail_cache >= LINE_QUEUE_SIZE) {
+            queue->full_count++;
+            return false;
+        }
+    }
+
+    queue->entries[head & (LINE_QUEUE_SIZE - 1)] = *desc;
+
+    // Release: descriptor is visible before the consumer sees the new head
+    atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+    return true;
+}
+
+bool PICOCRYPT_RAM_FUNC(line_queue_pop)(line_queue_t* queue, line_desc_t* desc) {
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+    if (tail == queue->head_cache) {
+        queue->head_cache = atomic_load_explicit(&queue->head, memory_order_acquire);
+        if (tail == queue->head_cache) {
+            return false;
+        }
+    }
+
+    *desc = queue->entries[tail & (LINE_QUEUE_SIZE - 1)];
+
+    // Release: entry is copied out before the producer may reuse it
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t line_queue_count(line_queue_t* queue) {
+    uint32_t head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    return head - tail;
+}
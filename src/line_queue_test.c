@@ -0,0 +1,155 @@
+/*
+ * PicoCrypt FPV - Line Queue Test (host)
+ * Single-threaded semantics plus a two-thread producer/consumer stress run
+ *
+ * Usage: line_queue_test [descriptors]
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "line_queue.h"
+
+// ===== CONFIGURATION =====
+#define STRESS_COUNT    4000000u
+
+static int failures = 0;
+
+static void check(bool ok, const char* name) {
+    printf("%-40s %s\n", name, ok ? "OK" : "ERROR");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// Every field derived from the sequence number, so the consumer can
+// detect torn, duplicated, reordered or lost descriptors
+static void make_desc(line_desc_t* desc, uint32_t seq) {
+    desc->slot = (uint8_t)(seq * 7);
+    desc->flags = (uint8_t)(seq % 5 == 0 ? LINE_FLAG_VSYNC : 0) |
+                  (uint8_t)(seq & 1 ? LINE_FLAG_FIELD : 0);
+    desc->line = (uint16_t)(seq % 625);
+    desc->frame = seq;
+    desc->timestamp_us = seq * 2654435761u;
+}
+
+static bool desc_matches(const line_desc_t* desc, uint32_t seq) {
+    line_desc_t expect;
+    make_desc(&expect, seq);
+    return desc->slot == expect.slot && desc->flags == expect.flags &&
+           desc->line == expect.line && desc->frame == expect.frame &&
+           desc->timestamp_us == expect.timestamp_us;
+}
+
+// ===== TESTS =====
+static line_queue_t queue;
+
+static bool test_fill_and_drain(void) {
+    line_desc_t desc;
+    bool ok = true;
+
+    line_queue_init(&queue);
+    ok &= !line_queue_pop(&queue, &desc);
+
+    // Several passes so the indices wrap around the ring
+    for (uint32_t pass = 0; pass < 3; pass++) {
+        for (uint32_t i = 0; i < LINE_QUEUE_SIZE; i++) {
+            make_desc(&desc, pass * 100 + i);
+            ok &= line_queue_push(&queue, &desc);
+        }
+        make_desc(&desc, 0);
+        ok &= !line_queue_push(&queue, &desc);
+        ok &= line_queue_count(&queue) == LINE_QUEUE_SIZE;
+
+        for (uint32_t i = 0; i < LINE_QUEUE_SIZE; i++) {
+            ok &= line_queue_pop(&queue, &desc) && desc_matches(&desc, pass * 100 + i);
+        }
+        ok &= !line_queue_pop(&queue, &desc);
+        ok &= line_queue_count(&queue) == 0;
+    }
+
+    return ok && queue.full_count == 3;
+}
+
+static bool test_index_wraparound(void) {
+    line_desc_t desc;
+    bool ok = true;
+
+    // Start just below 2^32 so head/tail overflow during the test
+    line_queue_init(&queue);
+    atomic_store(&queue.head, UINT32_MAX - 5);
+    atomic_store(&queue.tail, UINT32_MAX - 5);
+    queue.tail_cache = UINT32_MAX - 5;
+    queue.head_cache = UINT32_MAX - 5;
+
+    for (uint32_t i = 0; i < 40; i++) {
+        make_desc(&desc, i);
+        ok &= line_queue_push(&queue, &desc);
+        ok &= line_queue_pop(&queue, &desc) && desc_matches(&desc, i);
+    }
+    return ok;
+}
+
+typedef struct {
+    uint32_t count;
+    uint32_t errors;
+} stress_args_t;
+
+static void* stress_producer(void* arg) {
+    stress_args_t* args = arg;
+    line_desc_t desc;
+
+    for (uint32_t seq = 0; seq < args->count; seq++) {
+        make_desc(&desc, seq);
+        while (!line_queue_push(&queue, &desc)) {
+            sched_yield();      // Consumer frees space
+        }
+    }
+    return NULL;
+}
+
+static void* stress_consumer(void* arg) {
+    stress_args_t* args = arg;
+    line_desc_t desc;
+
+    for (uint32_t seq = 0; seq < args->count; seq++) {
+        while (!line_queue_pop(&queue, &desc)) {
+            sched_yield();      // Producer fills
+        }
+        if (!desc_matches(&desc, seq)) {
+            args->errors++;
+        }
+    }
+    return NULL;
+}
+
+static bool test_stress(uint32_t count) {
+    stress_args_t args = { count, 0 };
+    pthread_t producer, consumer;
+
+    line_queue_init(&queue);
+    pthread_create(&consumer, NULL, stress_consumer, &args);
+    pthread_create(&producer, NULL, stress_producer, &args);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+
+    printf("  %u descriptors, %u mismatches, %u full\n",
+           count, args.errors, queue.full_count);
+    return args.errors == 0 && line_queue_count(&queue) == 0;
+}
+
+// ===== MAIN =====
+int main(int argc, char** argv) {
+    uint32_t count = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 0) : STRESS_COUNT;
+
+    printf("PicoCrypt FPV line queue test (%d entries)\n", LINE_QUEUE_SIZE);
+    check(test_fill_and_drain(), "Fill, full, drain");
+    check(test_index_wraparound(), "32-bit index wraparound");
+    check(test_stress(count), "Two-thread stress");
+
+    printf("%s (%d failure(s))\n", failures ? "FAILED" : "PASSED", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * PicoCrypt FPV - Line History Store
+ */
+
+#include "line_store.h"
+#include "platform.h"
+
+// Finer steps near zero: flat picture stays within a code or two, an
+// edge from black to white settles in four samples
+static const int16_t steps[LINE_STORE_STEPS] = {
+    -56, -38, -25, -16, -10, -6, -3, -1, 1, 3, 6, 10, 16, 25, 38, 56,
+};
+
+static inline int32_t clamp_sample(int32_t v) {
+    return v < 0 ? 0 : v > 255 ? 255 : v;
+}
+
+void line_store_init(line_store_t* store) {
+    for (int32_t d = -LINE_STORE_MAX_DELTA; d <= LINE_STORE_MAX_DELTA; d++) {
+        uint8_t best = 0;
+        for (uint8_t c = 1; c < LINE_STORE_STEPS; c++) {
+            int32_t error = d - steps[c];
+            int32_t best_error = d - steps[best];
+            if (error * error < best_error * best_error) {
+                best = c;
+            }
+        }
+        store->quantise[d + LINE_STORE_MAX_DELTA] = best;
+    }
+    for (uint32_t i = 0; i < LINE_STORE_LINES; i++) {
+        store->valid[i] = false;
+    }
+}
+
+void PICOCRYPT_RAM_FUNC(line_store_put)(line_store_t* store, uint32_t index,
+                                        const uint8_t* active, uint32_t cut) {
+    if (index >= LINE_STORE_LINES) {
+        return;
+    }
+    uint8_t* out = store->lines[index];
+    const uint8_t* end = active + VIDEO_ACTIVE_SAMPLES;
+    const uint8_t* p = active + cut;
+    int32_t last = 0;
+
+    for (uint32_t k = 0; k < LINE_STORE_SAMPLES; k++) {
+        uint32_t sum = 0;
+        if (p + LINE_STORE_DECIMATE <= end) {
+            // Whole group before the picture wraps (always, without a cut)
+            for (uint32_t m = 0; m < LINE_STORE_DECIMATE; m++) {
+                sum += p[m];
+            }
+            p += LINE_STORE_DECIMATE;
+        } else {
+            for (uint32_t m = 0; m < LINE_STORE_DECIMATE; m++) {
+                sum += *p++;
+                if (p == end) {
+                    p = active;
+                }
+            }
+        }
+        if (p == end) {
+            p = active;
+        }
+        int32_t target = (int32_t)((sum + LINE_STORE_DECIMATE / 2) / LINE_STORE_DECIMATE);
+        if (k == 0) {
+            out[0] = (uint8_t)target;
+            last = target;
+            continue;
+        }
+
+        // Code the step from what the decoder will have, not from the
+        // previous target
+        uint8_t code = store->quantise[target - last + LINE_STORE_MAX_DELTA];
+        last = clamp_sample(last + steps[code]);
+        uint32_t c = k - 1;
+        if (c & 1) {
+            out[1 + c / 2] |= (uint8_t)(code << 4);
+        } else {
+            out[1 + c / 2] = code;
+        }
+    }
+    store->valid[index] = true;
+}
+
+bool PICOCRYPT_RAM_FUNC(line_store_get)(const line_store_t* store, uint32_t index,
+                                        uint8_t* active) {
+    if (index >= LINE_STORE_LINES || !store->valid[index]) {
+        return false;
+    }
+    const uint8_t* in = store->lines[index];
+    uint8_t v[LINE_STORE_SAMPLES];
+
+    v[0] = in[0];
+    for (uint32_t k = 1; k < LINE_STORE_SAMPLES; k++) {
+        uint32_t c = k - 1;
+        uint8_t code = (in[1 + c / 2] >> ((c & 1) * 4)) & 0x0F;
+        v[k] = (uint8_t)clamp_sample(v[k - 1] + steps[code]);
+    }
+
+    // Each decimated sample sits mid-group: interpolate towards the
+    // neighbour on each side, weights in 1/(2 * LINE_STORE_DECIMATE)
+    for (uint32_t k = 0; k < LINE_STORE_SAMPLES; k++) {
+        uint32_t left = v[k > 0 ? k - 1 : 0];
+        uint32_t centre = v[k];
+        uint32_t right = v[k + 1 < LINE_STORE_SAMPLES ? k + 1 : k];
+        for (uint32_t m = 0; m < LINE_STORE_DECIMATE; m++) {
+            int32_t offset = 2 * (int32_t)m - (LINE_STORE_DECIMATE - 1);
+            uint32_t other = offset < 0 ? left : right;
+            uint32_t w = (uint32_t)(offset < 0 ? -offset : offset);
+            *active++ = (uint8_t)((centre * (2 * LINE_STORE_DECIMATE - w) + other * w +
+                                   LINE_STORE_DECIMATE) / (2 * LINE_STORE_DECIMATE));
+        }
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+/*
+ * PicoCrypt FPV - Line History Store Benchmark (host)
+ * Per-line cost of keeping and of concealing a line
+ *
+ * Times line_store_put() (every good active line on the receiver's
+ * output core) and line_store_get() (every concealed line) on a
+ * synthetic picture line, and reports host time and cycles per line (time
+ * stamp counter on x86-64) together with the store's footprint.
+ *
+ * Usage: line_store_bench [lines]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "line_store.h"
+
+// ===== CONFIGURATION =====
+#define BENCH_LINES         1000000
+
+static line_store_t store;
+static uint8_t picture[VIDEO_ACTIVE_SAMPLES];
+
+// ===== TIMING =====
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#if defined(__x86_64__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// ===== BENCHMARK =====
+static void report(const char* name, double ns, uint64_t cycles, unsigned lines) {
+    printf("%-8s %9.1f  ", name, ns / lines);
+    if (cycles) {
+        printf("%11.0f\n", (double)cycles / lines);
+    } else {
+        printf("%11s\n", "-");
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned lines = BENCH_LINES;
+    if (argc > 1) {
+        lines = (unsigned)strtoul(argv[1], NULL, 0);
+        if (lines == 0) {
+            fprintf(stderr, "usage: %s [lines]\n", argv[0]);
+            return 1;
+        }
+    }
+    for (uint32_t i = 0; i < VIDEO_ACTIVE_SAMPLES; i++) {
+        picture[i] = (uint8_t)(64 + (i * 3 + (i / 90) * 40) % 160);
+    }
+    line_store_init(&store);
+
+    printf("PicoCrypt FPV line history benchmark: %s, %u lines\n", VIDEO_PROFILE_NAME, lines);
+    printf("Store: %u lines x %u bytes = %zu bytes (a field of samples: %u)\n\n",
+           LINE_STORE_LINES, LINE_STORE_LINE_BYTES, sizeof(store.lines),
+           LINE_STORE_LINES * VIDEO_ACTIVE_SAMPLES);
+    printf("%-8s %9s  %11s\n", "op", "ns/line", "host cyc");
+
+    double start = now_ns();
+    uint64_t c0 = now_cycles();
+    for (unsigned i = 0; i < lines; i++) {
+        line_store_put(&store, i % LINE_STORE_LINES, picture, i % 64);
+    }
+    report("put", now_ns() - start, now_cycles() - c0, lines);
+
+    volatile uint8_t sink = 0;
+    start = now_ns();
+    c0 = now_cycles();
+    for (unsigned i = 0; i < lines; i++) {
+        line_store_get(&store, i % LINE_STORE_LINES, picture);
+        sink ^= picture[i % VIDEO_ACTIVE_SAMPLES];
+    }
+    report("get", now_ns() - start, now_cycles() - c0, lines);
+    (void)sink;
+    return 0;
+}
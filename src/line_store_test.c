@@ -0,0 +1,122 @@
+/*
+ * PicoCrypt FPV - Line History Store Test (host)
+ * Coding accuracy, rotated input and empty entries
+ *
+ * Stored lines must come back close to the 4-sample mean of the input
+ * (smooth picture within a few codes, a full black-to-white edge settled
+ * within a few decimated samples), a rotated picture must store exactly
+ * as its unrotated original, and a line never stored must not be played.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "line_store.h"
+
+static int failures = 0;
+static line_store_t store;
+static uint8_t picture[VIDEO_ACTIVE_SAMPLES];
+static uint8_t played[VIDEO_ACTIVE_SAMPLES];
+
+static void check(bool ok, const char* name) {
+    printf("%-40s %s\n", name, ok ? "OK" : "ERROR");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// Largest difference from the input beyond `skip` samples of each edge
+static int max_error(uint32_t from, uint32_t to) {
+    int worst = 0;
+    for (uint32_t i = from; i < to; i++) {
+        int d = abs((int)played[i] - (int)picture[i]);
+        worst = d > worst ? d : worst;
+    }
+    return worst;
+}
+
+// ===== TESTS =====
+static bool test_smooth(void) {
+    // Slow ramp plus a gentle wave: well inside the step table
+    for (uint32_t i = 0; i < VIDEO_ACTIVE_SAMPLES; i++) {
+        picture[i] = (uint8_t)lrint(40.0 + 150.0 * i / VIDEO_ACTIVE_SAMPLES +
+                                    30.0 * sin(i * 0.02));
+    }
+    line_store_put(&store, 3, picture, 0);
+    bool ok = line_store_get(&store, 3, played);
+
+    int error = max_error(0, VIDEO_ACTIVE_SAMPLES);
+    printf("  smooth line: max error %d codes\n", error);
+    return ok && error <= 4;
+}
+
+static bool test_edge(void) {
+    // Black to white mid-line: settled four decimated samples later
+    uint32_t edge = VIDEO_ACTIVE_SAMPLES / 2;
+    for (uint32_t i = 0; i < VIDEO_ACTIVE_SAMPLES; i++) {
+        picture[i] = i < edge ? 16 : 235;
+    }
+    line_store_put(&store, 0, picture, 0);
+    bool ok = line_store_get(&store, 0, played);
+
+    uint32_t settle = 4 * LINE_STORE_DECIMATE;
+    int before = max_error(0, edge - LINE_STORE_DECIMATE);
+    int after = max_error(edge + settle, VIDEO_ACTIVE_SAMPLES);
+    printf("  edge: max error %d before, %d codes from %u samples after\n", before, after,
+           settle);
+    return ok && before <= 2 && after <= 2;
+}
+
+static bool test_rotated(void) {
+    static line_store_t plain;
+    static uint8_t rotated[VIDEO_ACTIVE_SAMPLES];
+    bool ok = true;
+
+    // As the receiver holds a cut-and-rotate line: picture[j] at (j + cut)
+    for (uint32_t i = 0; i < VIDEO_ACTIVE_SAMPLES; i++) {
+        picture[i] = (uint8_t)(i * 7 + (i >> 3));
+    }
+    line_store_init(&plain);
+    line_store_put(&plain, 1, picture, 0);
+    for (uint32_t cut = 1; cut < VIDEO_ACTIVE_SAMPLES; cut += 37) {
+        for (uint32_t j = 0; j < VIDEO_ACTIVE_SAMPLES; j++) {
+            rotated[(j + cut) % VIDEO_ACTIVE_SAMPLES] = picture[j];
+        }
+        line_store_put(&store, 1, rotated, cut);
+        ok &= memcmp(store.lines[1], plain.lines[1], LINE_STORE_LINE_BYTES) == 0;
+    }
+    return ok;
+}
+
+static bool test_empty(void) {
+    bool ok = true;
+
+    line_store_init(&store);
+    memset(played, 0xAA, sizeof(played));
+    for (uint32_t i = 0; i < LINE_STORE_LINES; i++) {
+        ok &= !line_store_get(&store, i, played);
+    }
+    ok &= !line_store_get(&store, LINE_STORE_LINES, played);
+    ok &= played[0] == 0xAA;
+
+    line_store_put(&store, LINE_STORE_LINES - 1, picture, 0);
+    ok &= line_store_get(&store, LINE_STORE_LINES - 1, played);
+    return ok;
+}
+
+int main(void) {
+    printf("Line history store test: %s, %u lines x %u bytes = %zu bytes\n\n",
+           VIDEO_PROFILE_NAME, LINE_STORE_LINES, LINE_STORE_LINE_BYTES, sizeof(store.lines));
+
+    line_store_init(&store);
+    check(test_smooth(), "Smooth line within 4 codes");
+    check(test_edge(), "Full-range edge settles");
+    check(test_rotated(), "Rotated line stores as the original");
+    check(test_empty(), "Lines never stored are not played");
+
+    printf("\n%s\n", failures ? "FAILED" : "All tests passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * PicoCrypt FPV - Performance Monitor
+ * On-device cycle counts for the crypto hot path
+ *
+ * Measures CPU cycles per 720-sample line with SysTick for the backend this
+ * binary was built with (perf_monitor_xorshift / _chacha8 / _chacha12), and
+ * reports how much of the 64 us PAL line it uses at the current clk_sys.
+ */
+
+#include <stdio.h>
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+
+#include "crypto.h"
+#include "keystream.h"
+
+// ===== CONFIGURATION =====
+#define PERF_KEY            0x123456789ABCDEF0ULL
+#define PERF_WIDTH          720
+#define PERF_RUNS           256
+#define LINE_PERIOD_US      64
+
+static uint8_t input_line[PERF_WIDTH] __attribute__((aligned(4)));
+static uint8_t output_line[PERF_WIDTH] __attribute__((aligned(4)));
+static uint8_t keystream_line[PERF_WIDTH] __attribute__((aligned(4)));
+
+// ===== CYCLE COUNTER =====
+static void systick_start(void) {
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;      // Enable, processor clock, no interrupt
+}
+
+// SysTick counts down from 0xFFFFFF; one line is far below 2^24 cycles
+static inline uint32_t systick_now(void) {
+    return systick_hw->cvr;
+}
+
+static inline uint32_t systick_elapsed(uint32_t start, uint32_t end) {
+    return (start - end) & 0x00FFFFFF;
+}
+
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} cycle_stats_t;
+
+static void cycle_stats_add(cycle_stats_t* stats, uint32_t cycles) {
+    if (cycles < stats->min) stats->min = cycles;
+    if (cycles > stats->max) stats->max = cycles;
+    stats->total += cycles;
+}
+
+static void cycle_stats_print(const char* name, const cycle_stats_t* stats,
+                              uint32_t budget) {
+    uint32_t avg = (uint32_t)(stats->total / PERF_RUNS);
+    printf("%-24s avg %6lu  min %6lu  max %6lu cycles  %5.1f%% of line  cores %lu\n",
+           name, (unsigned long)avg, (unsigned long)stats->min,
+           (unsigned long)stats->max, 100.0f * avg / budget,
+           (unsigned long)((stats->max + budget - 1) / budget));
+}
+
+// ===== MEASUREMENT =====
+static void measure(void) {
+    prng_state_t prng;
+    cycle_stats_t fused = { UINT32_MAX, 0, 0 };
+    cycle_stats_t generate = { UINT32_MAX, 0, 0 };
+    cycle_stats_t xor_only = { UINT32_MAX, 0, 0 };
+    uint32_t budget = clock_get_hz(clk_sys) / 1000000 * LINE_PERIOD_US;
+
+    crypto_init(&prng, PERF_KEY);
+
+    for (int run = 0; run < PERF_RUNS; run++) {
+        uint32_t t0 = systick_now();
+        crypto_xor_line(&prng, input_line, output_line, PERF_WIDTH);
+        uint32_t t1 = systick_now();
+        crypto_keystream_line(&prng, keystream_line, PERF_WIDTH);
+        uint32_t t2 = systick_now();
+        crypto_xor_buffers(input_line, keystream_line, output_line, PERF_WIDTH);
+        uint32_t t3 = systick_now();
+
+        cycle_stats_add(&fused, systick_elapsed(t0, t1));
+        cycle_stats_add(&generate, systick_elapsed(t1, t2));
+        cycle_stats_add(&xor_only, systick_elapsed(t2, t3));
+    }
+
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_CHACHA
+    printf("\nBackend: ChaCha%d, %u-sample line, clk_sys %lu Hz, budget %lu cycles\n",
+           CHACHA_ROUNDS, PERF_WIDTH, (unsigned long)clock_get_hz(clk_sys),
+           (unsigned long)budget);
+#else
+    printf("\nBackend: Xorshift128+ x%d, %u-sample line, clk_sys %lu Hz, budget %lu cycles\n",
+           CRYPTO_LANES, PERF_WIDTH, (unsigned long)clock_get_hz(clk_sys),
+           (unsigned long)budget);
+#endif
+    cycle_stats_print("Fused encrypt", &fused, budget);
+    cycle_stats_print("Keystream (blanking)", &generate, budget);
+    cycle_stats_print("XOR only (hot path)", &xor_only, budget);
+}
+
+// ===== MAIN FUNCTION =====
+int main() {
+    stdio_init_all();
+    systick_start();
+
+    for (int i = 0; i < PERF_WIDTH; i++) {
+        input_line[i] = (uint8_t)i;
+    }
+
+    while (true) {
+        measure();
+        sleep_ms(2000);
+    }
+
+    return 0;
+}
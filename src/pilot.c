@@ -0,0 +1,57 @@
+/*
+ * PicoCrypt FPV - Line Timing Pilot
+ */
+
+#include "pilot.h"
+#include "platform.h"
+
+#define CHIP(k)     ((PILOT_CODE >> (PILOT_CHIPS - 1 - (k))) & 1)
+#define ZEROS       (PILOT_CHIPS - PILOT_ONES)
+
+_Static_assert(CHIP(0) + CHIP(1) + CHIP(2) + CHIP(3) + CHIP(4) + CHIP(5) + CHIP(6) +
+               CHIP(7) + CHIP(8) + CHIP(9) + CHIP(10) + CHIP(11) + CHIP(12) == PILOT_ONES,
+               "PILOT_ONES does not match PILOT_CODE");
+
+void PICOCRYPT_RAM_FUNC(pilot_write)(uint8_t* line) {
+    for (uint32_t k = 0; k < PILOT_CHIPS; k++) {
+        line[PILOT_START + k] = CHIP(k) ? PILOT_LEVEL_1 : PILOT_LEVEL_0;
+    }
+}
+
+static int32_t PICOCRYPT_RAM_FUNC(correlate)(const uint8_t* s) {
+    int32_t ones = 0, zeros = 0;
+
+    for (uint32_t k = 0; k < PILOT_CHIPS; k++) {
+        if (CHIP(k)) {
+            ones += s[k];
+        } else {
+            zeros += s[k];
+        }
+    }
+    return ZEROS * ones - PILOT_ONES * zeros;
+}
+
+bool PICOCRYPT_RAM_FUNC(pilot_find)(const uint8_t* line, int32_t* offset) {
+    // Nearest offsets first: a tie keeps the smaller shift
+    int32_t best = correlate(line + PILOT_START);
+    int32_t best_offset = 0;
+
+    for (int32_t d = 1; d <= PILOT_SEARCH; d++) {
+        int32_t late = correlate(line + PILOT_START + d);
+        int32_t early = correlate(line + PILOT_START - d);
+        if (late > best) {
+            best = late;
+            best_offset = d;
+        }
+        if (early > best) {
+            best = early;
+            best_offset = -d;
+        }
+    }
+
+    if (best < PILOT_PEAK / 2) {
+        return false;
+    }
+    *offset = best_offset;
+    return true;
+}
@@ -0,0 +1,101 @@
+/*
+ * PicoCrypt FPV - Pilot Correlator Benchmark (host)
+ * Per-line cost of finding a line's sample offset from its pilot
+ *
+ * Writes the pilot into a synthetic line, shifts the line by every offset
+ * in the search window and times pilot_find() on it. Reports host time
+ * and cycles per line (time stamp counter on x86-64) and checks each
+ * offset is found.
+ *
+ * Usage: pilot_bench [lines]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "pilot.h"
+
+// ===== CONFIGURATION =====
+#define BENCH_LINES         1000000     // Lines per offset
+
+static uint8_t nominal[VIDEO_LINE_SAMPLES];
+static uint8_t shifted[VIDEO_LINE_SAMPLES];
+
+// ===== TIMING =====
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#if defined(__x86_64__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// ===== BENCHMARK =====
+static void bench(int32_t shift, unsigned lines) {
+    volatile int32_t sink = 0;
+    unsigned found = 0;
+
+    for (int32_t i = 0; i < VIDEO_LINE_SAMPLES; i++) {
+        int32_t n = i - shift;
+        shifted[i] = nominal[n < 0 ? 0 : n >= VIDEO_LINE_SAMPLES ? VIDEO_LINE_SAMPLES - 1 : n];
+    }
+
+    double start = now_ns();
+    uint64_t c0 = now_cycles();
+    for (unsigned i = 0; i < lines; i++) {
+        int32_t offset = 0;
+        if (pilot_find(shifted, &offset) && offset == shift) {
+            found++;
+        }
+        sink ^= offset;
+    }
+    uint64_t cycles = now_cycles() - c0;
+    double ns_per_line = (now_ns() - start) / lines;
+    (void)sink;
+
+    printf("%+6d  %9.1f  ", shift, ns_per_line);
+    if (cycles) {
+        printf("%18.0f  ", (double)cycles / lines);
+    } else {
+        printf("%18s  ", "-");
+    }
+    printf("%6.2f%%  %s\n", 100.0 * ns_per_line / VIDEO_LINE_PERIOD_NS,
+           found == lines ? "found" : "MISSED");
+}
+
+int main(int argc, char** argv) {
+    unsigned lines = BENCH_LINES;
+    if (argc > 1) {
+        lines = (unsigned)strtoul(argv[1], NULL, 0);
+        if (lines == 0) {
+            fprintf(stderr, "usage: %s [lines]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Sync tip with the pilot, blanking, mid-grey picture
+    memset(nominal, 64, sizeof(nominal));
+    memset(nominal, PILOT_LEVEL_0, VIDEO_H_SYNC_SAMPLES);
+    memset(nominal + VIDEO_ACTIVE_START, 128, VIDEO_ACTIVE_SAMPLES);
+    pilot_write(nominal);
+
+    printf("PicoCrypt FPV pilot correlator benchmark (%u lines per offset)\n", lines);
+    printf("Profile: %s, %d-chip pilot at sample %d, search +-%d samples\n",
+           VIDEO_PROFILE_NAME, PILOT_CHIPS, PILOT_START, PILOT_SEARCH);
+    printf("shift  ns/line    host cycles/line  of line\n");
+    for (int32_t shift = -PILOT_SEARCH; shift <= PILOT_SEARCH; shift++) {
+        bench(shift, lines);
+    }
+    return 0;
+}
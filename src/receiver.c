@@ -0,0 +1,428 @@
+/*
+ * PicoCrypt FPV - Receiver Pipeline
+ */
+
+#include <string.h>
+
+#include "frame_table.h"
+#include "platform.h"
+#include "receiver.h"
+#include "trace.h"
+
+// Sync slicing level, as a sync separator would see it
+#define SYNC_TIP_SLICE      ((FRAME_LEVEL_SYNC + FRAME_LEVEL_BLANK) / 2)
+
+// Lines in the running mean of the link noise, for the line check
+#define CHECK_NOISE_LINES   8
+
+_Static_assert(PILOT_SEARCH <= LINE_POOL_SLACK, "Realigned lines must stay in their buffer");
+
+// ===== DECRYPTION =====
+
+// Live generator for `frame`: a rekey armed for it takes effect here
+static void PICOCRYPT_RAM_FUNC(select_key)(receiver_t* receiver, uint32_t frame) {
+    bool switched;
+    receiver->prng = rekey_select(&receiver->rekey, frame, &switched);
+    if (switched) {
+        trace_event(TRACE_EV_REKEY, frame, rekey_slot(&receiver->rekey));
+    }
+}
+
+static void PICOCRYPT_RAM_FUNC(sync_decryption_on_vsync)(receiver_t* receiver) {
+    // Reset PRNG to initial state - MUST match sender! A rekey armed for
+    // this frame is a pointer flip (rekey.h).
+    uint32_t frame = receiver->prng->sync_counter + 1;
+    select_key(receiver, frame);
+    crypto_seek(receiver->prng, frame, 0, 0);
+}
+
+// Returns the cut that restores the picture with SCRAMBLE_ROTATE, else 0.
+// The line check's mask comes from the keystream after the picture's
+// (check_key).
+static uint32_t PICOCRYPT_RAM_FUNC(decrypt_line)(receiver_t* receiver, uint8_t* line,
+                                                 uint8_t* check_key) {
+    // Same segment map as the sender: blanking was never encrypted. The
+    // span moves with the line's content (find_timing).
+    line_span_t span = line_map_crypto_span(receiver->line_counter, receiver->length);
+    if (span.length == 0) {
+        return 0;
+    }
+
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+    // The sender's cut; rotating the rest of the way round undoes it
+    uint8_t key[SCRAMBLE_KEY_BYTES] = { 0 };
+    if (!keystream_xor_line(&receiver->keystream, key, key, SCRAMBLE_KEY_BYTES, check_key)) {
+        keystream_xor_inline(&receiver->keystream, receiver->prng, key, key, SCRAMBLE_KEY_BYTES,
+                             check_key);
+    }
+    receiver->crypto_samples += SCRAMBLE_KEY_BYTES;
+    return span.length == VIDEO_ACTIVE_SAMPLES ? VIDEO_ACTIVE_SAMPLES - scramble_cut(key) : 0;
+#else
+    // Identical to encryption (XOR is symmetric). Keystream precomputed
+    // in blanking; ring underrun falls back to generating inline.
+    uint8_t* active = line + span.start + receiver->pilot_offset;
+    if (!keystream_xor_line(&receiver->keystream, active, active, span.length, check_key)) {
+        keystream_xor_inline(&receiver->keystream, receiver->prng, active, active, span.length,
+                             check_key);
+    }
+    receiver->crypto_samples += span.length;
+    return 0;
+#endif
+}
+
+static bool PICOCRYPT_RAM_FUNC(submit_line)(receiver_t* receiver, uint8_t* line, uint32_t cut) {
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+    // Played from the pilot's offset, head (sync tip, colour burst) and
+    // front porch included: the output is realigned as well as restored.
+    // The capture missed the samples shifted past one end of the line:
+    // the start of the sync tip or the end of the front porch.
+    if (cut != 0) {
+        int32_t offset = receiver->pilot_offset;
+        if (offset < 0) {
+            memset(line + offset, FRAME_LEVEL_SYNC, (size_t)-offset);
+        } else {
+            memset(line + VIDEO_LINE_SAMPLES, FRAME_LEVEL_BLANK, (size_t)offset);
+        }
+        return hal_video_out_submit_rotated(receiver->out, line + offset,
+                                            line + VIDEO_ACTIVE_START + offset, cut);
+    }
+#endif
+    return hal_video_out_submit(receiver->out, line, receiver->length);
+}
+
+static void PICOCRYPT_RAM_FUNC(queue_desc)(receiver_t* receiver, const line_desc_t* desc) {
+    // The pool bounds lines in flight, so the ring only fills if core 1 stalls
+    while (!line_queue_push(&receiver->queue, desc)) {
+        // Wait for core 1
+    }
+}
+
+void PICOCRYPT_RAM_FUNC(receiver_relock)(receiver_t* receiver, uint32_t frame, uint32_t line) {
+    // Jump straight to the keystream of the given line and refill the ring
+    trace_event(TRACE_EV_RELOCK, frame, line);
+    select_key(receiver, frame);
+    crypto_seek(receiver->prng, frame, line, 0);
+    keystream_ring_reset(&receiver->keystream);
+    keystream_prefetch(&receiver->keystream, receiver->prng, KEYSTREAM_RING_LINES);
+}
+
+static void PICOCRYPT_RAM_FUNC(read_code)(receiver_t* receiver, const uint8_t* line) {
+    int code_line = vbi_code_line(receiver->line_counter);
+    if (code_line < 0 || receiver->length < VIDEO_ACTIVE_START + VIDEO_ACTIVE_SAMPLES) {
+        return;
+    }
+    if (code_line == 0) {
+        vbi_code_reset(&receiver->code);
+    }
+    vbi_code_read(&receiver->code, line + VIDEO_ACTIVE_START + receiver->pilot_offset);
+    if (code_line < VBI_CODE_LINES - 1) {
+        return;
+    }
+
+    uint32_t frame;
+    if (!vbi_code_decode(&receiver->code, &frame)) {
+        receiver->code_errors++;
+        return;
+    }
+    receiver->code_fields++;
+
+    // Key the field from the sender's counter before its first active line
+    if (frame != receiver->prng->sync_counter) {
+        receiver->code_relocks++;
+        receiver_relock(receiver, frame, 0);
+    }
+}
+
+// Returns false if a pilot line has none
+static bool PICOCRYPT_RAM_FUNC(find_timing)(receiver_t* receiver, const uint8_t* line) {
+    // Capture start jitter moves the whole line; without a pilot the last
+    // offset is held
+    if (!pilot_line(receiver->line_counter)) {
+        return true;
+    }
+    if (!pilot_find(line, &receiver->pilot_offset)) {
+        receiver->pilot_misses++;
+        return false;
+    }
+    receiver->pilot_lines++;
+    receiver->pilot_shifted += receiver->pilot_offset != 0;
+    return true;
+}
+
+// A fade turns the whole line into noise, the sync tip included. The tip
+// is never encrypted and the pilot stays below the slicing level, so its
+// mean (clear of the largest shift) must read as sync.
+static bool PICOCRYPT_RAM_FUNC(line_faded)(const uint8_t* line) {
+    uint32_t tip = 0;
+
+    for (uint32_t i = PILOT_SEARCH; i < VIDEO_H_SYNC_SAMPLES - PILOT_SEARCH; i++) {
+        tip += line[i];
+    }
+    return tip >= SYNC_TIP_SLICE * (VIDEO_H_SYNC_SAMPLES - 2 * PILOT_SEARCH);
+}
+
+// Keep the picture of a good active line; play a bad one from its last
+// good copy. Returns the cut to play the line with.
+static uint32_t PICOCRYPT_RAM_FUNC(conceal_line)(receiver_t* receiver, uint8_t* line, bool good,
+                                                 uint32_t cut) {
+    if (!line_map_is_active(receiver->line_counter) ||
+        receiver->length < VIDEO_ACTIVE_START + VIDEO_ACTIVE_SAMPLES) {
+        return cut;
+    }
+    uint32_t index = line_map_active_index(receiver->line_counter);
+    uint8_t* active = line + VIDEO_ACTIVE_START + receiver->pilot_offset;
+
+    if (good) {
+        line_store_put(&receiver->history, index, active, cut);
+        return cut;
+    }
+    receiver->lines_bad++;
+    if (!line_store_get(&receiver->history, index, active)) {
+        return cut;
+    }
+    receiver->lines_concealed++;
+    return 0;               // Stored unrotated: played as is
+}
+
+// Line slips tried, one per failing line, once a run of check errors
+// is a sync error: a line captured twice or not at all shifts the rest
+// of the field. The last trial gives up where the line count says.
+static const int8_t slip_trials[] = { 1, -1, 0 };
+
+static void PICOCRYPT_RAM_FUNC(handle_sync_error)(receiver_t* receiver, uint32_t trial) {
+    if (trial == 0) {
+        // Deferred log: the decoder warns once the count climbs
+        receiver->sync_error_count++;
+        trace_event(TRACE_EV_SYNC_ERROR, receiver->sync_error_count, receiver->line_counter);
+    }
+
+    // Relock the keystream for the next line as if `slip` lines had been
+    // lost, instead of waiting for the next V-Sync (seek is O(1), so this
+    // costs well under a line)
+    receiver->line_slip = slip_trials[trial];
+    receiver_relock(receiver, receiver->prng->sync_counter,
+                    line_map_active_index(receiver->line_counter + 1 + receiver->line_slip));
+}
+
+// Returns false if a good active line fails the sender's check within a
+// run of failures, or passes it under a trial slip not yet confirmed.
+// `check_key` unmasks the check (decrypt_line()).
+static bool PICOCRYPT_RAM_FUNC(check_line)(receiver_t* receiver, const uint8_t* line,
+                                           const uint8_t* check_key, bool good) {
+    if (!receiver->sum || !good || !line_map_is_active(receiver->line_counter) ||
+        receiver->length < VIDEO_ACTIVE_START + VIDEO_ACTIVE_SAMPLES) {
+        return good;
+    }
+
+    // Rotation moves samples, not their sum: either mode sums in place
+    hal_line_sum_start(receiver->sum, line + VIDEO_ACTIVE_START + receiver->pilot_offset,
+                       VIDEO_ACTIVE_SAMPLES);
+
+    // The sum may move by what the link noise does to it: judged at the
+    // running mean over about CHECK_NOISE_LINES lines, or at this line's
+    // own noise if that is worse
+    uint32_t noise = line_check_noise(line, receiver->pilot_offset);
+    receiver->check_noise = receiver->check_lines == 0 ? noise : (uint32_t)(
+        (int32_t)receiver->check_noise +
+        ((int32_t)noise - (int32_t)receiver->check_noise) / CHECK_NOISE_LINES);
+    uint32_t tolerance = line_check_tolerance(noise > receiver->check_noise
+                                              ? noise : receiver->check_noise);
+    uint32_t check = line_check_read(line, receiver->pilot_offset) ^ line_check_mask(check_key);
+    bool match = line_check_match(check, hal_line_sum_finish(receiver->sum), tolerance);
+
+    receiver->check_lines++;
+    if (match && receiver->line_slip != 0 && !receiver->slip_pending) {
+        // One pass under a trial slip may be chance: confirm on the next
+        receiver->slip_pending = true;
+        return false;
+    }
+    if (match) {
+        // The line is where the sender says
+        receiver->line_counter += (uint32_t)receiver->line_slip;
+        receiver->check_slips += receiver->line_slip != 0;
+        receiver->line_slip = 0;
+        receiver->slip_pending = false;
+        receiver->check_run = 0;
+        return true;
+    }
+    receiver->check_errors++;
+    receiver->slip_pending = false;
+
+    // A run of failures the noise cannot explain is the keystream
+    uint32_t trial = ++receiver->check_run - LINE_CHECK_RESYNC_LINES;
+    if (receiver->check_run >= LINE_CHECK_RESYNC_LINES &&
+        trial < sizeof(slip_trials) / sizeof(slip_trials[0])) {
+        handle_sync_error(receiver, trial);
+    }
+
+    // A misread chip fails a single line: play it as decrypted
+    return receiver->check_run < LINE_CHECK_RESYNC_LINES;
+}
+
+static void PICOCRYPT_RAM_FUNC(handle_vsync)(receiver_t* receiver) {
+    trace_event(TRACE_EV_VSYNC, receiver->prng->sync_counter, receiver->line_counter);
+
+    // A field of the wrong length lost or gained lines somewhere: count
+    // it (the first V-Sync ends no field). The resync below relocks.
+    uint32_t lines = receiver->line_counter;
+    if (receiver->frames_output > 0 &&
+        (lines < VIDEO_FIELD_LINES || lines > VIDEO_FIELD_LINES + (VIDEO_FIELDS > 1))) {
+        receiver->sync_error_count++;
+        trace_event(TRACE_EV_SYNC_ERROR, receiver->sync_error_count, lines);
+    }
+
+    // Reset line counter
+    receiver->line_counter = 0;
+    receiver->check_run = 0;
+    receiver->line_slip = 0;
+    receiver->slip_pending = false;
+
+    // Resynchronize decryption - CRITICAL!
+    sync_decryption_on_vsync(receiver);
+
+    // Refill the keystream ring during V-blanking
+    keystream_ring_reset(&receiver->keystream);
+    keystream_prefetch(&receiver->keystream, receiver->prng, KEYSTREAM_RING_LINES);
+}
+
+// ===== INITIALIZATION =====
+void receiver_init(receiver_t* receiver, const crypto_key_t* key, uint32_t slot,
+                   uint32_t length, hal_video_in_t* in, hal_video_out_t* out,
+                   hal_line_sum_t* sum) {
+    line_pool_init(&receiver->pool);
+    line_queue_init(&receiver->queue);
+    video_input_init(&receiver->input, &receiver->pool, in, 0, length);
+    receiver->out = out;
+    receiver->length = length;
+
+    receiver->capture_line = 0;
+    receiver->capture_frame = 0;
+
+    receiver->sum = sum;
+
+    // Initialize PRNG with same pre-shared key as sender; the frame is
+    // the sender's, read from the first VBI code
+    rekey_init(&receiver->rekey, key, slot, 0);
+    receiver->prng = &receiver->rekey.generators[0];
+    keystream_ring_init(&receiver->keystream, SCRAMBLE_MODE == SCRAMBLE_ROTATE ? SCRAMBLE_KEY_BYTES
+                        : line_map_crypto_span(VIDEO_VBI_LINES, length).length,
+                        LINE_CHECK_KEY_BYTES);
+    keystream_prefetch(&receiver->keystream, receiver->prng, KEYSTREAM_RING_LINES);
+    receiver->line_counter = 0;
+    receiver->crypto_samples = 0;
+    receiver->pilot_offset = 0;
+    receiver->pilot_lines = 0;
+    receiver->pilot_misses = 0;
+    receiver->pilot_shifted = 0;
+    line_store_init(&receiver->history);
+    receiver->lines_bad = 0;
+    receiver->lines_concealed = 0;
+    receiver->check_lines = 0;
+    receiver->check_errors = 0;
+    receiver->check_run = 0;
+    receiver->check_noise = 0;
+    receiver->check_slips = 0;
+    receiver->line_slip = 0;
+    receiver->slip_pending = false;
+    receiver->sync_error_count = 0;
+    vbi_code_reset(&receiver->code);
+    receiver->code_fields = 0;
+    receiver->code_errors = 0;
+    receiver->code_relocks = 0;
+    receiver->frames_output = 0;
+}
+
+bool receiver_rekey(receiver_t* receiver, const crypto_key_t* key, uint32_t slot,
+                    uint32_t frame) {
+    return rekey_schedule(&receiver->rekey, key, slot, frame);
+}
+
+// ===== CORE 0: CAPTURE =====
+bool PICOCRYPT_RAM_FUNC(receiver_hsync)(receiver_t* receiver) {
+    return video_input_hsync(&receiver->input);
+}
+
+bool PICOCRYPT_RAM_FUNC(receiver_capture_step)(receiver_t* receiver) {
+    int slot = video_input_poll(&receiver->input);
+    if (slot < 0) {
+        return false;
+    }
+
+    line_desc_t desc = {
+        .slot = (uint8_t)slot,
+        .line = (uint16_t)receiver->capture_line++,
+        .frame = receiver->capture_frame,
+        .timestamp_us = line_pool_capture_time(&receiver->pool, slot),
+    };
+    queue_desc(receiver, &desc);
+
+    return true;
+}
+
+void PICOCRYPT_RAM_FUNC(receiver_vsync)(receiver_t* receiver) {
+    receiver->capture_line = 0;
+    receiver->capture_frame++;
+
+    line_desc_t desc = {
+        .flags = LINE_FLAG_VSYNC,
+        .frame = receiver->capture_frame,
+        .timestamp_us = hal_time_us(),
+    };
+    queue_desc(receiver, &desc);
+}
+
+// ===== CORE 1: DECRYPT & OUTPUT =====
+void PICOCRYPT_RAM_FUNC(receiver_retire)(receiver_t* receiver) {
+    for (uint32_t n = hal_video_out_poll(receiver->out); n > 0; n--) {
+        line_pool_retire(&receiver->pool, hal_time_us());
+    }
+}
+
+uint32_t PICOCRYPT_RAM_FUNC(receiver_output_step)(receiver_t* receiver) {
+    uint32_t vsyncs = 0;
+    line_desc_t desc;
+
+    receiver_retire(receiver);
+
+    while (line_queue_pop(&receiver->queue, &desc)) {
+        if (desc.flags & LINE_FLAG_VSYNC) {
+            hal_video_out_field(receiver->out);
+            handle_vsync(receiver);
+            receiver->frames_output++;
+            vsyncs++;
+            continue;
+        }
+
+        // Captured slot from core 0: decrypt in place while earlier
+        // lines are still streaming out
+        uint8_t* line = line_pool_buffer(&receiver->pool, desc.slot);
+
+        uint8_t check_key[LINE_CHECK_KEY_BYTES];
+        bool good = !line_faded(line) && find_timing(receiver, line);
+        read_code(receiver, line);
+        uint32_t cut = decrypt_line(receiver, line, check_key);
+        good = check_line(receiver, line, check_key, good);
+        cut = conceal_line(receiver, line, good, cut);
+        line_pool_advance_at(&receiver->pool, LINE_STAGE_CRYPTO, hal_time_us());
+
+        // Swap the decrypted line into its line of the field
+        while (!submit_line(receiver, line, cut)) {
+            receiver_retire(receiver);
+        }
+        line_pool_advance_at(&receiver->pool, LINE_STAGE_OUTPUT, hal_time_us());
+
+        receiver->line_counter++;
+
+        // H-blanking: precompute keystream for an upcoming line
+        keystream_prefetch(&receiver->keystream, receiver->prng, 1);
+    }
+
+    return vsyncs;
+}
+
+// ===== STATISTICS =====
+void receiver_report_latency(receiver_t* receiver, line_hist_snapshot_t since[LINE_LAT_COUNT]) {
+    // Core recording each stage: capture on 0, decrypt and output on 1
+    static const uint8_t cores[LINE_LAT_COUNT] = { 0, 1, 1, 1, 1, 1 };
+    line_pool_report(&receiver->pool, since, cores, trace_printf);
+}
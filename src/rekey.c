@@ -0,0 +1,62 @@
+/*
+ * PicoCrypt FPV - Rekey
+ */
+
+#include "platform.h"
+#include "rekey.h"
+
+void rekey_init(rekey_t* rekey, const crypto_key_t* key, uint32_t slot, uint32_t frame) {
+    crypto_init_key(&rekey->generators[0], key);
+    crypto_seek(&rekey->generators[0], frame, 0, 0);
+    rekey->slots[0] = slot;
+    rekey->slots[1] = slot;
+    atomic_store_explicit(&rekey->live, 0, memory_order_relaxed);
+    atomic_store_explicit(&rekey->armed, 0, memory_order_relaxed);
+    atomic_store_explicit(&rekey->frame, frame, memory_order_relaxed);
+    rekey->switch_frame = 0;
+    rekey->switches = 0;
+}
+
+bool rekey_schedule(rekey_t* rekey, const crypto_key_t* key, uint32_t slot, uint32_t frame) {
+    // Acquire: the consumer's last switch (live) is seen before its
+    // generator could be taken for the standby
+    if (atomic_load_explicit(&rekey->armed, memory_order_acquire)) {
+        return false;
+    }
+    uint32_t now = atomic_load_explicit(&rekey->frame, memory_order_relaxed);
+    if ((int32_t)(frame - now) < REKEY_LEAD_FRAMES) {
+        return false;
+    }
+
+    // The slow part, off the V-Sync path: key and position the standby
+    uint32_t standby = atomic_load_explicit(&rekey->live, memory_order_relaxed) ^ 1;
+    crypto_init_key(&rekey->generators[standby], key);
+    crypto_seek(&rekey->generators[standby], frame, 0, 0);
+    rekey->slots[standby] = slot;
+    rekey->switch_frame = frame;
+
+    // Release: the keyed standby is visible before the consumer sees it armed
+    atomic_store_explicit(&rekey->armed, 1, memory_order_release);
+    return true;
+}
+
+prng_state_t* PICOCRYPT_RAM_FUNC(rekey_select)(rekey_t* rekey, uint32_t frame, bool* switched) {
+    uint32_t live = atomic_load_explicit(&rekey->live, memory_order_relaxed);
+
+    atomic_store_explicit(&rekey->frame, frame, memory_order_relaxed);
+    *switched = false;
+
+    // Serial arithmetic: the frame counter wraps. A switch armed late
+    // (its frame already past) still happens, at the next selection.
+    if (atomic_load_explicit(&rekey->armed, memory_order_acquire) &&
+        (int32_t)(frame - rekey->switch_frame) >= 0) {
+        live ^= 1;
+        atomic_store_explicit(&rekey->live, live, memory_order_release);
+        rekey->switches++;
+        *switched = true;
+
+        // Release: live is updated before the producer may key the old one
+        atomic_store_explicit(&rekey->armed, 0, memory_order_release);
+    }
+    return &rekey->generators[live];
+}
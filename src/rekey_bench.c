@@ -0,0 +1,189 @@
+/*
+ * PicoCrypt FPV - Rekey Benchmark (host)
+ * V-Sync handler time with and without a key switch
+ *
+ * Runs the sender and receiver V-Sync handlers (sender_vsync, and the
+ * receiver's V-Sync descriptor through receiver_output_step) on the
+ * simulator HAL, with a rekey armed REKEY_LEAD_FRAMES ahead whenever
+ * none is pending, so every few fields switches keys. Reports mean and
+ * worst host time and cycles (time stamp counter on x86-64) per handler
+ * for plain and switching V-Syncs, and for the rekey command that keys
+ * the standby generator off the V-Sync path. A switch must cost the
+ * handler no more than noise: the keystream refill dominates either way.
+ *
+ * Usage: rekey_bench [fields]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "hal.h"
+#include "receiver.h"
+#include "sender.h"
+#include "trace.h"
+
+// ===== CONFIGURATION =====
+#define BENCH_FIELDS        200000
+#define BENCH_KEY           0x123456789ABCDEF0ULL
+
+typedef enum {
+    TIMER_SENDER = 0,           // sender_vsync, no switch
+    TIMER_SENDER_REKEY,         // sender_vsync switching keys
+    TIMER_RECEIVER,             // Receiver V-Sync, no switch
+    TIMER_RECEIVER_REKEY,       // Receiver V-Sync switching keys
+    TIMER_SCHEDULE,             // Rekey command: key the standby (both units)
+    TIMER_COUNT
+} bench_timer_t;
+
+static const char* timer_names[TIMER_COUNT] = {
+    "Sender V-Sync",
+    "Sender V-Sync + switch",
+    "Receiver V-Sync",
+    "Receiver V-Sync + switch",
+    "Rekey command (background)",
+};
+
+typedef struct {
+    double ns;
+    double worst_ns;
+    uint64_t cycles;
+    uint64_t worst_cycles;
+    uint32_t count;
+} bench_stats_t;
+
+static bench_stats_t timers[TIMER_COUNT];
+
+// ===== TIMING =====
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#if defined(__x86_64__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void record(bench_timer_t timer, double ns, uint64_t cycles) {
+    bench_stats_t* t = &timers[timer];
+    t->ns += ns;
+    t->cycles += cycles;
+    t->count++;
+    if (ns > t->worst_ns) {
+        t->worst_ns = ns;
+    }
+    if (cycles > t->worst_cycles) {
+        t->worst_cycles = cycles;
+    }
+}
+
+// ===== BENCHMARK =====
+int main(int argc, char** argv) {
+    uint32_t fields = BENCH_FIELDS;
+    if (argc > 1) {
+        fields = (uint32_t)strtoul(argv[1], NULL, 0);
+        if (fields == 0) {
+            fprintf(stderr, "usage: %s [fields]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    static sender_t sender;
+    static receiver_t receiver;
+    hal_video_in_t sender_in, receiver_in;
+    hal_video_out_t sender_out, receiver_out;
+    hal_line_sum_t sender_sum, receiver_sum;
+    crypto_key_t keys[2];
+
+    hal_sim_video_in_init(&sender_in);
+    hal_sim_video_in_init(&receiver_in);
+    hal_sim_video_out_init(&sender_out, NULL, NULL);
+    hal_sim_video_out_init(&receiver_out, NULL, NULL);
+    hal_sim_line_sum_init(&sender_sum);
+    hal_sim_line_sum_init(&receiver_sum);
+    crypto_key_from_u64(&keys[0], BENCH_KEY);
+    crypto_key_from_u64(&keys[1], ~BENCH_KEY);
+    sender_init(&sender, &keys[0], 0, 0, VIDEO_LINE_SAMPLES, &sender_in, &sender_out,
+                &sender_sum);
+    receiver_init(&receiver, &keys[0], 0, VIDEO_LINE_SAMPLES, &receiver_in, &receiver_out,
+                  &receiver_sum);
+    trace_init();
+
+    uint32_t slot = 0;
+    for (uint32_t field = 0; field < fields; field++) {
+        // Rekey command whenever none is pending, as the USB core would
+        uint32_t frame = rekey_frame(&sender.rekey) + REKEY_LEAD_FRAMES;
+        double t0 = now_ns();
+        uint64_t c0 = now_cycles();
+        if (sender_rekey(&sender, &keys[slot ^ 1], slot ^ 1, frame)) {
+            receiver_rekey(&receiver, &keys[slot ^ 1], slot ^ 1, frame);
+            record(TIMER_SCHEDULE, now_ns() - t0, now_cycles() - c0);
+            slot ^= 1;
+        }
+
+        uint32_t switches = sender.rekey.switches;
+        t0 = now_ns();
+        c0 = now_cycles();
+        sender_vsync(&sender);
+        double t1 = now_ns();
+        uint64_t c1 = now_cycles();
+        record(sender.rekey.switches != switches ? TIMER_SENDER_REKEY : TIMER_SENDER,
+               t1 - t0, c1 - c0);
+        sender_output_step(&sender);
+
+        switches = receiver.rekey.switches;
+        receiver_vsync(&receiver);
+        t0 = now_ns();
+        c0 = now_cycles();
+        receiver_output_step(&receiver);
+        t1 = now_ns();
+        c1 = now_cycles();
+        record(receiver.rekey.switches != switches ? TIMER_RECEIVER_REKEY : TIMER_RECEIVER,
+               t1 - t0, c1 - c0);
+    }
+
+    printf("PicoCrypt FPV rekey benchmark (%u fields)\n", fields);
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_CHACHA
+    printf("Profile: %s, ChaCha%d, %u keystream lines refilled per V-Sync\n",
+           VIDEO_PROFILE_NAME, CHACHA_ROUNDS, KEYSTREAM_RING_LINES);
+#else
+    printf("Profile: %s, Xorshift128+ x%d, %u keystream lines refilled per V-Sync\n",
+           VIDEO_PROFILE_NAME, CRYPTO_LANES, KEYSTREAM_RING_LINES);
+#endif
+    printf("%-28s %8s %10s %10s %14s %14s\n", "Handler", "calls", "ns mean", "ns worst",
+           "cycles mean", "cycles worst");
+    for (int t = 0; t < TIMER_COUNT; t++) {
+        const bench_stats_t* s = &timers[t];
+        if (s->count == 0) {
+            continue;
+        }
+        printf("%-28s %8u %10.1f %10.1f ", timer_names[t], s->count, s->ns / s->count,
+               s->worst_ns);
+        if (s->cycles) {
+            printf("%14.0f %14llu\n", (double)s->cycles / s->count,
+                   (unsigned long long)s->worst_cycles);
+        } else {
+            printf("%14s %14s\n", "-", "-");
+        }
+    }
+
+    // Mean cost of the switch itself, against one line of video
+    const bench_stats_t* plain = &timers[TIMER_SENDER];
+    const bench_stats_t* flip = &timers[TIMER_SENDER_REKEY];
+    if (plain->count && flip->count) {
+        double extra = flip->ns / flip->count - plain->ns / plain->count;
+        printf("Switch: %+.1f ns on the sender V-Sync (%.3f%% of a %.2f us line); "
+               "switches: sender %u, receiver %u\n", extra,
+               100.0 * extra / VIDEO_LINE_PERIOD_NS, VIDEO_LINE_PERIOD_NS / 1000.0,
+               sender.rekey.switches, receiver.rekey.switches);
+    }
+    return sender.rekey.switches == receiver.rekey.switches ? 0 : 1;
+}
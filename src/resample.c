@@ -0,0 +1,88 @@
+/*
+ * PicoCrypt FPV - Line Resampler
+ */
+
+#include "platform.h"
+#include "resample.h"
+
+// ===== COEFFICIENTS =====
+#define UP          VIDEO_RESAMPLE_UP
+#define DOWN        VIDEO_RESAMPLE_DOWN
+#define ONE         (1 << RESAMPLE_SHIFT)
+
+// Output k of a cycle: phase k*DOWN/UP past input sample BASE(k)
+#define PHASE(k)    ((int64_t)((k) * DOWN % UP))
+#define BASE(k)     ((k) * DOWN / UP)
+
+// n / d to nearest, either sign (constant expression)
+#define ROUND_DIV(n, d) ((n) >= 0 ? ((n) + (d) / 2) / (d) : -((-(n) + (d) / 2) / (d)))
+
+#if RESAMPLE_TAPS == 2
+// Linear: x[b] + t * (x[b+1] - x[b])
+#define W1(p)       ROUND_DIV((p) * ONE, UP)
+#define ENTRY(k)    { { ONE - W1(PHASE(k)), W1(PHASE(k)) }, BASE(k) + 1 },
+#else
+// Catmull-Rom at t = p/UP over x[b-1] .. x[b+2], as numerators over 2*UP^3.
+// The centre tap takes the rounding so every phase sums to exactly ONE.
+#define CUBE        (2 * (int64_t)UP * UP * UP)
+#define N0(p)       (-(p) * (p) * (p) + 2 * (p) * (p) * UP - (p) * UP * UP)
+#define N2(p)       (-3 * (p) * (p) * (p) + 4 * (p) * (p) * UP + (p) * UP * UP)
+#define N3(p)       ((p) * (p) * (p) - (p) * (p) * UP)
+#define WN(n)       ROUND_DIV((n) * ONE, CUBE)
+#define W1(p)       (ONE - WN(N0(p)) - WN(N2(p)) - WN(N3(p)))
+#define ENTRY(k)    { { WN(N0(PHASE(k))), W1(PHASE(k)), WN(N2(PHASE(k))), WN(N3(PHASE(k))) }, \
+                      BASE(k) },
+#endif
+
+#define ENTRIES_8(k)    ENTRY(k) ENTRY(k + 1) ENTRY(k + 2) ENTRY(k + 3) \
+                        ENTRY(k + 4) ENTRY(k + 5) ENTRY(k + 6) ENTRY(k + 7)
+
+// Entries past VIDEO_RESAMPLE_UP are never read
+const resample_phase_t resample_phases[RESAMPLE_MAX_PHASES] = {
+    ENTRIES_8(0) ENTRIES_8(8) ENTRIES_8(16) ENTRIES_8(24)
+};
+
+// ===== KERNEL =====
+static inline uint8_t interpolate(const uint8_t* x, const resample_phase_t* phase) {
+#if RESAMPLE_TAPS == 2
+    // Convex: never leaves 0..255
+    int32_t acc = (x[0] << RESAMPLE_SHIFT) + phase->w[1] * (x[1] - x[0]);
+    return (uint8_t)((acc + ONE / 2) >> RESAMPLE_SHIFT);
+#else
+    int32_t acc = phase->w[0] * x[0] + phase->w[1] * x[1] +
+                  phase->w[2] * x[2] + phase->w[3] * x[3] + ONE / 2;
+    // Overshoot on sharp edges (sync)
+    if (acc < 0) {
+        return 0;
+    }
+    acc >>= RESAMPLE_SHIFT;
+    return acc > 255 ? 255 : (uint8_t)acc;
+#endif
+}
+
+void PICOCRYPT_RAM_FUNC(resample_line)(uint8_t* line) {
+    uint8_t* in = line + RESAMPLE_IN_OFFSET;
+
+    // Hold the edge samples for the taps that fall outside the capture
+    in[-1] = in[0];
+    in[VIDEO_CAPTURE_SAMPLES] = in[VIDEO_CAPTURE_SAMPLES - 1];
+    in[VIDEO_CAPTURE_SAMPLES + 1] = in[VIDEO_CAPTURE_SAMPLES - 1];
+
+    const uint8_t* x = in - 1;
+    uint8_t* out = line;
+    uint32_t left = VIDEO_LINE_SAMPLES;
+
+    // Whole cycles: UP outputs from DOWN inputs
+    for (; left >= UP; left -= UP, x += DOWN) {
+        for (uint32_t k = 0; k < UP; k++) {
+            const resample_phase_t* phase = &resample_phases[k];
+            *out++ = interpolate(x + phase->offset, phase);
+        }
+    }
+
+    // Partial cycle at the end of the line (NTSC)
+    for (uint32_t k = 0; k < left; k++) {
+        const resample_phase_t* phase = &resample_phases[k];
+        *out++ = interpolate(x + phase->offset, phase);
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * PicoCrypt FPV - Resampler Benchmark (host)
+ * Per-line cost of the ADC -> output rate resampler, one build per kernel
+ *
+ * Times resample_line() on a captured-like line and reports host time and
+ * cycles per line (time stamp counter on x86-64, else time only) against
+ * the profile's line period. The line period in RP2040 clk_sys cycles is
+ * printed for comparison; measure the target with perf_monitor.
+ *
+ * Usage: resample_bench [lines]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+#include "resample.h"
+
+// ===== CONFIGURATION =====
+#define BENCH_LINES         200000      // Lines per measurement
+
+static uint8_t line_buffer[RESAMPLE_BUFFER_SAMPLES] __attribute__((aligned(4)));
+static uint8_t capture_buffer[VIDEO_CAPTURE_SAMPLES];
+
+// ===== TIMING =====
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#if defined(__x86_64__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// ===== BENCHMARK =====
+static void bench(unsigned lines) {
+    volatile uint8_t sink = 0;
+    double elapsed = 0.0;
+    uint64_t cycles = 0;
+
+    for (unsigned i = 0; i < lines; i++) {
+        // Fresh capture each line (in place), outside the timed region
+        for (unsigned s = 0; s < VIDEO_CAPTURE_SAMPLES; s += 64) {
+            capture_buffer[s] ^= (uint8_t)i;
+        }
+        __builtin_memcpy(line_buffer + RESAMPLE_IN_OFFSET, capture_buffer, VIDEO_CAPTURE_SAMPLES);
+
+        double start = now_ns();
+        uint64_t c0 = now_cycles();
+        resample_line(line_buffer);
+        cycles += now_cycles() - c0;
+        elapsed += now_ns() - start;
+        sink ^= line_buffer[i % VIDEO_LINE_SAMPLES];
+    }
+    (void)sink;
+
+    double ns_per_line = elapsed / lines;
+    double line_ns = VIDEO_LINE_PERIOD_NS;
+
+    printf("%4d  %11.1f  %13.2f  ", RESAMPLE_TAPS, ns_per_line, ns_per_line / VIDEO_LINE_SAMPLES);
+    if (cycles) {
+        printf("%15.0f  %14.2f  ", (double)cycles / lines,
+               (double)cycles / lines / VIDEO_LINE_SAMPLES);
+    } else {
+        printf("%15s  %14s  ", "-", "-");
+    }
+    printf("%7.2f%%\n", 100.0 * ns_per_line / line_ns);
+}
+
+int main(int argc, char** argv) {
+    unsigned lines = BENCH_LINES;
+    if (argc > 1) {
+        lines = (unsigned)strtoul(argv[1], NULL, 0);
+        if (lines == 0) {
+            fprintf(stderr, "usage: %s [lines]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    for (unsigned i = 0; i < VIDEO_CAPTURE_SAMPLES; i++) {
+        capture_buffer[i] = (uint8_t)(i * 7);
+    }
+
+    printf("PicoCrypt FPV resampler benchmark (%u lines per run)\n", lines);
+    printf("Profile: %s, %u ADC samples at %.2f MHz -> %u at %.2f MHz (%u/%u)\n",
+           VIDEO_PROFILE_NAME, VIDEO_CAPTURE_SAMPLES, VIDEO_ADC_RATE_HZ / 1e6,
+           VIDEO_LINE_SAMPLES, VIDEO_SAMPLE_RATE_HZ / 1e6,
+           VIDEO_RESAMPLE_UP, VIDEO_RESAMPLE_DOWN);
+    printf("taps  ns/line     ns/out sample  host cycles/line  cycles/sample  of line\n");
+    bench(lines);
+    printf("Line period: %.1f us, %u clk_sys cycles at %u kHz on the RP2040\n",
+           VIDEO_LINE_PERIOD_NS / 1000.0,
+           (unsigned)((uint64_t)SYS_CLK_KHZ * VIDEO_LINE_PERIOD_NS / 1000000), SYS_CLK_KHZ);
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*
+ * PicoCrypt FPV - Resampler Test (host)
+ * Output length, DC gain, phase alignment and accuracy of the ADC -> output
+ * rate resampler for the build's video profile
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "resample.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ===== CONFIGURATION =====
+#define CANARY          0xA5
+#define GUARD           16
+#if RESAMPLE_TAPS == 2
+#define SINE_TOLERANCE  2       // Codes, linear interpolation
+#else
+#define SINE_TOLERANCE  1
+#endif
+
+static int failures = 0;
+static uint8_t buffer[RESAMPLE_BUFFER_SAMPLES + GUARD];
+
+static void check(bool ok, const char* name) {
+    printf("%-40s %s\n", name, ok ? "OK" : "ERROR");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// Capture position of output sample j
+static double input_position(uint32_t j) {
+    return (double)j * VIDEO_RESAMPLE_DOWN / VIDEO_RESAMPLE_UP;
+}
+
+static void capture(double (*signal)(double)) {
+    memset(buffer, CANARY, sizeof(buffer));
+    for (uint32_t i = 0; i < VIDEO_CAPTURE_SAMPLES; i++) {
+        buffer[RESAMPLE_IN_OFFSET + i] = (uint8_t)lrint(signal(i));
+    }
+    resample_line(buffer);
+}
+
+// ===== SIGNALS (in capture samples) =====
+static double level;
+
+static double dc(double x) {
+    return level;
+}
+
+static double ramp(double x) {
+    return x * 255.0 / (VIDEO_CAPTURE_SAMPLES - 1);
+}
+
+static double sine(double x) {
+    // A twentieth of the ADC rate: 500 kHz at 10 MS/s
+    return 128.0 + 96.0 * sin(2.0 * M_PI * x / 20.0);
+}
+
+// ===== TESTS =====
+static bool test_phases(void) {
+    bool ok = true;
+
+    for (uint32_t k = 0; k < VIDEO_RESAMPLE_UP; k++) {
+        const resample_phase_t* p = &resample_phases[k];
+        int32_t sum = 0;
+        for (uint32_t t = 0; t < RESAMPLE_TAPS; t++) {
+            sum += p->w[t];
+        }
+        ok &= sum == 1 << RESAMPLE_SHIFT;
+#if RESAMPLE_TAPS == 2
+        ok &= p->offset == k * VIDEO_RESAMPLE_DOWN / VIDEO_RESAMPLE_UP + 1;
+#else
+        ok &= p->offset == k * VIDEO_RESAMPLE_DOWN / VIDEO_RESAMPLE_UP;
+#endif
+    }
+    // Phase 0 passes the input sample through
+    ok &= resample_phases[0].w[RESAMPLE_TAPS / 2 - 1] == 1 << RESAMPLE_SHIFT;
+    return ok;
+}
+
+static bool test_length(void) {
+    level = 64;
+    capture(dc);
+
+    // Writes stop at the buffer's end
+    bool ok = true;
+    for (uint32_t i = RESAMPLE_BUFFER_SAMPLES; i < sizeof(buffer); i++) {
+        ok &= buffer[i] == CANARY;
+    }
+    return ok;
+}
+
+static bool test_dc(void) {
+    bool ok = true;
+
+    for (uint32_t v = 0; v <= 255; v++) {
+        level = v;
+        capture(dc);
+        for (uint32_t j = 0; j < VIDEO_LINE_SAMPLES; j++) {
+            ok &= buffer[j] == v;
+        }
+    }
+    return ok;
+}
+
+static bool test_ramp(void) {
+    bool ok = true;
+
+    // Output j lands on capture position j * DOWN / UP, last sample included
+    capture(ramp);
+    for (uint32_t j = 0; j < VIDEO_LINE_SAMPLES; j++) {
+        double x = input_position(j);
+        double expected = ramp(x < VIDEO_CAPTURE_SAMPLES - 1 ? x : VIDEO_CAPTURE_SAMPLES - 1);
+        ok &= fabs(buffer[j] - expected) <= 1.0;
+    }
+    return ok;
+}
+
+static bool test_sine(void) {
+    double worst = 0.0;
+
+    capture(sine);
+    for (uint32_t j = 0; j < VIDEO_LINE_SAMPLES; j++) {
+        double x = input_position(j);
+        if (x < 1.0 || x > VIDEO_CAPTURE_SAMPLES - 2) {
+            continue;           // Edge hold
+        }
+        double err = fabs(buffer[j] - sine(x));
+        worst = err > worst ? err : worst;
+    }
+    printf("Sine at 1/20 of the ADC rate: max error %.2f codes\n", worst);
+    return worst <= SINE_TOLERANCE;
+}
+
+int main(void) {
+    printf("Resampler: %s, %u -> %u samples per line (%u/%u), %u taps\n\n",
+           VIDEO_PROFILE_NAME, VIDEO_CAPTURE_SAMPLES, VIDEO_LINE_SAMPLES,
+           VIDEO_RESAMPLE_UP, VIDEO_RESAMPLE_DOWN, RESAMPLE_TAPS);
+
+    check(test_phases(), "Phase table sums and offsets");
+    check(test_length(), "Writes stay in the line buffer");
+    check(test_dc(), "DC levels exact on every sample");
+    check(test_ramp(), "Ramp lands on the output grid");
+    check(test_sine(), "Sine within tolerance");
+
+    printf("\n%s\n", failures ? "FAILED" : "All tests passed");
+    return failures ? 1 : 0;
+}
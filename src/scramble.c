@@ -0,0 +1,28 @@
+/*
+ * PicoCrypt FPV - Scrambling Mode
+ */
+
+#include <string.h>
+
+#include "frame_table.h"
+#include "scramble.h"
+
+void scramble_play_line(uint8_t* out, const uint8_t* head, const uint8_t* active,
+                        uint32_t cut) {
+    uint8_t* picture = out + VIDEO_ACTIVE_START;
+    uint8_t* porch = picture + VIDEO_ACTIVE_SAMPLES;
+
+    if (head) {
+        memcpy(out, head, VIDEO_ACTIVE_START);
+        memcpy(porch, head + VIDEO_ACTIVE_START + VIDEO_ACTIVE_SAMPLES,
+               VIDEO_H_FRONT_PORCH_SAMPLES);
+    } else {
+        // As the black line of the field tables
+        memset(out, FRAME_LEVEL_SYNC, VIDEO_H_SYNC_SAMPLES);
+        memset(out + VIDEO_H_SYNC_SAMPLES, FRAME_LEVEL_BLANK,
+               VIDEO_ACTIVE_START - VIDEO_H_SYNC_SAMPLES);
+        memset(porch, FRAME_LEVEL_BLANK, VIDEO_H_FRONT_PORCH_SAMPLES);
+    }
+    memcpy(picture, active + cut, VIDEO_ACTIVE_SAMPLES - cut);
+    memcpy(picture + VIDEO_ACTIVE_SAMPLES - cut, active, cut);
+}
@@ -0,0 +1,251 @@
+/*
+ * PicoCrypt FPV - Sender Pipeline
+ */
+
+#include "platform.h"
+#include "sender.h"
+#include "trace.h"
+
+_Static_assert(RESAMPLE_BUFFER_SAMPLES <= LINE_POOL_MAX_WIDTH,
+               "Line pool slots too small for the resampler");
+
+// ===== ENCRYPTION =====
+
+static void PICOCRYPT_RAM_FUNC(sync_encryption_on_vsync)(sender_t* sender) {
+    // Next frame. The key depends on the frame number alone: the receiver
+    // reads it from the VBI code, so nothing else may change per frame.
+    // A rekey armed for this frame is a pointer flip (rekey.h).
+    bool switched;
+    uint32_t frame = sender->prng->sync_counter + 1;
+    sender->prng = rekey_select(&sender->rekey, frame, &switched);
+    if (switched) {
+        trace_event(TRACE_EV_REKEY, frame, rekey_slot(&sender->rekey));
+    }
+    crypto_seek(sender->prng, frame, 0, 0);
+}
+
+// Returns the picture's cut with SCRAMBLE_ROTATE, else 0. The line
+// check's mask comes from the keystream after the picture's (check_key).
+static uint32_t PICOCRYPT_RAM_FUNC(encrypt_line)(sender_t* sender, uint8_t* line,
+                                                 uint8_t* check_key) {
+    // Active picture only: sync, burst, porches and VBI lines pass through
+    line_span_t span = line_map_crypto_span(sender->line_counter, sender->length);
+    if (span.length == 0) {
+        return 0;
+    }
+
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+    // The line's key only; the output DMA plays the picture from the cut.
+    // Taken from the ring like a line of keystream, so a short capture
+    // (played as is) keeps the lines in step.
+    uint8_t key[SCRAMBLE_KEY_BYTES] = { 0 };
+    if (!keystream_xor_line(&sender->keystream, key, key, SCRAMBLE_KEY_BYTES, check_key)) {
+        keystream_xor_inline(&sender->keystream, sender->prng, key, key, SCRAMBLE_KEY_BYTES,
+                             check_key);
+    }
+    sender->crypto_samples += SCRAMBLE_KEY_BYTES;
+    return span.length == VIDEO_ACTIVE_SAMPLES ? scramble_cut(key) : 0;
+#else
+    // Hot path: XOR with keystream precomputed in blanking.
+    // Ring underrun falls back to generating inline (same keystream).
+    uint8_t* active = line + span.start;
+    if (!keystream_xor_line(&sender->keystream, active, active, span.length, check_key)) {
+        keystream_xor_inline(&sender->keystream, sender->prng, active, active, span.length,
+                             check_key);
+    }
+    sender->crypto_samples += span.length;
+    return 0;
+#endif
+}
+
+static void PICOCRYPT_RAM_FUNC(write_code)(sender_t* sender, uint8_t* line) {
+    // Frame number of this field's keystream, in clear on the code lines
+    if (vbi_code_line(sender->line_counter) < 0 ||
+        sender->length < VIDEO_ACTIVE_START + VIDEO_ACTIVE_SAMPLES) {
+        return;
+    }
+    vbi_code_write(line + VIDEO_ACTIVE_START, sender->prng->sync_counter);
+}
+
+static void PICOCRYPT_RAM_FUNC(write_pilot)(sender_t* sender, uint8_t* line) {
+    // Timing reference for the receiver, on every line played from a buffer
+    if (!pilot_line(sender->line_counter)) {
+        return;
+    }
+    pilot_write(line);
+}
+
+static bool PICOCRYPT_RAM_FUNC(check_line)(sender_t* sender) {
+    // Whole active lines: the receiver sums the same picture
+    return line_map_is_active(sender->line_counter) &&
+           sender->length >= VIDEO_ACTIVE_START + VIDEO_ACTIVE_SAMPLES;
+}
+
+static void PICOCRYPT_RAM_FUNC(queue_desc)(sender_t* sender, const line_desc_t* desc) {
+    // The pool bounds lines in flight, so the ring only fills if core 1 stalls
+    while (!line_queue_push(&sender->queue, desc)) {
+        // Wait for core 1
+    }
+}
+
+// ===== INITIALIZATION =====
+void sender_init(sender_t* sender, const crypto_key_t* key, uint32_t slot, uint32_t frame,
+                 uint32_t length, hal_video_in_t* in, hal_video_out_t* out,
+                 hal_line_sum_t* sum) {
+    line_pool_init(&sender->pool);
+    line_queue_init(&sender->queue);
+    video_input_init(&sender->input, &sender->pool, in, RESAMPLE_IN_OFFSET,
+                     VIDEO_CAPTURE_SAMPLES);
+    sender->out = out;
+    sender->length = length;
+
+    sender->sum = sum;
+    rekey_init(&sender->rekey, key, slot, frame);
+    sender->prng = &sender->rekey.generators[0];
+    keystream_ring_init(&sender->keystream, SCRAMBLE_MODE == SCRAMBLE_ROTATE ? SCRAMBLE_KEY_BYTES
+                        : line_map_crypto_span(VIDEO_VBI_LINES, length).length,
+                        LINE_CHECK_KEY_BYTES);
+    keystream_prefetch(&sender->keystream, sender->prng, KEYSTREAM_RING_LINES);
+    sender->line_counter = 0;
+    sender->reported_overruns = 0;
+    sender->crypto_samples = 0;
+
+    sender->frames_output = 0;
+}
+
+// ===== CORE 0: CAPTURE & ENCRYPT =====
+bool PICOCRYPT_RAM_FUNC(sender_hsync)(sender_t* sender) {
+    // The capture runs in the background while the previous line is encrypted
+    return video_input_hsync(&sender->input);
+}
+
+bool PICOCRYPT_RAM_FUNC(sender_capture_step)(sender_t* sender) {
+    video_input_poll(&sender->input);
+
+    // Resample and encrypt the oldest captured line in place
+    int slot = line_pool_peek(&sender->pool, LINE_STAGE_CRYPTO);
+    if (slot < 0) {
+        return false;
+    }
+    uint8_t* line = line_pool_buffer(&sender->pool, slot);
+    resample_line(line);
+
+    // The sniffer sums the plaintext picture while the sync tip is
+    // written; XOR encrypts in place, so only once the sum is in. The
+    // check goes in last, masked with the line's keystream.
+    bool check = check_line(sender);
+    uint32_t sum = 0;
+    uint8_t check_key[LINE_CHECK_KEY_BYTES];
+    if (check) {
+        hal_line_sum_start(sender->sum, line + VIDEO_ACTIVE_START, VIDEO_ACTIVE_SAMPLES);
+    }
+    write_code(sender, line);
+    write_pilot(sender, line);
+    if (check) {
+        sum = hal_line_sum_finish(sender->sum);
+    }
+    uint32_t cut = encrypt_line(sender, line, check_key);
+    if (check) {
+        line_check_write(line, sum, line_check_mask(check_key));
+    }
+    line_pool_advance_at(&sender->pool, LINE_STAGE_CRYPTO, hal_time_us());
+
+    // Describe the line for core 1
+    line_desc_t desc = {
+        .slot = (uint8_t)slot,
+        .line = (uint16_t)sender->line_counter,
+        .frame = sender->prng->sync_counter,
+        .timestamp_us = line_pool_capture_time(&sender->pool, slot),
+        .cut = (uint16_t)cut,
+    };
+    if (sender->prng->sync_counter & 1) {
+        desc.flags |= LINE_FLAG_FIELD;
+    }
+    if (sender->pool.overruns != sender->reported_overruns) {
+        desc.flags |= LINE_FLAG_ERROR;
+        sender->reported_overruns = sender->pool.overruns;
+        trace_event(TRACE_EV_OVERRUN, sender->pool.overruns, sender->line_counter);
+    }
+    queue_desc(sender, &desc);
+
+    sender->line_counter++;
+
+    // H-blanking: precompute keystream for an upcoming line
+    keystream_prefetch(&sender->keystream, sender->prng, 1);
+
+    return true;
+}
+
+void PICOCRYPT_RAM_FUNC(sender_vsync)(sender_t* sender) {
+    trace_event(TRACE_EV_VSYNC, sender->prng->sync_counter, sender->line_counter);
+
+    // Reset line counter
+    sender->line_counter = 0;
+
+    // Resynchronize encryption
+    sync_encryption_on_vsync(sender);
+
+    // Refill the keystream ring during V-blanking
+    // (VIDEO_VBI_LINES lines before active video)
+    keystream_ring_reset(&sender->keystream);
+    keystream_prefetch(&sender->keystream, sender->prng, KEYSTREAM_RING_LINES);
+
+    line_desc_t desc = {
+        .flags = LINE_FLAG_VSYNC,
+        .frame = sender->prng->sync_counter,
+        .timestamp_us = hal_time_us(),
+    };
+    queue_desc(sender, &desc);
+}
+
+bool sender_rekey(sender_t* sender, const crypto_key_t* key, uint32_t slot, uint32_t frame) {
+    return rekey_schedule(&sender->rekey, key, slot, frame);
+}
+
+// ===== CORE 1: OUTPUT =====
+static bool PICOCRYPT_RAM_FUNC(submit_line)(sender_t* sender, const uint8_t* line, uint32_t cut) {
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+    if (cut != 0) {
+        return hal_video_out_submit_rotated(sender->out, line, line + VIDEO_ACTIVE_START, cut);
+    }
+#endif
+    return hal_video_out_submit(sender->out, line, sender->length);
+}
+
+void PICOCRYPT_RAM_FUNC(sender_retire)(sender_t* sender) {
+    for (uint32_t n = hal_video_out_poll(sender->out); n > 0; n--) {
+        line_pool_retire(&sender->pool, hal_time_us());
+    }
+}
+
+uint32_t PICOCRYPT_RAM_FUNC(sender_output_step)(sender_t* sender) {
+    uint32_t vsyncs = 0;
+    line_desc_t desc;
+
+    sender_retire(sender);
+
+    while (line_queue_pop(&sender->queue, &desc)) {
+        if (desc.flags & LINE_FLAG_VSYNC) {
+            hal_video_out_field(sender->out);
+            sender->frames_output++;
+            vsyncs++;
+            continue;
+        }
+
+        // Encrypted slot from core 0: swap it into its line of the field
+        uint8_t* line = line_pool_buffer(&sender->pool, desc.slot);
+        while (!submit_line(sender, line, desc.cut)) {
+            sender_retire(sender);
+        }
+        line_pool_advance_at(&sender->pool, LINE_STAGE_OUTPUT, hal_time_us());
+    }
+
+    return vsyncs;
+}
+
+// ===== STATISTICS =====
+void sender_report_latency(sender_t* sender, line_hist_snapshot_t since[LINE_LAT_COUNT]) {
+    // Core recording each stage: capture and crypto on 0, output on 1
+    static const uint8_t cores[LINE_LAT_COUNT] = { 0, 0, 1, 1, 1, 1 };
+    line_pool_report(&sender->pool, since, cores, trace_printf);
+}
@@ -0,0 +1,268 @@
+/*
+ * PicoCrypt FPV - SRAM Contention Benchmark
+ * Line-loop cycle jitter per code and buffer placement (include/sram_map.h)
+ *
+ * Reproduces the bus traffic of one line: a capture DMA writing one line
+ * buffer and an output DMA reading another, both paced at the profile's
+ * sample rate, while core 0 XORs the active region of a third buffer and
+ * core 1 copies striped RAM and streams flash (evicting the XIP cache).
+ * SysTick times the XOR of every line; the spread between the fastest and
+ * slowest line is the jitter a placement adds to the per-line cost.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/structs/systick.h"
+#include "hardware/structs/timer.h"
+#include "hardware/structs/watchdog.h"
+
+#include "crypto.h"
+#include "sram_map.h"
+#include "video_profile.h"
+
+// ===== CONFIGURATION =====
+#define BENCH_LINES         1024
+#define BENCH_WORDS         ((VIDEO_LINE_SAMPLES + 3) / 4)
+#define BENCH_LOAD_BYTES    4096        // Core 1 copy per pass
+#define BENCH_FLASH_BYTES   (32 * 1024) // > 16 KB XIP cache
+
+typedef enum {
+    BUF_CAPTURE = 0,            // Written by the capture DMA
+    BUF_CRYPTO,                 // XORed by core 0
+    BUF_OUTPUT,                 // Read by the output DMA
+    BUF_COUNT
+} bench_buf_t;
+
+typedef enum {
+    PLACE_STRIPED = 0,          // Linker default
+    PLACE_BANKED,               // One bank per buffer (SRAM_PLACEMENT_BANKED)
+    PLACE_ONE_BANK,             // All three in bank 0: worst case
+    PLACE_COUNT
+} bench_place_t;
+
+static const char* place_names[PLACE_COUNT] = { "striped", "bank per buffer", "one bank" };
+
+// Word-interleaved rows: column k of every row is in bank k
+static uint32_t banked[BUF_COUNT][BENCH_WORDS][SRAM_BANKS] __attribute__((aligned(16)));
+static uint8_t striped[BUF_COUNT][BENCH_WORDS * 4] __attribute__((aligned(4)));
+static uint8_t keystream_line[VIDEO_ACTIVE_SAMPLES] __attribute__((aligned(4)));
+static uint16_t cycles[BENCH_LINES];
+
+static uint8_t load_a[BENCH_LOAD_BYTES] __attribute__((aligned(4)));
+static uint8_t load_b[BENCH_LOAD_BYTES] __attribute__((aligned(4)));
+static const uint8_t flash_table[BENCH_FLASH_BYTES] = { 1 };
+static volatile bool load_enabled;
+static volatile uint32_t load_sink;
+
+// ===== CYCLE COUNTER =====
+static void systick_start(void) {
+    systick_hw->rvr = 0x00FFFFFF;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;      // Enable, processor clock, no interrupt
+}
+
+static inline uint32_t systick_now(void) {
+    return systick_hw->cvr;
+}
+
+static inline uint32_t systick_elapsed(uint32_t start, uint32_t end) {
+    return (start - end) & 0x00FFFFFF;
+}
+
+// ===== KERNELS =====
+// Same word loop as crypto_xor_buffers(), left in XIP flash
+static void __attribute__((noinline)) xor_line_flash(const uint8_t* input,
+                                                     const uint8_t* keystream,
+                                                     uint8_t* output, size_t length) {
+    const uint32_t* in_32 = (const uint32_t*)input;
+    const uint32_t* ks_32 = (const uint32_t*)keystream;
+    uint32_t* out_32 = (uint32_t*)output;
+
+    for (size_t i = 0; i < length / 4; i++) {
+        out_32[i] = in_32[i] ^ ks_32[i];
+    }
+}
+
+// Core 1: striped RAM copies plus flash reads that thrash the XIP cache
+static void core1_load(void) {
+    uint32_t offset = 0;
+
+    while (true) {
+        if (!load_enabled) {
+            tight_loop_contents();
+            continue;
+        }
+        memcpy(load_b, load_a, sizeof(load_a));
+        for (uint32_t i = 0; i < 256; i++) {
+            load_sink += flash_table[offset];
+            offset = (offset + 64) % BENCH_FLASH_BYTES;     // One cache line each
+        }
+    }
+}
+
+// ===== DMA TRAFFIC =====
+typedef struct {
+    int capture;
+    int output;
+    dma_channel_config capture_config;
+    dma_channel_config output_config;
+} bench_dma_t;
+
+static uint32_t gcd(uint32_t a, uint32_t b) {
+    while (b) {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static void bench_dma_init(bench_dma_t* dma) {
+    // Pace both channels at the sample rate with a DMA timer (unpaced if
+    // the ratio does not fit 16 bits: more traffic, not less)
+    uint32_t sys_hz = clock_get_hz(clk_sys);
+    uint32_t div = gcd(VIDEO_SAMPLE_RATE_HZ, sys_hz);
+    uint32_t num = VIDEO_SAMPLE_RATE_HZ / div;
+    uint32_t den = sys_hz / div;
+    uint dreq = DREQ_FORCE;
+
+    if (num <= 0xFFFF && den <= 0xFFFF) {
+        int timer = dma_claim_unused_timer(true);
+        dma_timer_set_fraction(timer, num, den);
+        dreq = dma_get_timer_dreq(timer);
+    }
+
+    dma->capture = dma_claim_unused_channel(true);
+    dma->output = dma_claim_unused_channel(true);
+
+    // Capture: APB register (like the ADC FIFO) into the line buffer
+    dma_channel_config c = dma_channel_get_default_config(dma->capture);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, dreq);
+    dma->capture_config = c;
+
+    // Output: line buffer into a harmless APB register (like the PIO FIFO)
+    c = dma_channel_get_default_config(dma->output);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, dreq);
+    dma->output_config = c;
+}
+
+static void bench_dma_start(bench_dma_t* dma, uint8_t* capture, const uint8_t* output) {
+    dma_channel_configure(dma->capture, &dma->capture_config, capture,
+                          &timer_hw->timerawl, VIDEO_LINE_SAMPLES, false);
+    dma_channel_configure(dma->output, &dma->output_config, &watchdog_hw->scratch[0],
+                          output, VIDEO_LINE_SAMPLES, false);
+    dma_start_channel_mask((1u << dma->capture) | (1u << dma->output));
+}
+
+static void bench_dma_wait(bench_dma_t* dma) {
+    dma_channel_wait_for_finish_blocking(dma->capture);
+    dma_channel_wait_for_finish_blocking(dma->output);
+}
+
+// ===== MEASUREMENT =====
+static void place_buffers(bench_place_t place, uint8_t* buffers[BUF_COUNT]) {
+    for (int b = 0; b < BUF_COUNT; b++) {
+        switch (place) {
+        case PLACE_STRIPED:  buffers[b] = striped[b]; break;
+        case PLACE_BANKED:   buffers[b] = sram_bank_view(banked[0], b); break;
+        case PLACE_ONE_BANK: buffers[b] = sram_bank_view(banked[b], 0); break;
+        default: break;
+        }
+    }
+}
+
+static int compare_u16(const void* a, const void* b) {
+    return (int)*(const uint16_t*)a - (int)*(const uint16_t*)b;
+}
+
+static void run(const char* code, bool in_ram, bench_place_t place, bool traffic,
+                bench_dma_t* dma, uint32_t budget) {
+    uint8_t* buffers[BUF_COUNT];
+    uint64_t total = 0;
+
+    place_buffers(place, buffers);
+    uint8_t* active = buffers[BUF_CRYPTO] + VIDEO_ACTIVE_START - VIDEO_ACTIVE_START % 4;
+
+    load_enabled = traffic;
+    for (int line = 0; line < BENCH_LINES; line++) {
+        if (traffic) {
+            bench_dma_start(dma, buffers[BUF_CAPTURE], buffers[BUF_OUTPUT]);
+        }
+
+        uint32_t t0 = systick_now();
+        if (in_ram) {
+            crypto_xor_buffers(active, keystream_line, active, VIDEO_ACTIVE_SAMPLES);
+        } else {
+            xor_line_flash(active, keystream_line, active, VIDEO_ACTIVE_SAMPLES);
+        }
+        uint32_t t1 = systick_now();
+
+        cycles[line] = (uint16_t)systick_elapsed(t0, t1);
+        total += cycles[line];
+        if (traffic) {
+            bench_dma_wait(dma);
+        }
+    }
+    load_enabled = false;
+
+    qsort(cycles, BENCH_LINES, sizeof(cycles[0]), compare_u16);
+    uint32_t min = cycles[0];
+    uint32_t p99 = cycles[BENCH_LINES * 99 / 100];
+    uint32_t max = cycles[BENCH_LINES - 1];
+
+    printf("%-6s %-16s %-8s avg %5lu  min %5lu  p99 %5lu  max %5lu  jitter %4lu (%4.1f%% of line)\n",
+           code, place_names[place], traffic ? "loaded" : "quiet",
+           (unsigned long)(total / BENCH_LINES), (unsigned long)min, (unsigned long)p99,
+           (unsigned long)max, (unsigned long)(max - min), 100.0f * (max - min) / budget);
+}
+
+static void measure(bench_dma_t* dma) {
+    uint32_t budget = clock_get_hz(clk_sys) / 1000000 * VIDEO_LINE_PERIOD_NS / 1000;
+
+    printf("\nSRAM placement: XOR of %u active samples, %s, clk_sys %lu Hz, line %lu cycles\n",
+           VIDEO_ACTIVE_SAMPLES, VIDEO_PROFILE_NAME, (unsigned long)clock_get_hz(clk_sys),
+           (unsigned long)budget);
+    printf("Build default: %s\n",
+           SRAM_BANKED ? "line pool slot per bank" : "line pool striped");
+
+    run("sram", true, PLACE_STRIPED, false, dma, budget);
+    for (int place = 0; place < PLACE_COUNT; place++) {
+        run("sram", true, (bench_place_t)place, true, dma, budget);
+    }
+    for (int place = 0; place < PLACE_COUNT; place++) {
+        run("flash", false, (bench_place_t)place, true, dma, budget);
+    }
+}
+
+// ===== MAIN FUNCTION =====
+int main() {
+    static bench_dma_t dma;
+
+    stdio_init_all();
+    systick_start();
+
+    for (uint32_t i = 0; i < sizeof(keystream_line); i++) {
+        keystream_line[i] = (uint8_t)(i * 37);
+    }
+    bench_dma_init(&dma);
+    multicore_launch_core1(core1_load);
+
+    while (true) {
+        measure(&dma);
+        sleep_ms(2000);
+    }
+
+    return 0;
+}
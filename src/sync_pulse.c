@@ -0,0 +1,101 @@
+/*
+ * PicoCrypt FPV - Sync Pulse Classifier
+ */
+
+#include "platform.h"
+#include "sync_pulse.h"
+
+static uint32_t samples_to_ticks(uint32_t samples, uint32_t tick_hz) {
+    return (uint32_t)((uint64_t)samples * tick_hz / VIDEO_SAMPLE_RATE_HZ);
+}
+
+void sync_pulse_init(sync_pulse_t* sep, uint32_t tick_hz) {
+    uint32_t h = samples_to_ticks(VIDEO_H_SYNC_SAMPLES, tick_hz);
+    uint32_t line = samples_to_ticks(VIDEO_LINE_SAMPLES, tick_hz);
+
+    // Nominal: equalising H/2, H-Sync H, broad line/2 - H. The broad limit
+    // sits between a broad pulse and the high time between equalising
+    // pulses (line/2 - H/2), so mispaired edges never look broad.
+    sep->line_ticks = line;
+    sep->glitch_max = h / 4;
+    sep->equalising_max = h * 3 / 4;
+    sep->hsync_max = h * 2;
+    sep->broad_min = line / 4;
+    sep->broad_max = line / 2 - h * 3 / 4;
+
+    sep->have_fall = false;
+    sep->fall = 0;
+    sep->have_line = false;
+    sep->last_line = 0;
+    sep->in_broad = false;
+    for (int k = 0; k < SYNC_PULSE_KIND_COUNT; k++) {
+        sep->counts[k] = 0;
+    }
+    sep->resyncs = 0;
+}
+
+sync_pulse_kind_t PICOCRYPT_RAM_FUNC(sync_pulse_classify)(const sync_pulse_t* sep,
+                                                          uint32_t width) {
+    if (width <= sep->glitch_max) {
+        return SYNC_PULSE_INVALID;
+    }
+    if (width <= sep->equalising_max) {
+        return SYNC_PULSE_EQUALISING;
+    }
+    if (width <= sep->hsync_max) {
+        return SYNC_PULSE_HSYNC;
+    }
+    if (width >= sep->broad_min && width <= sep->broad_max) {
+        return SYNC_PULSE_BROAD;
+    }
+    return SYNC_PULSE_INVALID;
+}
+
+bool PICOCRYPT_RAM_FUNC(sync_pulse_word)(sync_pulse_t* sep, uint32_t word,
+                                         sync_event_t* event) {
+    uint32_t ticks = 0u - word;         // Timer counts down
+
+    if (!sep->have_fall) {
+        sep->fall = ticks;
+        sep->have_fall = true;
+        return false;
+    }
+    sep->have_fall = false;
+
+    uint32_t width = ticks - sep->fall;
+    if (width > sep->broad_max) {
+        // That was a high time: this edge is a falling one
+        sep->fall = ticks;
+        sep->have_fall = true;
+        sep->resyncs++;
+        return false;
+    }
+
+    sync_pulse_kind_t kind = sync_pulse_classify(sep, width);
+    sep->counts[kind]++;
+    if (kind == SYNC_PULSE_INVALID) {
+        return false;
+    }
+
+    uint32_t fall = sep->fall;
+    uint32_t since = fall - sep->last_line;
+    event->flags = 0;
+    event->ticks = fall;
+
+    if (kind == SYNC_PULSE_BROAD && !sep->in_broad) {
+        uint32_t phase = sep->have_line ? since % sep->line_ticks : 0;
+        event->flags |= SYNC_EVENT_FIELD;
+        event->field = phase >= sep->line_ticks / 4 && phase < sep->line_ticks * 3 / 4;
+    }
+    sep->in_broad = kind == SYNC_PULSE_BROAD;
+
+    if (!sep->have_line || since >= sep->line_ticks * 3 / 4) {
+        event->flags |= SYNC_EVENT_LINE;
+        uint32_t lines = sep->have_line ? (since + sep->line_ticks / 2) / sep->line_ticks : 1;
+        event->lines = (uint16_t)(lines < UINT16_MAX ? lines : UINT16_MAX);
+        sep->last_line = fall;
+        sep->have_line = true;
+    }
+
+    return event->flags != 0;
+}
@@ -0,0 +1,195 @@
+/*
+ * PicoCrypt FPV - Sync Pulse Classifier Test (host)
+ * Line and field events from a synthetic sync train of the build's profile
+ *
+ * The train follows the standard layout in half-line slots: per field five
+ * broad pulses, five post-equalising pulses, H-Sync on every line-aligned
+ * slot and five pre-equalising pulses before the next field. Edges are
+ * stamped like the PIO timer (down-counter, wrapping) with a few ticks of
+ * jitter.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "sync_pulse.h"
+
+#define TICK_HZ             62500000u   // 125 MHz clk_sys, 2 cycles per tick
+#define TEST_FRAMES         4
+#define FIELD_HALF_LINES    (2 * VIDEO_TOTAL_LINES / VIDEO_FIELDS)
+
+static int failures = 0;
+
+static void check(bool ok, const char* name) {
+    printf("%-40s %s\n", name, ok ? "OK" : "ERROR");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// ===== SYNC TRAIN =====
+typedef struct {
+    sync_pulse_t sep;
+    uint32_t rng;
+    uint32_t lines;             // LINE events (sum of their line counts)
+    uint32_t fields;
+    uint32_t field_lines[2 * TEST_FRAMES * VIDEO_FIELDS];
+    uint8_t parity[2 * TEST_FRAMES * VIDEO_FIELDS];
+    uint32_t bad_line_counts;   // LINE events with lines != 1
+    uint32_t skip_words;        // Drop this many words at the start
+} train_t;
+
+static uint32_t jitter(train_t* t) {
+    t->rng ^= t->rng << 13;
+    t->rng ^= t->rng >> 17;
+    t->rng ^= t->rng << 5;
+    return t->rng % 5;
+}
+
+static void feed(train_t* t, uint32_t ticks) {
+    sync_event_t ev;
+
+    if (t->skip_words > 0) {
+        t->skip_words--;
+        return;
+    }
+    if (!sync_pulse_word(&t->sep, 0u - ticks, &ev)) {
+        return;
+    }
+    if (ev.flags & SYNC_EVENT_FIELD) {
+        if (t->fields < sizeof(t->parity)) {
+            t->parity[t->fields] = ev.field;
+        }
+        t->fields++;
+    }
+    if (ev.flags & SYNC_EVENT_LINE) {
+        t->lines += ev.lines;
+        t->bad_line_counts += ev.lines != 1;
+        if (t->fields > 0 && t->fields <= sizeof(t->field_lines) / sizeof(t->field_lines[0])) {
+            t->field_lines[t->fields - 1] += ev.lines;
+        }
+    }
+}
+
+static void pulse(train_t* t, uint32_t start, uint32_t width) {
+    uint32_t fall = start + jitter(t);
+    feed(t, fall);
+    feed(t, fall + width);
+}
+
+// Half-line slots [first, last) of the train, timer starting at `base`
+static void run_train(train_t* t, uint32_t base, uint32_t first, uint32_t last) {
+    uint32_t line = t->sep.line_ticks;
+    uint32_t h = (uint32_t)((uint64_t)VIDEO_H_SYNC_SAMPLES * TICK_HZ / VIDEO_SAMPLE_RATE_HZ);
+
+    for (uint32_t slot = first; slot < last; slot++) {
+        uint32_t n = slot % FIELD_HALF_LINES;
+        uint32_t start = base + (uint32_t)((uint64_t)slot * line / 2);
+
+        if (n < 5) {
+            pulse(t, start, line / 2 - h);
+        } else if (n < 10 || n >= FIELD_HALF_LINES - 5) {
+            pulse(t, start, h / 2);
+        } else if (slot % 2 == 0) {
+            pulse(t, start, h);
+        }
+    }
+}
+
+static void train_init(train_t* t) {
+    *t = (train_t){ .rng = 0x2545F491u };
+    sync_pulse_init(&t->sep, TICK_HZ);
+}
+
+// ===== TESTS =====
+static train_t train;
+
+static bool test_classify(void) {
+    sync_pulse_t* sep = &train.sep;
+    uint32_t h = (uint32_t)((uint64_t)VIDEO_H_SYNC_SAMPLES * TICK_HZ / VIDEO_SAMPLE_RATE_HZ);
+    bool ok = true;
+
+    train_init(&train);
+    ok &= sync_pulse_classify(sep, h / 8) == SYNC_PULSE_INVALID;
+    ok &= sync_pulse_classify(sep, h / 2) == SYNC_PULSE_EQUALISING;
+    ok &= sync_pulse_classify(sep, h) == SYNC_PULSE_HSYNC;
+    ok &= sync_pulse_classify(sep, sep->line_ticks / 2 - h) == SYNC_PULSE_BROAD;
+    ok &= sync_pulse_classify(sep, h * 3) == SYNC_PULSE_INVALID;
+    // High time between equalising pulses must not look broad
+    ok &= sync_pulse_classify(sep, sep->line_ticks / 2 - h / 2) == SYNC_PULSE_INVALID;
+    return ok;
+}
+
+static bool test_fields(void) {
+    bool ok = true;
+    uint32_t total = TEST_FRAMES * FIELD_HALF_LINES * VIDEO_FIELDS;
+
+    // Timer wraps during the train
+    train_init(&train);
+    run_train(&train, 0xFFF00000u, 0, total);
+
+    ok &= train.fields == TEST_FRAMES * VIDEO_FIELDS;
+    ok &= train.lines == TEST_FRAMES * VIDEO_TOTAL_LINES;
+    ok &= train.bad_line_counts == 0;
+    ok &= train.sep.resyncs == 0;
+    ok &= train.sep.counts[SYNC_PULSE_INVALID] == 0;
+    ok &= train.sep.counts[SYNC_PULSE_BROAD] == 5 * train.fields;
+    ok &= train.sep.counts[SYNC_PULSE_EQUALISING] == 10 * train.fields;
+    for (uint32_t f = 0; f < train.fields; f++) {
+        // Interlaced: the second field starts mid-line and is a line shorter
+        uint32_t second = VIDEO_FIELDS == 2 && f % 2 == 1;
+        ok &= train.parity[f] == second;
+        ok &= train.field_lines[f] == (FIELD_HALF_LINES + 1 - second * 2) / 2;
+    }
+    printf("  %u fields, %u lines, first field %u lines\n",
+           train.fields, train.lines, train.field_lines[0]);
+    return ok;
+}
+
+static bool test_resync(void) {
+    bool ok = true;
+    uint32_t start = 100 * 2;       // Mid-field
+    uint32_t end = start + 2 * FIELD_HALF_LINES * VIDEO_FIELDS;
+
+    // Join mid-stream on a rising edge: pairing must recover before V-Sync
+    train_init(&train);
+    train.skip_words = 1;
+    run_train(&train, 12345, start, end);
+
+    ok &= train.sep.resyncs >= 1;
+    ok &= train.fields == 2 * VIDEO_FIELDS;
+    for (uint32_t f = 1; f < train.fields; f++) {
+        ok &= train.parity[f] != train.parity[f - 1] || VIDEO_FIELDS == 1;
+    }
+    printf("  %u resync(s), %u fields\n", train.sep.resyncs, train.fields);
+    return ok;
+}
+
+static bool test_glitch(void) {
+    bool ok = true;
+    uint32_t h = (uint32_t)((uint64_t)VIDEO_H_SYNC_SAMPLES * TICK_HZ / VIDEO_SAMPLE_RATE_HZ);
+
+    // A glitch mid-line and a missing H-Sync
+    train_init(&train);
+    run_train(&train, 0, 0, 40);
+    uint32_t line = train.sep.line_ticks;
+    pulse(&train, 40 * line / 2 + line / 3, h / 8);
+    run_train(&train, 0, 42, 60);
+
+    ok &= train.sep.counts[SYNC_PULSE_INVALID] == 1;
+    ok &= train.lines == 30;
+    ok &= train.bad_line_counts == 1;       // 2 lines across the gap
+    return ok;
+}
+
+int main(void) {
+    printf("Sync pulse classifier test (%s, %u Hz timer)\n\n", VIDEO_PROFILE_NAME, TICK_HZ);
+
+    check(test_classify(), "Pulse width classes");
+    check(test_fields(), "Line and field events");
+    check(test_resync(), "Edge pairing recovery");
+    check(test_glitch(), "Glitch and missing pulse");
+
+    printf("\n%s\n", failures ? "FAILED" : "All tests passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * PicoCrypt FPV - Event Trace
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "hal.h"
+#include "platform.h"
+#include "trace.h"
+
+#define TRACE_DRAIN_BATCH       8       // Frames per debug write
+
+static trace_ring_t rings[TRACE_CORES];
+
+// Queued text: written and drained by the same core
+static char text[TRACE_TEXT_SIZE];
+static uint32_t text_head;
+static uint32_t text_tail;
+
+void trace_init(void) {
+    for (int c = 0; c < TRACE_CORES; c++) {
+        atomic_store_explicit(&rings[c].head, 0, memory_order_relaxed);
+        atomic_store_explicit(&rings[c].tail, 0, memory_order_relaxed);
+        atomic_store_explicit(&rings[c].dropped, 0, memory_order_relaxed);
+        rings[c].reported = 0;
+        rings[c].seq = 0;
+    }
+    text_head = 0;
+    text_tail = 0;
+}
+
+void PICOCRYPT_RAM_FUNC(trace_event)(trace_event_t event, uint32_t arg0, uint32_t arg1) {
+    uint32_t core = hal_core_num();
+    trace_ring_t* ring = &rings[core];
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    // Full: count it, never wait for the drain
+    if (head - atomic_load_explicit(&ring->tail, memory_order_acquire) >= TRACE_RING_SIZE) {
+        atomic_store_explicit(&ring->dropped,
+                              atomic_load_explicit(&ring->dropped, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+        ring->seq++;
+        return;
+    }
+
+    trace_record_t* record = &ring->records[head & (TRACE_RING_SIZE - 1)];
+    record->event = (uint16_t)event;
+    record->core = (uint8_t)core;
+    record->seq = ring->seq++;
+    record->timestamp_us = hal_time_us();
+    record->arg0 = arg0;
+    record->arg1 = arg1;
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void trace_encode(const trace_record_t* record, uint8_t* frame) {
+    uint8_t sum = 0;
+
+    frame[0] = TRACE_SYNC0;
+    frame[1] = TRACE_SYNC1;
+    memcpy(&frame[2], record, sizeof(*record));     // Little-endian on both ends
+    for (uint32_t i = 0; i < sizeof(*record); i++) {
+        sum += frame[2 + i];
+    }
+    frame[2 + sizeof(*record)] = (uint8_t)~sum;
+}
+
+bool trace_printf(const char* format, ...) {
+    char line[TRACE_TEXT_LINE];
+    va_list args;
+
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (length < 0 || length >= (int)sizeof(line) ||
+        (uint32_t)length > TRACE_TEXT_SIZE - (text_head - text_tail)) {
+        return false;
+    }
+
+    for (int i = 0; i < length; i++) {
+        text[text_head++ & (TRACE_TEXT_SIZE - 1)] = line[i];
+    }
+    return true;
+}
+
+uint32_t trace_drain(void) {
+    uint8_t batch[TRACE_DRAIN_BATCH * TRACE_FRAME_SIZE];
+    uint32_t written = 0;
+
+    // Text first: records never land inside a reply
+    while (text_tail != text_head) {
+        uint32_t start = text_tail & (TRACE_TEXT_SIZE - 1);
+        uint32_t length = text_head - text_tail;
+        uint32_t room = hal_debug_room();
+        if (length > TRACE_TEXT_SIZE - start) {
+            length = TRACE_TEXT_SIZE - start;
+        }
+        if (length > room) {
+            length = room;
+        }
+        if (length == 0) {
+            return written;
+        }
+        hal_debug_write((const uint8_t*)&text[start], length);
+        text_tail += length;
+        written++;
+    }
+
+    for (int c = 0; c < TRACE_CORES; c++) {
+        trace_ring_t* ring = &rings[c];
+
+        for (;;) {
+            uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+            uint32_t dropped = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+            uint32_t frames = 0;
+
+            if (head == tail && dropped == ring->reported) {
+                break;
+            }
+            uint32_t room = hal_debug_room() / TRACE_FRAME_SIZE;
+            if (room > TRACE_DRAIN_BATCH) {
+                room = TRACE_DRAIN_BATCH;
+            }
+            if (room == 0) {
+                return written;
+            }
+
+            // Losses show up as sequence gaps too; the count tells the
+            // decoder they happened on the device, not on the link
+            if (dropped != ring->reported) {
+                trace_record_t lost = {
+                    .event = TRACE_EV_DROPPED,
+                    .core = (uint8_t)c,
+                    .timestamp_us = hal_time_us(),
+                    .arg0 = (uint32_t)c,
+                    .arg1 = dropped - ring->reported,
+                };
+                trace_encode(&lost, &batch[0]);
+                ring->reported = dropped;
+                frames++;
+            }
+            while (frames < room && tail != head) {
+                trace_encode(&ring->records[tail & (TRACE_RING_SIZE - 1)],
+                             &batch[frames * TRACE_FRAME_SIZE]);
+                tail++;
+                frames++;
+            }
+
+            // Slots are free once encoded
+            atomic_store_explicit(&ring->tail, tail, memory_order_release);
+            hal_debug_write(batch, frames * TRACE_FRAME_SIZE);
+            written += frames;
+        }
+    }
+
+    return written;
+}
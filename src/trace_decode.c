@@ -0,0 +1,316 @@
+/*
+ * PicoCrypt FPV - Event Trace Decoder (host)
+ * Turns the binary trace stream back into a readable log and a timeline
+ *
+ * Input is the raw USB CDC stream of either firmware (or fpv_sim -t):
+ * trace frames interleaved with ordinary stdio text. Frames are decoded
+ * and printed with timestamps; text passes through prefixed with "|".
+ * Lost records are reported two ways: TRACE_EV_DROPPED records (ring full
+ * on the device) and per-core sequence gaps (either cause).
+ *
+ * Usage: trace_decode [-j timeline.json] [-q] [trace.bin]
+ *   -j   also write a Chrome/Perfetto trace-event timeline
+ *   -q   summary only
+ *   Reads stdin without a file, e.g. trace_decode < /dev/ttyACM0
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "trace.h"
+
+// ===== EVENT TABLE =====
+typedef struct {
+    const char* name;
+    const char* arg0;           // NULL: argument unused
+    const char* arg1;
+} event_info_t;
+
+static const event_info_t events[TRACE_EV_COUNT] = {
+    [TRACE_EV_NONE]           = { "none", NULL, NULL },
+    [TRACE_EV_BOOT]           = { "boot", "role", "profile" },
+    [TRACE_EV_CRYPTO_BUDGET]  = { "crypto_budget", "crypto_cycles", "budget_cycles" },
+    [TRACE_EV_CORE_START]     = { "core_start", "core", NULL },
+    [TRACE_EV_VSYNC]          = { "vsync", "frame", "lines" },
+    [TRACE_EV_FIELD_TIMING]   = { "field_timing", "period_us", "expected_us" },
+    [TRACE_EV_SYNC_ERROR]     = { "sync_error", "count", "line" },
+    [TRACE_EV_RELOCK]         = { "relock", "frame", "line" },
+    [TRACE_EV_OVERRUN]        = { "overrun", "count", "line" },
+    [TRACE_EV_DROPPED]        = { "dropped", "core", "records" },
+    [TRACE_EV_CLOCK_PLAN]     = { "clock_plan", "sys_khz", "line_cycles" },
+    [TRACE_EV_CLOCK_DIVIDERS] = { "clock_dividers", "pixel_div_x256", "adc_period_x256" },
+    [TRACE_EV_CPU_LOAD]       = { "cpu_load", "busy_permille", "peak_permille" },
+    [TRACE_EV_REKEY]          = { "rekey", "frame", "slot" },
+};
+
+#define SYNC_ERROR_WARN     10      // Sync errors before the decoder warns
+
+// ===== DECODER STATE =====
+typedef struct {
+    bool quiet;
+    FILE* timeline;
+    bool timeline_first;
+
+    // Timestamp unwrapping (32-bit us wraps every 71 minutes)
+    bool have_time;
+    uint32_t last_raw_us;
+    int64_t last_us;
+
+    // Per-core sequence tracking
+    bool have_seq[TRACE_CORES];
+    uint8_t next_seq[TRACE_CORES];
+    uint32_t seq_gaps[TRACE_CORES];
+    uint32_t dropped[TRACE_CORES];
+
+    uint32_t counts[TRACE_EV_COUNT];
+    uint32_t records;
+    uint32_t unknown;
+    uint32_t bad_checksums;
+    uint32_t text_bytes;
+    bool sync_warned;
+
+    char text[256];
+    size_t text_length;
+} decoder_t;
+
+static int64_t unwrap_us(decoder_t* dec, uint32_t raw_us) {
+    // Signed delta: cores interleave slightly out of order, and wraps
+    // look like a small forward step
+    if (!dec->have_time) {
+        dec->have_time = true;
+        dec->last_us = raw_us;
+    } else {
+        dec->last_us += (int32_t)(raw_us - dec->last_raw_us);
+    }
+    dec->last_raw_us = raw_us;
+    return dec->last_us;
+}
+
+// ===== TEXT =====
+static void flush_text(decoder_t* dec) {
+    if (dec->text_length > 0 && !dec->quiet) {
+        printf("%*s| %.*s\n", 24, "", (int)dec->text_length, dec->text);
+    }
+    dec->text_length = 0;
+}
+
+static void text_byte(decoder_t* dec, uint8_t byte) {
+    dec->text_bytes++;
+    if (byte == '\r') {
+        return;
+    }
+    if (byte == '\n' || dec->text_length == sizeof(dec->text)) {
+        flush_text(dec);
+        if (byte == '\n') {
+            return;
+        }
+    }
+    dec->text[dec->text_length++] = (char)byte;
+}
+
+// ===== RECORDS =====
+static void write_timeline(decoder_t* dec, const trace_record_t* rec,
+                           const event_info_t* info, int64_t ts_us) {
+    if (!dec->timeline) {
+        return;
+    }
+
+    fprintf(dec->timeline, "%s\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%lld,"
+            "\"pid\":0,\"tid\":%u,\"args\":{",
+            dec->timeline_first ? "" : ",", info->name, (long long)ts_us, rec->core);
+    if (info->arg0) {
+        fprintf(dec->timeline, "\"%s\":%u", info->arg0, rec->arg0);
+    }
+    if (info->arg1) {
+        fprintf(dec->timeline, ",\"%s\":%u", info->arg1, rec->arg1);
+    }
+    fputs("}}", dec->timeline);
+    dec->timeline_first = false;
+
+    // Counters as tracks of their own
+    if (rec->event == TRACE_EV_OVERRUN || rec->event == TRACE_EV_SYNC_ERROR) {
+        fprintf(dec->timeline, ",\n{\"name\":\"%ss\",\"ph\":\"C\",\"ts\":%lld,\"pid\":0,"
+                "\"args\":{\"count\":%u}}", info->name, (long long)ts_us, rec->arg0);
+    }
+    if (rec->event == TRACE_EV_CPU_LOAD) {
+        fprintf(dec->timeline, ",\n{\"name\":\"cpu_load core%u\",\"ph\":\"C\",\"ts\":%lld,"
+                "\"pid\":0,\"args\":{\"busy_pct\":%.1f,\"peak_pct\":%.1f}}", rec->core,
+                (long long)ts_us, rec->arg0 / 10.0, rec->arg1 / 10.0);
+    }
+}
+
+static void decode_record(decoder_t* dec, const trace_record_t* rec) {
+    const event_info_t* info;
+    int64_t ts_us = unwrap_us(dec, rec->timestamp_us);
+    uint32_t core = rec->core < TRACE_CORES ? rec->core : 0;
+
+    dec->records++;
+    if (rec->event >= TRACE_EV_COUNT) {
+        dec->unknown++;
+        return;
+    }
+    info = &events[rec->event];
+    dec->counts[rec->event]++;
+
+    // Drop reports are synthesised by the drain, outside the sequence
+    if (rec->event == TRACE_EV_DROPPED) {
+        dec->dropped[core] += rec->arg1;
+    } else {
+        if (dec->have_seq[core] && rec->seq != dec->next_seq[core]) {
+            dec->seq_gaps[core] += (uint8_t)(rec->seq - dec->next_seq[core]);
+        }
+        dec->have_seq[core] = true;
+        dec->next_seq[core] = (uint8_t)(rec->seq + 1);
+    }
+
+    write_timeline(dec, rec, info, ts_us);
+    if (dec->quiet) {
+        return;
+    }
+
+    flush_text(dec);
+    printf("%14.6f s  core%u  %-14s", ts_us / 1e6, rec->core, info->name);
+    if (rec->event == TRACE_EV_BOOT) {
+        printf(" role=%s profile=%u", rec->arg0 == 'S' ? "sender" : "receiver", rec->arg1);
+    } else if (rec->event == TRACE_EV_CLOCK_DIVIDERS) {
+        // 16.8 fixed point: a fraction means a dithered (jittering) clock
+        printf(" pixel_div=%.2f%s adc_period=%.2f%s", rec->arg0 / 256.0,
+               rec->arg0 & 0xFF ? " (dithered)" : "", rec->arg1 / 256.0,
+               rec->arg1 & 0xFF ? " (dithered)" : "");
+    } else if (rec->event == TRACE_EV_CPU_LOAD) {
+        printf(" busy=%u.%u%% peak=%u.%u%%", rec->arg0 / 10, rec->arg0 % 10, rec->arg1 / 10,
+               rec->arg1 % 10);
+    } else {
+        if (info->arg0) printf(" %s=%u", info->arg0, rec->arg0);
+        if (info->arg1) printf(" %s=%u", info->arg1, rec->arg1);
+    }
+    if (rec->event == TRACE_EV_FIELD_TIMING) {
+        printf("  WARNING: irregular field timing");
+    }
+    if (rec->event == TRACE_EV_SYNC_ERROR && rec->arg0 > SYNC_ERROR_WARN && !dec->sync_warned) {
+        printf("  WARNING: multiple sync errors");
+        dec->sync_warned = true;
+    }
+    printf("\n");
+}
+
+// Consume one frame or one text byte; returns bytes used (0: need more)
+static size_t decode_step(decoder_t* dec, const uint8_t* data, size_t length) {
+    if (data[0] != TRACE_SYNC0) {
+        text_byte(dec, data[0]);
+        return 1;
+    }
+    if (length < TRACE_FRAME_SIZE) {
+        return 0;
+    }
+
+    uint8_t sum = 0;
+    for (size_t i = 0; i < sizeof(trace_record_t); i++) {
+        sum += data[2 + i];
+    }
+    uint8_t check = (uint8_t)~sum;
+    if (data[1] != TRACE_SYNC1 || check != data[TRACE_FRAME_SIZE - 1]) {
+        // Not a frame (or a corrupted one): treat the byte as text
+        if (data[1] == TRACE_SYNC1) {
+            dec->bad_checksums++;
+        }
+        text_byte(dec, data[0]);
+        return 1;
+    }
+
+    trace_record_t rec;
+    memcpy(&rec, &data[2], sizeof(rec));
+    decode_record(dec, &rec);
+    return TRACE_FRAME_SIZE;
+}
+
+// ===== MAIN =====
+int main(int argc, char** argv) {
+    static decoder_t dec;
+    const char* timeline_path = NULL;
+    FILE* in = stdin;
+    uint8_t buffer[4096];
+    size_t fill = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "j:q")) != -1) {
+        switch (opt) {
+        case 'j': timeline_path = optarg; break;
+        case 'q': dec.quiet = true; break;
+        default:
+            fprintf(stderr, "Usage: %s [-j timeline.json] [-q] [trace.bin]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (optind < argc && !(in = fopen(argv[optind], "rb"))) {
+        perror(argv[optind]);
+        return 1;
+    }
+    if (timeline_path) {
+        if (!(dec.timeline = fopen(timeline_path, "w"))) {
+            perror(timeline_path);
+            return 1;
+        }
+        fputs("{\"traceEvents\":[", dec.timeline);
+        dec.timeline_first = true;
+    }
+
+    for (;;) {
+        size_t got = fread(buffer + fill, 1, sizeof(buffer) - fill, in);
+        bool eof = got == 0;
+        size_t pos = 0;
+
+        fill += got;
+        while (pos < fill) {
+            size_t used = decode_step(&dec, buffer + pos, fill - pos);
+            if (used == 0) {
+                if (!eof) {
+                    break;
+                }
+                used = 1;           // Truncated frame at the end: text
+                text_byte(&dec, buffer[pos]);
+            }
+            pos += used;
+        }
+        memmove(buffer, buffer + pos, fill - pos);
+        fill -= pos;
+        if (eof) {
+            break;
+        }
+    }
+    flush_text(&dec);
+
+    if (dec.timeline) {
+        fputs("\n]}\n", dec.timeline);
+        fclose(dec.timeline);
+    }
+    if (in != stdin) {
+        fclose(in);
+    }
+
+    // ===== SUMMARY =====
+    printf("\n%u records, %u text bytes, %u bad checksums, %u unknown events\n",
+           dec.records, dec.text_bytes, dec.bad_checksums, dec.unknown);
+    for (int e = 1; e < TRACE_EV_COUNT; e++) {
+        if (dec.counts[e]) {
+            printf("  %-14s %u\n", events[e].name, dec.counts[e]);
+        }
+    }
+    bool lost = false;
+    for (int c = 0; c < TRACE_CORES; c++) {
+        if (dec.dropped[c] || dec.seq_gaps[c]) {
+            printf("Core %d: %u records dropped on the device, %u sequence gap(s)%s\n",
+                   c, dec.dropped[c], dec.seq_gaps[c],
+                   dec.seq_gaps[c] > dec.dropped[c] ? " (some lost in transit)" : "");
+            lost = true;
+        }
+    }
+    if (!lost) {
+        printf("No records lost\n");
+    }
+
+    return dec.bad_checksums ? 1 : 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * PicoCrypt FPV - Trace Test (host)
+ * Queued text ahead of records, held while no host is attached
+ *
+ * Replies queued with trace_printf must reach the debug channel whole and
+ * in order, ahead of any record, and only once the channel has room; with
+ * no host nothing is written and nothing blocks. Text that does not fit
+ * the queue is dropped whole, never cut.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "hal.h"
+#include "trace.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char* name) {
+    printf("%-40s %s\n", name, ok ? "OK" : "ERROR");
+    if (!ok) {
+        failures++;
+    }
+}
+
+// ===== DEBUG CHANNEL =====
+typedef struct {
+    uint8_t bytes[4 * TRACE_TEXT_SIZE];
+    uint32_t length;
+} channel_t;
+
+static void channel_sink(void* context, const uint8_t* data, uint32_t length) {
+    channel_t* channel = context;
+    if (channel->length + length <= sizeof(channel->bytes)) {
+        memcpy(channel->bytes + channel->length, data, length);
+    }
+    channel->length += length;
+}
+
+// ===== TESTS =====
+static bool test_text_first(void) {
+    static channel_t channel;
+    bool ok = true;
+
+    trace_init();
+    hal_sim_set_debug_sink(NULL, NULL);
+    ok &= trace_printf("key slot %d set\n", 2);
+    trace_event(TRACE_EV_REKEY, 100, 2);
+
+    // No host: held, and the drain returns at once
+    ok &= trace_drain() == 0;
+
+    hal_sim_set_debug_sink(channel_sink, &channel);
+    ok &= trace_drain() == 2;
+    ok &= channel.length == strlen("key slot 2 set\n") + TRACE_FRAME_SIZE;
+    ok &= memcmp(channel.bytes, "key slot 2 set\n", 15) == 0;
+    ok &= channel.bytes[15] == TRACE_SYNC0 && channel.bytes[16] == TRACE_SYNC1;
+    ok &= trace_drain() == 0;
+    hal_sim_set_debug_sink(NULL, NULL);
+    return ok;
+}
+
+static bool test_full_queue(void) {
+    static channel_t channel;
+    static char expected[2 * TRACE_TEXT_SIZE];
+    uint32_t expected_length = 0;
+    bool ok = true;
+
+    trace_init();
+    hal_sim_set_debug_sink(NULL, NULL);
+
+    // Fill to the last byte that fits; the line after is dropped whole
+    uint32_t accepted = 0, dropped = 0;
+    for (uint32_t i = 0; i < TRACE_TEXT_SIZE; i++) {
+        char line[32];
+        int length = snprintf(line, sizeof(line), "line %lu\n", (unsigned long)i);
+        if (trace_printf("%s", line)) {
+            memcpy(expected + expected_length, line, (size_t)length);
+            expected_length += (uint32_t)length;
+            accepted++;
+        } else {
+            dropped++;
+        }
+    }
+    ok &= accepted > 0 && dropped > 0 && expected_length <= TRACE_TEXT_SIZE;
+
+    // Longer than one line may be: rejected
+    char wide[TRACE_TEXT_LINE + 1];
+    memset(wide, 'x', sizeof(wide) - 1);
+    wide[sizeof(wide) - 1] = '\0';
+
+    hal_sim_set_debug_sink(channel_sink, &channel);
+    trace_drain();
+    ok &= !trace_printf("%s", wide);
+
+    // The drained queue takes more, across its wrap
+    ok &= trace_printf("after the wrap\n");
+    memcpy(expected + expected_length, "after the wrap\n", 15);
+    expected_length += 15;
+    trace_drain();
+
+    ok &= channel.length == expected_length &&
+          memcmp(channel.bytes, expected, expected_length) == 0;
+    hal_sim_set_debug_sink(NULL, NULL);
+    return ok;
+}
+
+int main(void) {
+    printf("Trace test: %d-byte text queue, %d-byte lines\n\n", TRACE_TEXT_SIZE,
+           TRACE_TEXT_LINE);
+
+    check(test_text_first(), "Text held, then written before records");
+    check(test_full_queue(), "Full queue drops whole lines");
+
+    printf("\n%s\n", failures ? "FAILED" : "All tests passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * PicoCrypt FPV - VBI Frame Code
+ */
+
+#include <string.h>
+
+#include "platform.h"
+#include "vbi_code.h"
+
+// Symbols centred in the active span
+#define CODE_START  ((VIDEO_ACTIVE_SAMPLES - VBI_CODE_BITS * VBI_CODE_SYMBOL_SAMPLES) / 2)
+// Samples sliced per symbol: the middle half, clear of the edges
+#define SLICE_FIRST (VBI_CODE_SYMBOL_SAMPLES / 4)
+#define SLICE_COUNT (VBI_CODE_SYMBOL_SAMPLES / 2)
+
+static uint8_t crc8(uint32_t value) {
+    uint8_t crc = 0;
+
+    for (int i = 31; i >= 0; i--) {
+        uint8_t bit = (uint8_t)((value >> i) & 1) ^ (crc >> 7);
+        crc = (uint8_t)(crc << 1) ^ (bit ? 0x07 : 0);
+    }
+    return crc;
+}
+
+static bool code_bit(uint32_t frame, uint32_t bit) {
+    if (bit < 16) {
+        return (VBI_CODE_SYNC_WORD >> (15 - bit)) & 1;
+    }
+    if (bit < 48) {
+        return (frame >> (47 - bit)) & 1;
+    }
+    return (crc8(frame) >> (55 - bit)) & 1;
+}
+
+void PICOCRYPT_RAM_FUNC(vbi_code_write)(uint8_t* active, uint32_t frame) {
+    memset(active, VBI_CODE_LEVEL_0, VIDEO_ACTIVE_SAMPLES);
+    for (uint32_t bit = 0; bit < VBI_CODE_BITS; bit++) {
+        if (code_bit(frame, bit)) {
+            memset(active + CODE_START + bit * VBI_CODE_SYMBOL_SAMPLES,
+                   VBI_CODE_LEVEL_1, VBI_CODE_SYMBOL_SAMPLES);
+        }
+    }
+}
+
+void PICOCRYPT_RAM_FUNC(vbi_code_reset)(vbi_code_t* code) {
+    memset(code, 0, sizeof(*code));
+}
+
+bool PICOCRYPT_RAM_FUNC(vbi_code_read)(vbi_code_t* code, const uint8_t* active) {
+    uint32_t sum[VBI_CODE_BITS];
+    uint32_t sum_0 = 0, sum_1 = 0;
+
+    for (uint32_t bit = 0; bit < VBI_CODE_BITS; bit++) {
+        const uint8_t* s = active + CODE_START + bit * VBI_CODE_SYMBOL_SAMPLES + SLICE_FIRST;
+        sum[bit] = 0;
+        for (uint32_t i = 0; i < SLICE_COUNT; i++) {
+            sum[bit] += s[i];
+        }
+    }
+
+    // Threshold halfway between the sync word's ones and zeros
+    for (uint32_t bit = 0; bit < 16; bit++) {
+        if ((VBI_CODE_SYNC_WORD >> (15 - bit)) & 1) {
+            sum_1 += sum[bit];
+        } else {
+            sum_0 += sum[bit];
+        }
+    }
+    if (sum_1 < sum_0 + 8 * SLICE_COUNT * VBI_CODE_MIN_SWING) {
+        return false;
+    }
+    uint32_t threshold = (sum_0 + sum_1) / (16 * SLICE_COUNT);
+
+    // Per symbol: majority of its samples above the threshold
+    for (uint32_t bit = 0; bit < VBI_CODE_BITS; bit++) {
+        const uint8_t* s = active + CODE_START + bit * VBI_CODE_SYMBOL_SAMPLES + SLICE_FIRST;
+        uint32_t high = 0;
+        for (uint32_t i = 0; i < SLICE_COUNT; i++) {
+            high += s[i] > threshold;
+        }
+        code->ones[bit] += high * 2 > SLICE_COUNT;
+    }
+    code->lines++;
+    return true;
+}
+
+bool PICOCRYPT_RAM_FUNC(vbi_code_decode)(const vbi_code_t* code, uint32_t* frame) {
+    uint32_t sync = 0, value = 0, crc = 0;
+
+    if (code->lines == 0) {
+        return false;
+    }
+
+    // Per bit: majority of the lines (ties read as 0)
+    for (uint32_t bit = 0; bit < VBI_CODE_BITS; bit++) {
+        uint32_t b = code->ones[bit] * 2 > code->lines;
+        if (bit < 16) {
+            sync = (sync << 1) | b;
+        } else if (bit < 48) {
+            value = (value << 1) | b;
+        } else {
+            crc = (crc << 1) | b;
+        }
+    }
+    if (sync != VBI_CODE_SYNC_WORD || crc != crc8(value)) {
+        return false;
+    }
+    *frame = value;
+    return true;
+}
@@ -0,0 +1,142 @@
+/*
+ * PicoCrypt FPV - Video Capture Engine
+ */
+
+#include "hardware/sync.h"
+
+#include "video_capture.h"
+
+#define CAPTURE_PROGRAM_LENGTH      12
+
+// ===== HELPERS =====
+
+// Captures finish in arming order; the oldest unfinished one has always
+// been triggered, so idle means done
+static void __not_in_flash_func(update)(video_capture_t* cap) {
+    while (cap->done != cap->armed && !dma_channel_is_busy(cap->dma_chan[cap->done % 2])) {
+        cap->done++;
+    }
+}
+
+// ===== PUBLIC API =====
+
+void video_capture_init(video_capture_t* cap, PIO pio, uint sm, uint data_pin,
+                        uint clock_pin, uint sync_pin, const clock_plan_t* plan,
+                        uint32_t length) {
+    uint32_t high = (plan->adc_cycles + 1) / 2;
+    uint32_t low = plan->adc_cycles - high;
+    uint16_t clk0 = pio_encode_sideset(1, 0);
+    uint16_t clk1 = pio_encode_sideset(1, 1);
+
+    // Assembled for this plan (pio_add_program copies and relocates):
+    //   0: pull block          ; armed: sample count - TAIL - 1
+    //   1: wait 1 gpio sync
+    //   2: wait 0 gpio sync    ; falling edge: line start
+    //   3: set x, LAT - 1
+    //   4: nop       side 1    ; clock out the ADC pipeline
+    //   5: jmp x--, 4
+    //   6: mov x, osr
+    //   7: in pins, 8 side 1   ; sample, autopush
+    //   8: jmp x--, 7
+    //   9: set x, TAIL - 1
+    //  10: in pins, 8          ; pad with the held output
+    //  11: jmp x--, 10
+    uint16_t instructions[CAPTURE_PROGRAM_LENGTH] = {
+        pio_encode_pull(false, true) | clk0,
+        pio_encode_wait_gpio(true, sync_pin) | clk0,
+        pio_encode_wait_gpio(false, sync_pin) | clk0,
+        pio_encode_set(pio_x, VIDEO_CAPTURE_ADC_LATENCY - 1) | clk0,
+        pio_encode_nop() | clk1 | pio_encode_delay(high - 1),
+        pio_encode_jmp_x_dec(4) | clk0 | pio_encode_delay(low - 1),
+        pio_encode_mov(pio_x, pio_osr) | clk0,
+        pio_encode_in(pio_pins, VIDEO_CAPTURE_DATA_PINS) | clk1 | pio_encode_delay(high - 1),
+        pio_encode_jmp_x_dec(7) | clk0 | pio_encode_delay(low - 1),
+        pio_encode_set(pio_x, VIDEO_CAPTURE_TAIL - 1) | clk0,
+        pio_encode_in(pio_pins, VIDEO_CAPTURE_DATA_PINS) | clk0,
+        pio_encode_jmp_x_dec(10) | clk0,
+    };
+    struct pio_program program = {
+        .instructions = instructions,
+        .length = CAPTURE_PROGRAM_LENGTH,
+        .origin = -1,
+    };
+    uint offset = pio_add_program(pio, &program);
+    pio_sm_config c = pio_get_default_sm_config();
+
+    sm_config_set_wrap(&c, offset, offset + CAPTURE_PROGRAM_LENGTH - 1);
+    sm_config_set_in_pins(&c, data_pin);
+    sm_config_set_sideset(&c, 1, false, false);
+    sm_config_set_sideset_pins(&c, clock_pin);
+    sm_config_set_in_shift(&c, false, true, VIDEO_CAPTURE_DATA_PINS);   // Autopush per sample
+    sm_config_set_clkdiv_int_frac(&c, plan->adc_div_x256 >> 8, plan->adc_div_x256 & 0xFF);
+
+    for (uint i = 0; i < VIDEO_CAPTURE_DATA_PINS; i++) {
+        pio_gpio_init(pio, data_pin + i);
+    }
+    pio_gpio_init(pio, clock_pin);
+    pio_sm_set_consecutive_pindirs(pio, sm, data_pin, VIDEO_CAPTURE_DATA_PINS, false);
+    pio_sm_set_consecutive_pindirs(pio, sm, clock_pin, 1, true);
+    pio_sm_init(pio, sm, offset, &c);
+
+    cap->pio = pio;
+    cap->sm = sm;
+    cap->length = length;
+    cap->armed = 0;
+    cap->done = 0;
+    cap->polled = 0;
+
+    // Samples from the RX FIFO (low byte: left shift) into the line.
+    // Chained to itself, i.e. not chained, until the next line is armed.
+    for (int i = 0; i < 2; i++) {
+        cap->dma_chan[i] = dma_claim_unused_channel(true);
+        dma_channel_config d = dma_channel_get_default_config(cap->dma_chan[i]);
+        channel_config_set_transfer_data_size(&d, DMA_SIZE_8);
+        channel_config_set_read_increment(&d, false);
+        channel_config_set_write_increment(&d, true);
+        channel_config_set_dreq(&d, pio_get_dreq(pio, sm, false));
+        dma_channel_configure(cap->dma_chan[i], &d, NULL, &pio->rxf[sm], length, false);
+    }
+
+    pio_sm_set_enabled(pio, sm, true);
+}
+
+bool __not_in_flash_func(video_capture_arm)(video_capture_t* cap, uint8_t* line) {
+    update(cap);
+    if (cap->armed - cap->done >= 2) {
+        return false;
+    }
+
+    uint next = cap->dma_chan[cap->armed % 2];
+    uint prev = cap->dma_chan[(cap->armed + 1) % 2];
+    bool behind = cap->armed != cap->done;
+
+    // Not chained on: its previous capture may have chained it here
+    hw_write_masked(&dma_hw->ch[next].al1_ctrl, next << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB,
+                    DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS);
+    dma_channel_set_write_addr(next, line, false);
+    dma_channel_set_trans_count(next, cap->length, false);
+
+    // Queue behind the running capture, or start now. If it ended before
+    // the chain was set, nothing triggered this one.
+    uint32_t irq = save_and_disable_interrupts();
+    if (behind) {
+        hw_write_masked(&dma_hw->ch[prev].al1_ctrl, next << DMA_CH0_CTRL_TRIG_CHAIN_TO_LSB,
+                        DMA_CH0_CTRL_TRIG_CHAIN_TO_BITS);
+    }
+    if (!dma_channel_is_busy(prev) && !dma_channel_is_busy(next)) {
+        dma_channel_start(next);
+    }
+    restore_interrupts(irq);
+
+    pio_sm_put(cap->pio, cap->sm, cap->length - VIDEO_CAPTURE_TAIL - 1);
+    cap->armed++;
+    return true;
+}
+
+uint32_t __not_in_flash_func(video_capture_poll)(video_capture_t* cap) {
+    update(cap);
+
+    uint32_t finished = cap->done - cap->polled;
+    cap->polled = cap->done;
+    return finished;
+}
@@ -0,0 +1,43 @@
+/*
+ * PicoCrypt FPV - Video Input Front End
+ */
+
+#include "platform.h"
+#include "video_input.h"
+
+void video_input_init(video_input_t* input, line_pool_t* pool, hal_video_in_t* hw,
+                      uint32_t offset, uint32_t length) {
+    input->pool = pool;
+    input->hw = hw;
+    input->offset = offset;
+    input->length = length;
+    input->finished = 0;
+}
+
+bool PICOCRYPT_RAM_FUNC(video_input_hsync)(video_input_t* input) {
+    int slot = line_pool_peek(input->pool, LINE_STAGE_CAPTURE);
+
+    if (slot < 0 || !hal_video_in_start(input->hw,
+                                         line_pool_buffer(input->pool, slot) + input->offset,
+                                         input->length)) {
+        input->pool->overruns++;
+        return false;
+    }
+    line_pool_advance_at(input->pool, LINE_STAGE_CAPTURE, hal_time_us());
+
+    return true;
+}
+
+int PICOCRYPT_RAM_FUNC(video_input_poll)(video_input_t* input) {
+    input->finished += hal_video_in_poll(input->hw);
+
+    // Captures finish in the order their slots were claimed
+    int slot = input->finished ? line_pool_peek(input->pool, LINE_STAGE_CAPTURED) : -1;
+    if (slot < 0) {
+        return -1;
+    }
+    line_pool_advance_at(input->pool, LINE_STAGE_CAPTURED, hal_time_us());
+    input->finished--;
+
+    return slot;
+}
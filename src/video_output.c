@@ -0,0 +1,216 @@
+/*
+ * PicoCrypt FPV - Video Output Engine
+ */
+
+#include "hardware/sync.h"
+
+#include "video_output.h"
+
+// Descriptors the DMA must be short of a line's first one before the
+// line is written: one store is atomic, several take longer, so leave
+// them a descriptor more. Either way submit() checks again afterwards.
+#define SET_MARGIN      (FRAME_LINE_DESCS > 1 ? 1 : 0)
+
+// ===== HELPERS =====
+
+static bool __not_in_flash_func(playing)(video_output_t* out) {
+    return dma_channel_is_busy(out->ctrl_chan) || dma_channel_is_busy(out->data_chan);
+}
+
+// Descriptors of the playing table the data channel is done with. The
+// control channel's read address is one descriptor past the one playing.
+static uint32_t __not_in_flash_func(played)(video_output_t* out) {
+    if (!playing(out)) {
+        return FRAME_TABLE_DESCS;
+    }
+
+    uint32_t base = (uint32_t)(uintptr_t)out->table.descs[out->play_field];
+    uint32_t loaded = (dma_hw->ch[out->ctrl_chan].read_addr - base) / sizeof(frame_desc_t);
+    return loaded > 0 ? loaded - 1 : 0;
+}
+
+static void __not_in_flash_func(start_field)(video_output_t* out) {
+    if (!out->start_pending || playing(out)) {
+        return;
+    }
+    out->start_pending = false;
+    out->play_field = out->field;
+    out->play_seq = out->seq;
+    dma_channel_set_read_addr(out->ctrl_chan, out->table.descs[out->field], true);
+}
+
+static bool __not_in_flash_func(entry_done)(video_output_t* out,
+                                            const video_output_entry_t* entry) {
+    if (entry->desc < 0 || entry->seq < out->play_seq) {
+        return true;
+    }
+    if (entry->seq == out->play_seq) {
+        return played(out) > (uint32_t)entry->desc + FRAME_LINE_DESCS - 1;
+    }
+    // Field never started (a later one replaced it)
+    return entry->seq != out->seq;
+}
+
+// ===== PUBLIC API =====
+
+void video_output_init(video_output_t* out, PIO pio, uint sm, uint data_pin,
+                       const clock_plan_t* plan) {
+    // One sample per instruction (pio_add_program copies):
+    //   0: out pins, 8         ; autopull; stalls on the last sample when empty
+    uint16_t instructions[] = { pio_encode_out(pio_pins, VIDEO_OUTPUT_DATA_PINS) };
+    struct pio_program program = {
+        .instructions = instructions,
+        .length = 1,
+        .origin = -1,
+    };
+    uint offset = pio_add_program(pio, &program);
+    pio_sm_config config = pio_get_default_sm_config();
+
+    sm_config_set_wrap(&config, offset, offset);
+    sm_config_set_out_pins(&config, data_pin, VIDEO_OUTPUT_DATA_PINS);
+    // Byte DMA writes repeat the sample across the FIFO word: the low byte
+    // is the sample, autopulled per sample
+    sm_config_set_out_shift(&config, true, true, VIDEO_OUTPUT_DATA_PINS);
+    sm_config_set_fifo_join(&config, PIO_FIFO_JOIN_TX);
+    sm_config_set_clkdiv_int_frac(&config, plan->pixel_div_x256 >> 8,
+                                  plan->pixel_div_x256 & 0xFF);
+
+    for (uint i = 0; i < VIDEO_OUTPUT_DATA_PINS; i++) {
+        pio_gpio_init(pio, data_pin + i);
+    }
+    pio_sm_set_consecutive_pindirs(pio, sm, data_pin, VIDEO_OUTPUT_DATA_PINS, true);
+    pio_sm_init(pio, sm, offset, &config);
+
+    out->pio = pio;
+    out->sm = sm;
+    out->field = 0;
+    out->seq = 0;
+    out->field_lines = 0;
+    out->play_field = 0;
+    out->play_seq = 0;
+    out->start_pending = false;
+    out->head = 0;
+    out->tail = 0;
+    out->late = 0;
+    frame_table_init(&out->table);
+
+    out->ctrl_chan = dma_claim_unused_channel(true);
+    out->data_chan = dma_claim_unused_channel(true);
+
+    // Data: samples into the PIO, back to the control channel when done
+    dma_channel_config d = dma_channel_get_default_config(out->data_chan);
+    channel_config_set_transfer_data_size(&d, DMA_SIZE_8);
+    channel_config_set_read_increment(&d, true);
+    channel_config_set_write_increment(&d, false);
+    channel_config_set_dreq(&d, pio_get_dreq(pio, sm, true));
+    channel_config_set_chain_to(&d, out->ctrl_chan);
+    dma_channel_configure(out->data_chan, &d, &pio->txf[sm], NULL, 0, false);
+
+    // Control: one descriptor (two words) per trigger into the data
+    // channel's alias 3; the write address wraps on those 8 bytes
+    dma_channel_config c = dma_channel_get_default_config(out->ctrl_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, 3);
+    dma_channel_configure(out->ctrl_chan, &c, &dma_hw->ch[out->data_chan].al3_transfer_count,
+                          NULL, 2, false);
+
+    pio_sm_set_enabled(pio, sm, true);
+}
+
+void __not_in_flash_func(video_output_field)(video_output_t* out) {
+    uint next = (out->field + 1) % VIDEO_FIELDS;
+
+    // Parity from the length of the field that just ended; alternate if
+    // lines were lost
+    for (uint f = 0; f < VIDEO_FIELDS && out->seq > 0; f++) {
+        if (out->field_lines == out->table.lines[f]) {
+            next = (f + 1) % VIDEO_FIELDS;
+        }
+    }
+    out->field = next;
+    out->seq++;
+    out->start_pending = false;         // Previous field never got to start
+    out->field_lines = 0;
+}
+
+// Swap the next line of the field in: `active` rotated by `cut` behind
+// `head`, or `head` whole if `active` is NULL
+static bool __not_in_flash_func(submit)(video_output_t* out, const uint8_t* head,
+                                        const uint8_t* active, uint32_t cut, uint length) {
+    if (out->head - out->tail == VIDEO_OUTPUT_INFLIGHT) {
+        return false;
+    }
+
+    uint32_t n = out->field_lines++;
+    if (n == VIDEO_OUTPUT_START_LINE && out->seq > 0) {
+        out->start_pending = true;
+    }
+    start_field(out);
+
+    int desc = length == VIDEO_LINE_SAMPLES && out->seq > 0
+        ? frame_table_line_desc(&out->table, out->field, n) : -1;
+    if (desc >= 0) {
+        // Interrupts off keep the stores short, but the control channel
+        // runs on: if it loaded past the line's first descriptor (whose
+        // count never changes) meanwhile, the line may play black or
+        // torn. Count it late; the entry still holds the buffer until
+        // the line has played and clears it after.
+        uint32_t irq = save_and_disable_interrupts();
+        bool current = out->play_seq == out->seq;
+        if (current && played(out) + SET_MARGIN >= (uint32_t)desc) {
+            out->late++;
+            desc = -1;
+        } else {
+            if (active) {
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+                frame_table_set_rotated(&out->table, out->field, desc, head, active, cut);
+#endif
+            } else {
+                frame_table_set_line(&out->table, out->field, desc, head);
+            }
+            if (current && played(out) >= (uint32_t)desc) {
+                out->late++;
+            }
+        }
+        restore_interrupts(irq);
+    }
+
+    out->inflight[out->head++ % VIDEO_OUTPUT_INFLIGHT] = (video_output_entry_t){
+        .line = active ? active : head, .seq = out->seq, .desc = (int16_t)desc,
+        .field = (uint8_t)out->field,
+    };
+    return true;
+}
+
+bool __not_in_flash_func(video_output_submit)(video_output_t* out, const uint8_t* line,
+                                              uint length) {
+    return submit(out, line, NULL, 0, length);
+}
+
+#if SCRAMBLE_MODE == SCRAMBLE_ROTATE
+bool __not_in_flash_func(video_output_submit_rotated)(video_output_t* out, const uint8_t* head,
+                                                      const uint8_t* active, uint32_t cut) {
+    return submit(out, head, active, cut, VIDEO_LINE_SAMPLES);
+}
+#endif
+
+uint __not_in_flash_func(video_output_poll)(video_output_t* out) {
+    uint retired = 0;
+
+    start_field(out);
+    while (out->tail != out->head) {
+        video_output_entry_t* entry = &out->inflight[out->tail % VIDEO_OUTPUT_INFLIGHT];
+        if (!entry_done(out, entry)) {
+            break;
+        }
+        if (entry->desc >= 0) {
+            frame_table_clear_line(&out->table, entry->field, entry->desc, entry->line);
+        }
+        out->tail++;
+        retired++;
+    }
+
+    return retired;
+}
@@ -0,0 +1,132 @@
+/*
+ * PicoCrypt FPV - Composite Video Synthesizer (host)
+ */
+
+#include <math.h>
+
+#include "video_synth.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// PAL V-switch: chroma V component and burst alternate line by line
+#define SYNTH_PHASE_ALTERNATION (VIDEO_PROFILE == VIDEO_PROFILE_PAL)
+#define SYNTH_COLOUR            (VIDEO_SUBCARRIER_HZ > 0.0)
+
+#define BURST_START_US      5.6
+#define BURST_CYCLES        10
+#define BURST_AMPLITUDE     0.15
+#define BAR_COUNT           8
+
+// 75% colour bars: white, yellow, cyan, green, magenta, red, blue, black
+static const double bar_rgb[BAR_COUNT][3] = {
+    { 0.75, 0.75, 0.75 }, { 0.75, 0.75, 0.00 }, { 0.00, 0.75, 0.75 },
+    { 0.00, 0.75, 0.00 }, { 0.75, 0.00, 0.75 }, { 0.75, 0.00, 0.00 },
+    { 0.00, 0.00, 0.75 }, { 0.00, 0.00, 0.00 },
+};
+
+// ===== HELPERS =====
+static uint32_t xorshift32(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+double video_synth_gaussian(uint32_t* rng) {
+    // Box-Muller
+    double u1 = (xorshift32(rng) + 1.0) / 4294967297.0;
+    double u2 = xorshift32(rng) / 4294967296.0;
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+// Signal (0 = blanking, 1 = white) to ADC code
+static uint8_t to_code(double level) {
+    double code = SYNTH_LEVEL_BLANK + level * (SYNTH_LEVEL_WHITE - SYNTH_LEVEL_BLANK);
+    if (code < 0.0) code = 0.0;
+    if (code > 255.0) code = 255.0;
+    return (uint8_t)lrint(code);
+}
+
+// ===== SYNTHESIS =====
+void video_synth_init(video_synth_t* synth, double noise_stddev, uint32_t seed) {
+    synth->noise_stddev = noise_stddev;
+    synth->rng = seed ? seed : 1;
+}
+
+void video_synth_line(video_synth_t* synth, uint32_t frame, uint32_t line, uint8_t* out) {
+    const double fs = VIDEO_SAMPLE_RATE_HZ;
+    const double fsc = VIDEO_SUBCARRIER_HZ;
+    double v_switch = (SYNTH_PHASE_ALTERNATION && (line & 1)) ? -1.0 : 1.0;
+    uint32_t burst_start = (uint32_t)(BURST_START_US * fs / 1e6);
+    uint32_t burst_end = SYNTH_COLOUR ? burst_start + (uint32_t)(BURST_CYCLES * fs / fsc) : 0;
+    uint32_t active_end = VIDEO_ACTIVE_START + VIDEO_ACTIVE_SAMPLES;
+    uint64_t line_start = ((uint64_t)frame * VIDEO_TOTAL_LINES + line) * VIDEO_LINE_SAMPLES;
+
+    // Subcarrier phasor, rotated one sample at a time (no sin/cos per sample)
+    double cycles = fsc * (double)line_start / fs;
+    double phase0 = 2.0 * M_PI * (cycles - floor(cycles));
+    double step = 2.0 * M_PI * fsc / fs;
+    double sin_p = sin(phase0), cos_p = cos(phase0);
+    double sin_step = sin(step), cos_step = cos(step);
+    double burst_sin = sin(v_switch * 0.75 * M_PI), burst_cos = cos(v_switch * 0.75 * M_PI);
+
+    for (uint32_t n = 0; n < VIDEO_LINE_SAMPLES; n++) {
+        double s = sin_p, c = cos_p;
+        double level = 0.0;
+
+        sin_p = s * cos_step + c * sin_step;
+        cos_p = c * cos_step - s * sin_step;
+
+        if (n < VIDEO_H_SYNC_SAMPLES) {
+            out[n] = SYNTH_LEVEL_SYNC;
+            continue;
+        }
+
+        if (n >= burst_start && n < burst_end) {
+            // sin(phase + 135 deg * v_switch) for PAL, -sin(phase) for NTSC
+            level = BURST_AMPLITUDE * (SYNTH_PHASE_ALTERNATION
+                ? s * burst_cos + c * burst_sin
+                : -s);
+        } else if (n >= VIDEO_ACTIVE_START && n < active_end) {
+            uint32_t x = n - VIDEO_ACTIVE_START;
+
+            if (line < VIDEO_ACTIVE_LINES * 2 / 3) {
+                // Colour bars (grey levels without a subcarrier)
+                const double* rgb = bar_rgb[x * BAR_COUNT / VIDEO_ACTIVE_SAMPLES];
+                double y = 0.299 * rgb[0] + 0.587 * rgb[1] + 0.114 * rgb[2];
+                double u = 0.492 * (rgb[2] - y);
+                double v = 0.877 * (rgb[0] - y);
+                level = SYNTH_COLOUR ? y + u * s + v_switch * v * c : y;
+            } else {
+                // Luma ramp scrolling 8 samples per frame
+                level = (double)((x + frame * 8) % VIDEO_ACTIVE_SAMPLES) / VIDEO_ACTIVE_SAMPLES;
+            }
+        }
+
+        if (synth->noise_stddev > 0.0) {
+            level += synth->noise_stddev * video_synth_gaussian(&synth->rng) /
+                     (SYNTH_LEVEL_WHITE - SYNTH_LEVEL_BLANK);
+        }
+        out[n] = to_code(level);
+    }
+}
+
+void video_synth_blank_line(video_synth_t* synth, uint8_t* out) {
+    for (uint32_t n = 0; n < VIDEO_LINE_SAMPLES; n++) {
+        double level = 0.0;
+
+        if (n < VIDEO_H_SYNC_SAMPLES) {
+            out[n] = SYNTH_LEVEL_SYNC;
+            continue;
+        }
+        if (synth->noise_stddev > 0.0) {
+            level += synth->noise_stddev * video_synth_gaussian(&synth->rng) /
+                     (SYNTH_LEVEL_WHITE - SYNTH_LEVEL_BLANK);
+        }
+        out[n] = to_code(level);
+    }
+}